@@ -20,6 +20,26 @@ DECLARE_GLOBAL_DATA_PTR;
 
 #if !CONFIG_IS_ENABLED(SYS_DCACHE_OFF)
 
+#if CONFIG_IS_ENABLED(MMU_EARLY)
+/* Memory map used by mmu_setup_early(), NULL to use mem_map */
+static struct mm_region *early_map __section(".data");
+
+#if !CONFIG_SPL_MMU_EARLY_TABLE_ADDR
+static u64 early_tlb[CONFIG_SPL_MMU_EARLY_TABLE_SIZE / sizeof(u64)]
+	__section(".data") __aligned(0x1000);
+#endif
+#endif
+
+/* Get the memory map which the page tables are built from */
+static struct mm_region *mmu_get_map(void)
+{
+#if CONFIG_IS_ENABLED(MMU_EARLY)
+	if (early_map)
+		return early_map;
+#endif
+	return mem_map;
+}
+
 /*
  *  With 4k page granule, a virtual address is split into 4 lookup parts
  *  spanning 9 bits each:
@@ -41,14 +61,15 @@ DECLARE_GLOBAL_DATA_PTR;
 
 u64 get_tcr(int el, u64 *pips, u64 *pva_bits)
 {
+	struct mm_region *map = mmu_get_map();
 	u64 max_addr = 0;
 	u64 ips, va_bits;
 	u64 tcr;
 	int i;
 
 	/* Find the largest address we need to support */
-	for (i = 0; mem_map[i].size || mem_map[i].attrs; i++)
-		max_addr = max(max_addr, mem_map[i].virt + mem_map[i].size);
+	for (i = 0; map[i].size || map[i].attrs; i++)
+		max_addr = max(max_addr, map[i].virt + map[i].size);
 
 	/* Calculate the maximum physical (and thus virtual) address */
 	if (max_addr > (1ULL << 44)) {
@@ -367,6 +388,7 @@ __weak u64 get_page_table_size(void)
 
 void setup_pgtables(void)
 {
+	struct mm_region *map = mmu_get_map();
 	int i;
 
 	if (!gd->arch.tlb_fillptr || !gd->arch.tlb_addr)
@@ -380,8 +402,8 @@ void setup_pgtables(void)
 	create_table();
 
 	/* Now add all MMU table entries one after another to the table */
-	for (i = 0; mem_map[i].size || mem_map[i].attrs; i++)
-		add_map(&mem_map[i]);
+	for (i = 0; map[i].size || map[i].attrs; i++)
+		add_map(&map[i]);
 }
 
 static void setup_all_pgtables(void)
@@ -395,6 +417,13 @@ static void setup_all_pgtables(void)
 	/* Create normal system page tables */
 	setup_pgtables();
 
+	/*
+	 * The early SPL tables are only changed by rebuilding them with the
+	 * MMU off, so there is no need for the emergency copy
+	 */
+	if (CONFIG_IS_ENABLED(MMU_EARLY))
+		return;
+
 	/* Create emergency page tables */
 	gd->arch.tlb_size -= (uintptr_t)gd->arch.tlb_fillptr -
 			     (uintptr_t)gd->arch.tlb_addr;
@@ -422,6 +451,28 @@ __weak void mmu_setup(void)
 	set_sctlr(get_sctlr() | CR_M);
 }
 
+#if CONFIG_IS_ENABLED(MMU_EARLY)
+void mmu_setup_early(struct mm_region *map)
+{
+	/* The tables can only be changed with the MMU off */
+	if (get_sctlr() & CR_M) {
+		dcache_disable();
+		set_sctlr(get_sctlr() & ~CR_M);
+	}
+
+	early_map = map;
+#if CONFIG_SPL_MMU_EARLY_TABLE_ADDR
+	gd->arch.tlb_addr = CONFIG_SPL_MMU_EARLY_TABLE_ADDR;
+#else
+	gd->arch.tlb_addr = (ulong)early_tlb;
+#endif
+	gd->arch.tlb_size = CONFIG_SPL_MMU_EARLY_TABLE_SIZE;
+	gd->arch.tlb_fillptr = 0;
+
+	dcache_enable();
+}
+#endif
+
 /*
  * Performs a invalidation of the entire data cache at all levels
  */
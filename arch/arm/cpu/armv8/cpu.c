@@ -14,6 +14,7 @@
 #include <command.h>
 #include <cpu_func.h>
 #include <irq_func.h>
+#include <trace.h>
 #include <asm/cache.h>
 #include <asm/system.h>
 #include <asm/secure.h>
@@ -46,6 +47,9 @@ int cleanup_before_linux(void)
 
 	board_cleanup_before_linux();
 
+	/* The OS must not inherit the profiling timer interrupt */
+	if (IS_ENABLED(CONFIG_PROFILE))
+		profile_stop();
 	disable_interrupts();
 
 	/*
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * aes-ce-glue.c - AES-CBC decryption and AES-CTR using ARMv8 Crypto
+ * Extensions
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <uboot_aes.h>
+#include <linux/linkage.h>
+#include <linux/string.h>
+
+asmlinkage void aes_ce_cbc_decrypt(u8 *out, const u8 *in, const u8 *rk,
+				   int rounds, int blocks, u8 *iv);
+asmlinkage void aes_ce_ctr_encrypt(u8 *out, const u8 *in, const u8 *rk,
+				   int rounds, int blocks, u8 *ctr);
+
+/* ID_AA64ISAR0_EL1.AES is non-zero if AESE and friends are implemented */
+static bool aes_ce_present(void)
+{
+	u64 isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return (isar0 >> 4) & 0xf;
+}
+
+/* 10, 12 or 14 rounds for 128, 192 or 256-bit keys */
+static int aes_ce_rounds(u32 key_len)
+{
+	return key_len / 4 + 6;
+}
+
+int aes_arch_cbc_decrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src,
+				u8 *dst, u32 num_aes_blocks)
+{
+	u8 chain[AES_BLOCK_LENGTH];
+
+	if (!aes_ce_present())
+		return -ENOSYS;
+
+	/* The caller's IV is left alone, as in aes_cbc_decrypt_blocks() */
+	memcpy(chain, iv, AES_BLOCK_LENGTH);
+	aes_ce_cbc_decrypt(dst, src, key_exp, aes_ce_rounds(key_len),
+			   num_aes_blocks, chain);
+
+	return 0;
+}
+
+int aes_arch_ctr_crypt_blocks(u32 key_len, u8 *key_exp, u8 *ctr, u8 *src,
+			      u8 *dst, u32 num_aes_blocks)
+{
+	if (!aes_ce_present())
+		return -ENOSYS;
+
+	aes_ce_ctr_encrypt(dst, src, key_exp, aes_ce_rounds(key_len),
+			   num_aes_blocks, ctr);
+
+	return 0;
+}
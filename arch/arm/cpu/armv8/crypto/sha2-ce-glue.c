@@ -6,9 +6,11 @@
  * Copyright 2022 NXP
  */
 
+#include <errno.h>
 #include <linux/kernel.h>
 #include <linux/linkage.h>
 #include <crypto/sha256_base.h>
+#include <u-boot/sha256.h>
 
 struct sha256_ce_state {
 	struct sha256_state	sst;
@@ -53,6 +55,31 @@ static void sha256_ce_final(struct sha256_ce_state *sctx, u8 *out)
 	sha256_base_finish(&sctx->sst, out);
 }
 
+/* ID_AA64ISAR0_EL1.SHA2 is non-zero if SHA256H and friends are implemented */
+static bool sha256_ce_present(void)
+{
+	u64 isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return (isar0 >> 12) & 0xf;
+}
+
+int sha256_arch_blocks(uint32_t *state, const uint8_t *src, int blocks)
+{
+	struct sha256_ce_state sctx;
+
+	if (!sha256_ce_present())
+		return -ENOSYS;
+
+	memcpy(sctx.sst.state, state, sizeof(sctx.sst.state));
+	sctx.finalize = 0;
+	__sha2_ce_transform(&sctx.sst, src, blocks);
+	memcpy(state, sctx.sst.state, sizeof(sctx.sst.state));
+
+	return 0;
+}
+
 /*
  * Output = SHA-256( input buffer ).
  */
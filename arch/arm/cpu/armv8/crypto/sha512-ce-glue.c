@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * sha512-ce-glue.c - SHA-384/SHA-512 using ARMv8.2 Crypto Extensions
+ *
+ * Copyright (C) 2018 Linaro Ltd <ard.biesheuvel@linaro.org>
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <linux/linkage.h>
+#include <u-boot/sha512.h>
+
+asmlinkage void sha512_ce_transform(uint64_t *state, const uint8_t *src,
+				    int blocks);
+
+/* ID_AA64ISAR0_EL1.SHA2 is 2 if SHA512H and friends are implemented */
+static bool sha512_ce_present(void)
+{
+	u64 isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return ((isar0 >> 12) & 0xf) >= 2;
+}
+
+int sha512_arch_blocks(uint64_t *state, const uint8_t *src, int blocks)
+{
+	if (!sha512_ce_present())
+		return -ENOSYS;
+	sha512_ce_transform(state, src, blocks);
+
+	return 0;
+}
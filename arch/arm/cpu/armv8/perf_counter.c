@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Performance counters using the ARMv8 Performance Monitors Unit (PMU)
+ *
+ * The cycle counter provides PERF_COUNTER_CYCLES and the first event counters
+ * are programmed with the other common architectural events. Counters which
+ * the PMU does not have are reported as not available.
+ */
+
+#include <common.h>
+#include <perf_counter.h>
+#include <asm/system.h>
+#include <linux/bitops.h>
+
+/* PMCR_EL0 bits */
+#define PMCR_E			BIT(0)	/* enable */
+#define PMCR_P			BIT(1)	/* reset event counters */
+#define PMCR_C			BIT(2)	/* reset cycle counter */
+#define PMCR_LC			BIT(6)	/* 64-bit cycle counter */
+#define PMCR_N_SHIFT		11
+#define PMCR_N_MASK		0x1f
+
+/* Filter bit for PMEVTYPER<n>_EL0 and PMCCFILTR_EL0 to count at EL2 */
+#define PMEVTYPER_NSH		BIT(27)
+
+#define PMCNTEN_CYCLES		BIT(31)
+
+/* Common architectural event numbers, indexed by enum perf_counter_id */
+static const u16 pmu_events[PERF_COUNTER_COUNT] = {
+	[PERF_COUNTER_INSTRUCTIONS]	= 0x08,	/* INST_RETIRED */
+	[PERF_COUNTER_L1D_MISSES]	= 0x03,	/* L1D_CACHE_REFILL */
+	[PERF_COUNTER_L2D_MISSES]	= 0x17,	/* L2D_CACHE_REFILL */
+	[PERF_COUNTER_BRANCH_MISSES]	= 0x10,	/* BR_MIS_PRED */
+};
+
+/*
+ * Event counters are given to the perf counters in order, so the one used for
+ * each can be worked out from the number the PMU has. This avoids keeping
+ * state in .bss, which cannot be written before relocation.
+ */
+static int pmu_num_counters(void)
+{
+	ulong pmcr;
+
+	asm volatile("mrs %0, pmcr_el0" : "=r" (pmcr));
+
+	return (pmcr >> PMCR_N_SHIFT) & PMCR_N_MASK;
+}
+
+/* Event counter used for perf counter @id, or -1 if none */
+static int pmu_counter(int id, int num_counters)
+{
+	int counter = id - (PERF_COUNTER_CYCLES + 1);
+
+	return counter < num_counters ? counter : -1;
+}
+
+static void pmu_select(int counter)
+{
+	asm volatile("msr pmselr_el0, %0" : : "r" ((ulong)counter));
+	isb();
+}
+
+int arch_perf_counter_start(struct perf_counter_info *info)
+{
+	ulong pmcr, filter, enable = PMCNTEN_CYCLES;
+	int num_counters = pmu_num_counters();
+	int counter;
+	int i;
+
+	asm volatile("mrs %0, pmcr_el0" : "=r" (pmcr));
+	filter = current_el() == 2 ? PMEVTYPER_NSH : 0;
+
+	info->valid = BIT(PERF_COUNTER_CYCLES);
+	info->mask[PERF_COUNTER_CYCLES] = ~0ULL;
+	asm volatile("msr pmccfiltr_el0, %0" : : "r" (filter));
+
+	for (i = PERF_COUNTER_CYCLES + 1; i < PERF_COUNTER_COUNT; i++) {
+		counter = pmu_counter(i, num_counters);
+		if (counter < 0)
+			continue;
+		pmu_select(counter);
+		asm volatile("msr pmxevtyper_el0, %0"
+			     : : "r" (filter | pmu_events[i]));
+		enable |= BIT(counter);
+		info->valid |= BIT(i);
+		info->mask[i] = 0xffffffff;
+	}
+
+	asm volatile("msr pmcntenset_el0, %0" : : "r" (enable));
+	asm volatile("msr pmcr_el0, %0"
+		     : : "r" (pmcr | PMCR_E | PMCR_P | PMCR_C | PMCR_LC));
+	isb();
+
+	return 0;
+}
+
+void arch_perf_counter_stop(void)
+{
+	ulong pmcr;
+
+	asm volatile("mrs %0, pmcr_el0" : "=r" (pmcr));
+	asm volatile("msr pmcr_el0, %0" : : "r" (pmcr & ~PMCR_E));
+	asm volatile("msr pmcntenclr_el0, %0" : : "r" (~0UL));
+	isb();
+}
+
+void arch_perf_counter_read(u64 val[PERF_COUNTER_COUNT])
+{
+	int num_counters = pmu_num_counters();
+	ulong count;
+	int counter;
+	int i;
+
+	asm volatile("mrs %0, pmccntr_el0" : "=r" (count));
+	val[PERF_COUNTER_CYCLES] = count;
+	for (i = PERF_COUNTER_CYCLES + 1; i < PERF_COUNTER_COUNT; i++) {
+		counter = pmu_counter(i, num_counters);
+		if (counter < 0)
+			continue;
+		pmu_select(counter);
+		asm volatile("mrs %0, pmxevcntr_el0" : "=r" (count));
+		val[i] = count;
+	}
+}
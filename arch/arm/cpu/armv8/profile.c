@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Profiling timer using the ARMv8 generic timer
+ *
+ * The EL1 physical timer (or the EL2 physical timer when running at EL2)
+ * raises a PPI through the GIC on each sampling period. The interrupt handler
+ * records a sample and rearms the timer.
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <trace.h>
+#include <asm/gic.h>
+#include <asm/io.h>
+#include <asm/ptrace.h>
+#include <asm/system.h>
+#include <linux/bitops.h>
+#include <linux/sizes.h>
+#include <linux/stringify.h>
+
+/* Timer PPIs recommended by the Server Base System Architecture */
+#define TIMER_PPI_EL1		30
+#define TIMER_PPI_EL2		26
+
+#define TIMER_CTL_ENABLE	BIT(0)
+
+#define GIC_SPURIOUS		1023
+#define GIC_PRIORITY		0xa0
+
+#if defined(CONFIG_GICV3) && defined(GICR_BASE)
+#define PROFILE_GICV3
+#elif defined(CONFIG_GICV2) && defined(GICD_BASE) && defined(GICC_BASE)
+#define PROFILE_GICV2
+#endif
+
+#if defined(PROFILE_GICV3) || defined(PROFILE_GICV2)
+static ulong profile_ticks;
+static uint profile_ppi;
+
+static void timer_set(ulong ctl, ulong tval)
+{
+	if (current_el() == 2) {
+		asm volatile("msr cnthp_tval_el2, %0" : : "r" (tval));
+		asm volatile("msr cnthp_ctl_el2, %0" : : "r" (ctl));
+	} else {
+		asm volatile("msr cntp_tval_el0, %0" : : "r" (tval));
+		asm volatile("msr cntp_ctl_el0, %0" : : "r" (ctl));
+	}
+	isb();
+}
+
+#if defined(PROFILE_GICV3)
+static void gic_enable_ppi(uint irq)
+{
+	/* SGIs and PPIs are in the second frame of the redistributor */
+	void __iomem *sgi = (void __iomem *)(GICR_BASE + SZ_64K);
+
+	writeb(GIC_PRIORITY, sgi + GICR_IPRIORITYRn + irq);
+	setbits_le32(sgi + GICR_IGROUPRn, BIT(irq));
+	writel(BIT(irq), sgi + GICR_ISENABLERn);
+	asm volatile("msr " __stringify(ICC_PMR_EL1) ", %0" : : "r" (0xffUL));
+	asm volatile("msr " __stringify(ICC_IGRPEN1_EL1) ", %0" : : "r" (1UL));
+	isb();
+}
+
+static void gic_disable_ppi(uint irq)
+{
+	void __iomem *sgi = (void __iomem *)(GICR_BASE + SZ_64K);
+
+	writel(BIT(irq), sgi + GICR_ICENABLERn);
+}
+
+static uint gic_ack(void)
+{
+	ulong irq;
+
+	asm volatile("mrs %0, " __stringify(ICC_IAR1_EL1) : "=r" (irq));
+
+	return irq & 0xffffff;
+}
+
+static void gic_eoi(uint irq)
+{
+	asm volatile("msr " __stringify(ICC_EOIR1_EL1) ", %0"
+		     : : "r" ((ulong)irq));
+	isb();
+}
+#elif defined(PROFILE_GICV2)
+static void gic_enable_ppi(uint irq)
+{
+	writeb(GIC_PRIORITY, GICD_BASE + GICD_IPRIORITYRn + irq);
+	writel(BIT(irq), GICD_BASE + GICD_ISENABLERn);
+	writel(0xff, GICC_BASE + GICC_PMR);
+	setbits_le32(GICC_BASE + GICC_CTLR, BIT(0));
+}
+
+static void gic_disable_ppi(uint irq)
+{
+	writel(BIT(irq), GICD_BASE + GICD_ICENABLERn);
+}
+
+static uint gic_ack(void)
+{
+	return readl(GICC_BASE + GICC_IAR) & 0x3ff;
+}
+
+static void gic_eoi(uint irq)
+{
+	writel(irq, GICC_BASE + GICC_EOIR);
+}
+#endif
+#endif
+
+int arch_profile_start(uint period_us)
+{
+#if defined(PROFILE_GICV3) || defined(PROFILE_GICV2)
+	ulong freq;
+
+	asm volatile("mrs %0, cntfrq_el0" : "=r" (freq));
+	profile_ticks = max(1UL, (ulong)((u64)freq * period_us / 1000000));
+	profile_ppi = current_el() == 2 ? TIMER_PPI_EL2 : TIMER_PPI_EL1;
+	gic_enable_ppi(profile_ppi);
+	timer_set(TIMER_CTL_ENABLE, profile_ticks);
+	asm volatile("msr daifclr, #2");
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+void arch_profile_stop(void)
+{
+#if defined(PROFILE_GICV3) || defined(PROFILE_GICV2)
+	asm volatile("msr daifset, #2");
+	timer_set(0, 0);
+	gic_disable_ppi(profile_ppi);
+#endif
+}
+
+int armv8_profile_irq(struct pt_regs *regs)
+{
+#if defined(PROFILE_GICV3) || defined(PROFILE_GICV2)
+	uint irq = gic_ack();
+
+	if (irq == GIC_SPURIOUS)
+		return 0;
+	if (irq != profile_ppi) {
+		gic_eoi(irq);
+		return -ENOENT;
+	}
+	timer_set(TIMER_CTL_ENABLE, profile_ticks);
+	profile_sample(regs->elr, regs->regs[29], (ulong)(regs + 1));
+	gic_eoi(irq);
+
+	return 0;
+#else
+	return -ENOENT;
+#endif
+}
@@ -268,6 +268,14 @@ void smp_kick_all_cpus(void);
 void flush_l3_cache(void);
 void mmu_change_region_attr(phys_addr_t start, size_t size, u64 attrs);
 
+/**
+ * armv8_profile_irq() - handle the profiling timer interrupt
+ *
+ * @regs: registers of the interrupted code
+ * Return: 0 if the interrupt was handled, -ENOENT if it was not for us
+ */
+int armv8_profile_irq(struct pt_regs *regs);
+
 /*
  * smc_call() - issue a secure monitor call
  *
@@ -651,6 +659,14 @@ void mmu_set_region_dcache_behaviour(phys_addr_t start, size_t size,
 int noncached_init(void);
 
 phys_addr_t noncached_alloc(size_t size, size_t align);
+
+/**
+ * noncached_contains() - Check if an address is in the non-cached region
+ *
+ * @addr:	address to check
+ * Return: true if @addr lies within the region set up by noncached_init()
+ */
+bool noncached_contains(ulong addr);
 #endif /* CONFIG_SYS_NONCACHED_MEMORY */
 
 #endif /* __ASSEMBLY__ */
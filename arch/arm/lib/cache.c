@@ -120,6 +120,11 @@ phys_addr_t noncached_alloc(size_t size, size_t align)
 
 	return next;
 }
+
+bool noncached_contains(ulong addr)
+{
+	return addr >= noncached_start && addr < noncached_end;
+}
 #endif /* CONFIG_SYS_NONCACHED_MEMORY */
 
 #if CONFIG_IS_ENABLED(SYS_THUMB_BUILD)
@@ -7,6 +7,7 @@
 #include <common.h>
 #include <asm/global_data.h>
 #include <asm/ptrace.h>
+#include <asm/system.h>
 #include <irq_func.h>
 #include <linux/compiler.h>
 #include <efi_loader.h>
@@ -129,6 +130,8 @@ void do_sync(struct pt_regs *pt_regs, unsigned int esr)
 void do_irq(struct pt_regs *pt_regs, unsigned int esr)
 {
 	efi_restore_gd();
+	if (IS_ENABLED(CONFIG_PROFILE) && !armv8_profile_irq(pt_regs))
+		return;
 	printf("\"Irq\" handler, esr 0x%08x\n", esr);
 	show_regs(pt_regs);
 	show_efi_loaded_images(pt_regs);
@@ -195,6 +195,21 @@ static unsigned int imx8m_find_dram_entry_in_mem_map(void)
 	hang();	/* Entry not found, this must never happen. */
 }
 
+#if CONFIG_IS_ENABLED(MMU_EARLY)
+/* Memory map for SPL before DRAM is set up: everything up to the DRAM */
+static struct mm_region imx8m_early_mem_map[ARRAY_SIZE(imx8m_mem_map)]
+	__section(".data");
+
+static void imx8m_mmu_early_init(void)
+{
+	int entry = imx8m_find_dram_entry_in_mem_map();
+
+	memcpy(imx8m_early_mem_map, imx8m_mem_map,
+	       entry * sizeof(struct mm_region));
+	mmu_setup_early(imx8m_early_mem_map);
+}
+#endif
+
 void enable_caches(void)
 {
 	/* If OPTEE runs, remove OPTEE memory from MMU table to avoid speculative prefetch
@@ -597,6 +612,11 @@ int arch_cpu_init(void)
 		clock_init();
 		imx_set_wdog_powerdown(false);
 
+#if CONFIG_IS_ENABLED(MMU_EARLY)
+		/* Run DDR training and the rest of SPL with the caches on */
+		imx8m_mmu_early_init();
+#endif
+
 #if defined(CONFIG_IMX_HAB) && defined(CONFIG_IMX8MQ)
 		secure_lockup();
 #endif
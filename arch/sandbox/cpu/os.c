@@ -19,11 +19,14 @@
 #include <time.h>
 #include <ucontext.h>
 #include <unistd.h>
+#include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <linux/compiler_attributes.h>
+#include <linux/perf_event.h>
 #include <linux/types.h>
 
 #include <asm/getopt.h>
@@ -283,6 +286,120 @@ int os_setup_signal_handlers(void)
 	return 0;
 }
 
+static void os_profile_handler(int sig, siginfo_t *info, void *con)
+{
+	ucontext_t __maybe_unused *context = con;
+	unsigned long pc, fp, sp;
+
+#if defined(__x86_64__)
+	pc = context->uc_mcontext.gregs[REG_RIP];
+	fp = context->uc_mcontext.gregs[REG_RBP];
+	sp = context->uc_mcontext.gregs[REG_RSP];
+#elif defined(__aarch64__)
+	pc = context->uc_mcontext.pc;
+	fp = context->uc_mcontext.regs[29];
+	sp = context->uc_mcontext.sp;
+#elif defined(__riscv)
+	/* The frame record is below the frame pointer, so only take the PC */
+	pc = context->uc_mcontext.__gregs[REG_PC];
+	fp = 0;
+	sp = context->uc_mcontext.__gregs[REG_SP];
+#else
+	return;
+#endif
+
+	os_profile_action(pc, fp, sp);
+}
+
+int os_profile_timer(unsigned int period_us)
+{
+	struct itimerval timer;
+	struct sigaction act;
+
+	if (period_us) {
+		act.sa_sigaction = os_profile_handler;
+		sigemptyset(&act.sa_mask);
+		act.sa_flags = SA_SIGINFO | SA_RESTART;
+		if (sigaction(SIGPROF, &act, NULL))
+			return -1;
+	}
+	timer.it_interval.tv_sec = period_us / 1000000;
+	timer.it_interval.tv_usec = period_us % 1000000;
+	timer.it_value = timer.it_interval;
+
+	return setitimer(ITIMER_PROF, &timer, NULL) ? -1 : 0;
+}
+
+/* Host counters, in the order of enum perf_counter_id */
+#define OS_PERF_COUNT	5
+
+static const struct {
+	unsigned int type;
+	unsigned long long config;
+} os_perf_events[OS_PERF_COUNT] = {
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+	{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+		PERF_COUNT_HW_CACHE_OP_READ << 8 |
+		PERF_COUNT_HW_CACHE_RESULT_MISS << 16 },
+	{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+		PERF_COUNT_HW_CACHE_OP_READ << 8 |
+		PERF_COUNT_HW_CACHE_RESULT_MISS << 16 },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+static int os_perf_fds[OS_PERF_COUNT] = { -1, -1, -1, -1, -1 };
+
+unsigned int os_perf_counter_open(void)
+{
+	struct perf_event_attr attr;
+	unsigned int valid = 0;
+	int i;
+
+	for (i = 0; i < OS_PERF_COUNT; i++) {
+		if (os_perf_fds[i] == -1) {
+			memset(&attr, '\0', sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = os_perf_events[i].type;
+			attr.config = os_perf_events[i].config;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			os_perf_fds[i] = syscall(__NR_perf_event_open, &attr, 0,
+						 -1, -1, 0);
+		}
+		if (os_perf_fds[i] != -1)
+			valid |= 1U << i;
+	}
+
+	return valid;
+}
+
+void os_perf_counter_read(unsigned long long *val, int count)
+{
+	int i;
+
+	for (i = 0; i < count && i < OS_PERF_COUNT; i++) {
+		unsigned long long value;
+
+		if (os_perf_fds[i] != -1 &&
+		    read(os_perf_fds[i], &value, sizeof(value)) ==
+		    sizeof(value))
+			val[i] = value;
+	}
+}
+
+void os_perf_counter_close(void)
+{
+	int i;
+
+	for (i = 0; i < OS_PERF_COUNT; i++) {
+		if (os_perf_fds[i] != -1) {
+			close(os_perf_fds[i]);
+			os_perf_fds[i] = -1;
+		}
+	}
+}
+
 /* Put tty into raw mode so <tab> and <ctrl+c> work */
 void os_tty_raw(int fd, bool allow_sigs)
 {
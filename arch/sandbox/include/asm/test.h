@@ -303,4 +303,18 @@ int sandbox_cros_ec_get_pwm_duty(struct udevice *dev, uint index, uint *duty);
  */
 int sandbox_sdl_set_bpp(struct udevice *dev, enum video_log2_bpp l2bpp);
 
+/**
+ * sandbox_perf_counter_stub() - Use fixed performance-counter values
+ *
+ * The host's counters cannot be relied upon in tests, since they depend on
+ * the machine and are often not permitted. This makes every counter
+ * available and reads them from @val instead, with 32-bit event counters as
+ * on ARMv8. It takes effect when the counters are next started, so call
+ * perf_counter_stop() first.
+ *
+ * @val: Values to read, indexed by enum perf_counter_id, or NULL to use the
+ *	host's counters again
+ */
+void sandbox_perf_counter_stub(const u64 *val);
+
 #endif
@@ -7,8 +7,10 @@
 
 #include <common.h>
 #include <efi_loader.h>
+#include <errno.h>
 #include <irq_func.h>
 #include <os.h>
+#include <trace.h>
 #include <asm/global_data.h>
 #include <asm-generic/signal.h>
 #include <asm/u-boot-sandbox.h>
@@ -29,6 +31,22 @@ int disable_interrupts(void)
 	return 0;
 }
 
+int arch_profile_start(uint period_us)
+{
+	return os_profile_timer(period_us) ? -EPERM : 0;
+}
+
+void arch_profile_stop(void)
+{
+	os_profile_timer(0);
+}
+
+void os_profile_action(unsigned long pc, unsigned long fp, unsigned long sp)
+{
+	if (IS_ENABLED(CONFIG_PROFILE))
+		profile_sample(pc, fp, sp);
+}
+
 void os_signal_action(int sig, unsigned long pc)
 {
 	efi_restore_gd();
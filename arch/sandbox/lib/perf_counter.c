@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Performance counters for sandbox, using the host's counters
+ */
+
+#include <common.h>
+#include <os.h>
+#include <perf_counter.h>
+#include <asm/test.h>
+#include <linux/bitops.h>
+
+/* Values to read in place of the host's counters, for tests */
+static const u64 *perf_stub;
+
+void sandbox_perf_counter_stub(const u64 *val)
+{
+	perf_stub = val;
+}
+
+int arch_perf_counter_start(struct perf_counter_info *info)
+{
+	int i;
+
+	if (perf_stub) {
+		info->valid = BIT(PERF_COUNTER_COUNT) - 1;
+		info->mask[PERF_COUNTER_CYCLES] = ~0ULL;
+		for (i = PERF_COUNTER_CYCLES + 1; i < PERF_COUNTER_COUNT; i++)
+			info->mask[i] = 0xffffffff;
+
+		return 0;
+	}
+	info->valid = os_perf_counter_open();
+	for (i = 0; i < PERF_COUNTER_COUNT; i++)
+		info->mask[i] = ~0ULL;
+
+	return 0;
+}
+
+void arch_perf_counter_stop(void)
+{
+	os_perf_counter_close();
+}
+
+void arch_perf_counter_read(u64 val[PERF_COUNTER_COUNT])
+{
+	if (perf_stub)
+		memcpy(val, perf_stub, PERF_COUNTER_COUNT * sizeof(u64));
+	else
+		os_perf_counter_read((unsigned long long *)val,
+				     PERF_COUNTER_COUNT);
+}
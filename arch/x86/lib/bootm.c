@@ -12,6 +12,7 @@
 #include <command.h>
 #include <hang.h>
 #include <log.h>
+#include <serial.h>
 #include <asm/global_data.h>
 #include <dm/device.h>
 #include <dm/root.h>
@@ -34,6 +35,7 @@ DECLARE_GLOBAL_DATA_PTR;
 void bootm_announce_and_cleanup(void)
 {
 	printf("\nStarting kernel ...\n\n");
+	serial_flush();
 
 #ifdef CONFIG_SYS_COREBOOT
 	timestamp_add_now(TS_START_KERNEL);
@@ -18,6 +18,7 @@
 #include <linux/libfdt.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <serial.h>
 #include <vxworks.h>
 #include <tee/optee.h>
 
@@ -592,6 +593,8 @@ int boot_selected_os(int argc, char *const argv[], int state,
 {
 	arch_preboot_os();
 	board_preboot_os();
+	/* The OS may take over the console without draining it */
+	serial_flush();
 	boot_fn(state, argc, argv, images);
 
 	/* Stand-alone may return when 'autostart' is 'no' */
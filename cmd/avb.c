@@ -261,6 +261,7 @@ int do_avb_verify_part(struct cmd_tbl *cmdtp, int flag,
 		return CMD_RET_FAILURE;
 	}
 
+	avb_ops_reset_preload(avb_ops);
 	slot_result =
 		avb_slot_verify(avb_ops,
 				requested_partitions,
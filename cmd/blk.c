@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Show statistics for block devices
+ */
+
+#include <common.h>
+#include <blk.h>
+#include <command.h>
+#include <dm.h>
+#include <io_stats.h>
+
+static int do_blk_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			char *const argv[])
+{
+	bool verbose = false, clear = false;
+	const char *name = NULL;
+	struct udevice *dev;
+	struct uclass *uc;
+	bool found = false;
+	int ret;
+
+	for (argc--, argv++; argc; argc--, argv++) {
+		if (*argv[0] != '-') {
+			name = argv[0];
+			continue;
+		}
+		if (strchr(argv[0], 'v'))
+			verbose = true;
+		if (strchr(argv[0], 'c'))
+			clear = true;
+	}
+
+	ret = uclass_get(UCLASS_BLK, &uc);
+	if (ret)
+		return CMD_RET_FAILURE;
+	uclass_foreach_dev(dev, uc) {
+		struct blk_desc *desc = dev_get_uclass_plat(dev);
+
+		if (name && strcmp(name, dev->name))
+			continue;
+		found = true;
+		if (!io_stats_active(&desc->stats)) {
+			if (name)
+				printf("%s: no requests\n", dev->name);
+			continue;
+		}
+		printf("%s:\n", dev->name);
+		io_stats_print(&desc->stats, verbose);
+		if (clear)
+			io_stats_clear(&desc->stats);
+	}
+	if (name && !found) {
+		printf("Block device '%s' not found\n", name);
+		return CMD_RET_FAILURE;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_SYS_LONGHELP
+static char blk_help_text[] =
+	"stats [-cv] [<dev>] - show statistics for block devices\n"
+	"   -c: clear the statistics after showing them\n"
+	"   -v: show histograms of request sizes and latencies";
+#endif
+
+U_BOOT_CMD_WITH_SUBCMDS(blk, "block-device statistics", blk_help_text,
+	U_BOOT_SUBCMD_MKENT(stats, 4, 0, do_blk_stats));
@@ -22,6 +22,7 @@
 #include <video.h>
 #include <video_link.h>
 #include <asm/byteorder.h>
+#include <asm/unaligned.h>
 
 static int bmp_info (ulong addr);
 
@@ -246,7 +247,9 @@ int bmp_display(ulong addr, int x, int y)
 	unsigned long len;
 
 	if (!((bmp->header.signature[0]=='B') &&
-	      (bmp->header.signature[1]=='M')))
+	      (bmp->header.signature[1]=='M')) &&
+	    !(IS_ENABLED(CONFIG_VIDEO_RAW_IMAGE) &&
+	      get_unaligned_le32(bmp) == VIDEO_RAW_MAGIC))
 		bmp = gunzip_bmp(addr, &len, &bmp_alloc_addr);
 
 	if (!bmp) {
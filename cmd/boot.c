@@ -10,6 +10,7 @@
 #include <common.h>
 #include <command.h>
 #include <net.h>
+#include <serial.h>
 
 #ifdef CONFIG_CMD_GO
 
@@ -32,6 +33,7 @@ static int do_go(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 	addr = hextoul(argv[1], NULL);
 
 	printf ("## Starting application at 0x%08lX ...\n", addr);
+	serial_flush();
 
 	/*
 	 * pass address parameter as argv[0] (aka command name),
@@ -11,15 +11,61 @@
 
 #include <common.h>
 #include <command.h>
+#include <div64.h>
 #include <hash.h>
+#include <mapmem.h>
+#include <time.h>
 #include <linux/ctype.h>
 
+/* Hash the region repeatedly for at least this long to get a stable figure */
+#define HASH_BENCH_US	1000000
+
+static int do_hash_bench(int argc, char *const argv[])
+{
+	u8 output[HASH_MAX_DIGEST_SIZE];
+	struct hash_algo *algo;
+	ulong addr, len, start, elapsed;
+	uint count = 0, frac;
+	u64 rate;
+	void *buf;
+
+	if (argc < 4)
+		return CMD_RET_USAGE;
+	if (hash_lookup_algo(argv[1], &algo)) {
+		printf("Unknown hash algorithm '%s'\n", argv[1]);
+		return CMD_RET_FAILURE;
+	}
+	addr = hextoul(argv[2], NULL);
+	len = hextoul(argv[3], NULL);
+	if (!len)
+		return CMD_RET_USAGE;
+
+	buf = map_sysmem(addr, len);
+	start = timer_get_us();
+	do {
+		algo->hash_func_ws(buf, len, output, algo->chunk_size);
+		count++;
+		elapsed = timer_get_us() - start;
+	} while (elapsed < HASH_BENCH_US);
+	unmap_sysmem(buf);
+
+	/* bytes per microsecond is MB/s; keep two decimal places */
+	rate = lldiv((u64)count * len * 100, elapsed);
+	frac = do_div(rate, 100);
+	printf("%s: %u x %lu bytes in %lu us, %llu.%02u MB/s\n", algo->name,
+	       count, len, elapsed, rate, frac);
+
+	return 0;
+}
+
 static int do_hash(struct cmd_tbl *cmdtp, int flag, int argc,
 		   char *const argv[])
 {
 	char *s;
 	int flags = HASH_FLAG_ENV;
 
+	if (argc > 1 && !strcmp(argv[1], "bench"))
+		return do_hash_bench(argc - 1, argv + 1);
 #ifdef CONFIG_HASH_VERIFY
 	if (argc < 4)
 		return CMD_RET_USAGE;
@@ -53,4 +99,6 @@ U_BOOT_CMD(
 		"    - verify message digest of memory area to immediate value, \n"
 		"      env var or *address"
 #endif
+	"\nhash bench algorithm address len\n"
+		"    - measure the throughput of an algorithm over len (hex) bytes"
 );
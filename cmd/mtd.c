@@ -492,6 +492,50 @@ out_put_mtd:
 	return CMD_RET_SUCCESS;
 }
 
+#if CONFIG_IS_ENABLED(MTD_STATS)
+static int do_mtd_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			char *const argv[])
+{
+	bool verbose = false, clear = false;
+	const char *name = NULL;
+	struct mtd_info *mtd;
+	bool found = false;
+
+	for (argc--, argv++; argc; argc--, argv++) {
+		if (*argv[0] != '-') {
+			name = argv[0];
+			continue;
+		}
+		if (strchr(argv[0], 'v'))
+			verbose = true;
+		if (strchr(argv[0], 'c'))
+			clear = true;
+	}
+
+	mtd_probe_devices();
+	mtd_for_each_device(mtd) {
+		if (name && strcmp(name, mtd->name))
+			continue;
+		found = true;
+		if (!io_stats_active(&mtd->stats)) {
+			if (name)
+				printf("%s: no requests\n", mtd->name);
+			continue;
+		}
+		printf("%s:\n", mtd->name);
+		io_stats_print(&mtd->stats, verbose);
+		if (clear)
+			io_stats_clear(&mtd->stats);
+	}
+	if (name && !found) {
+		printf("MTD device %s not found\n", name);
+		return CMD_RET_FAILURE;
+	}
+
+	return CMD_RET_SUCCESS;
+}
+#endif
+
 #ifdef CONFIG_AUTO_COMPLETE
 static int mtd_name_complete(int argc, char *const argv[], char last_char,
 			     int maxv, char *cmdv[])
@@ -540,6 +584,11 @@ static char mtd_help_text[] =
 	"\n"
 	"Specific functions:\n"
 	"mtd bad                               <name>\n"
+#if CONFIG_IS_ENABLED(MTD_STATS)
+	"mtd stats [-cv]                       [<name>]\n"
+	"\t-c: clear the statistics after showing them\n"
+	"\t-v: show histograms of request sizes and latencies\n"
+#endif
 	"\n"
 	"With:\n"
 	"\t<name>: NAND partition/chip name (or corresponding DM device name or OF path)\n"
@@ -564,5 +613,9 @@ U_BOOT_CMD_WITH_SUBCMDS(mtd, "MTD utils", mtd_help_text,
 					     mtd_name_complete),
 		U_BOOT_SUBCMD_MKENT_COMPLETE(erase, 4, 0, do_mtd_erase,
 					     mtd_name_complete),
+#if CONFIG_IS_ENABLED(MTD_STATS)
+		U_BOOT_SUBCMD_MKENT_COMPLETE(stats, 4, 0, do_mtd_stats,
+					     mtd_name_complete),
+#endif
 		U_BOOT_SUBCMD_MKENT_COMPLETE(bad, 2, 1, do_mtd_bad,
 					     mtd_name_complete));
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Run a command and report the hardware performance counters
+ */
+
+#include <common.h>
+#include <command.h>
+#include <perf_counter.h>
+
+static int do_perf(struct cmd_tbl *cmdtp, int flag, int argc,
+		   char *const argv[])
+{
+	struct perf_counter_values start, end, delta;
+	int repeatable = 0;
+	ulong cycles = 0;
+	int retval;
+	int ret;
+
+	if (argc == 1)
+		return CMD_RET_USAGE;
+
+	ret = perf_counter_read(&start);
+	if (ret) {
+		printf("No performance counters (err=%d)\n", ret);
+		return CMD_RET_FAILURE;
+	}
+	retval = cmd_process(0, argc - 1, argv + 1, &repeatable, &cycles);
+	perf_counter_read(&end);
+	perf_counter_delta(&start, &end, &delta);
+
+	printf("\nperf: %lu ms, ", cycles * 1000 / CONFIG_SYS_HZ);
+	perf_counter_print(&delta);
+
+	return retval;
+}
+
+U_BOOT_CMD(perf, CONFIG_SYS_MAXARGS, 0, do_perf,
+	   "run a command and report hardware performance counters",
+	   "command [args...]\n"
+	   "    - shows cycles, instructions, cache and branch misses");
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Control of the sampling profiler
+ */
+
+#include <common.h>
+#include <command.h>
+#include <env.h>
+#include <mapmem.h>
+#include <trace.h>
+
+/* Default sampling period in microseconds */
+#define PROFILE_PERIOD_US	1000
+
+static int do_profile_start(struct cmd_tbl *cmdtp, int flag, int argc,
+			    char *const argv[])
+{
+	uint period_us = PROFILE_PERIOD_US;
+	int ret;
+
+	if (argc > 1)
+		period_us = dectoul(argv[1], NULL);
+	if (!period_us)
+		return CMD_RET_USAGE;
+	ret = profile_start(period_us);
+	if (ret) {
+		printf("Cannot start profiling (err=%d)\n", ret);
+		return CMD_RET_FAILURE;
+	}
+
+	return 0;
+}
+
+static int do_profile_stop(struct cmd_tbl *cmdtp, int flag, int argc,
+			   char *const argv[])
+{
+	profile_stop();
+
+	return 0;
+}
+
+static int do_profile_clear(struct cmd_tbl *cmdtp, int flag, int argc,
+			    char *const argv[])
+{
+	profile_clear();
+
+	return 0;
+}
+
+static int do_profile_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			    char *const argv[])
+{
+	profile_print_stats();
+
+	return 0;
+}
+
+static int do_profile_samples(struct cmd_tbl *cmdtp, int flag, int argc,
+			      char *const argv[])
+{
+	size_t buff_size, buff_ptr, needed;
+	char *buff;
+
+	/*
+	 * Use the buffer given, else append to the one from the last call, as
+	 * recorded in profbase, profsize and profoffset
+	 */
+	if (argc == 3) {
+		buff_size = hextoul(argv[2], NULL);
+		buff = map_sysmem(hextoul(argv[1], NULL), buff_size);
+		buff_ptr = 0;
+	} else if (argc == 1) {
+		buff_size = env_get_ulong("profsize", 16, 0);
+		buff = map_sysmem(env_get_ulong("profbase", 16, 0), buff_size);
+		buff_ptr = env_get_ulong("profoffset", 16, 0);
+	} else {
+		return CMD_RET_USAGE;
+	}
+	if (buff_ptr > buff_size)
+		buff_ptr = buff_size;
+
+	if (profile_list_samples(buff + buff_ptr, buff_size - buff_ptr,
+				 &needed)) {
+		printf("Error: buffer too small (%#zx bytes needed)\n", needed);
+		return CMD_RET_FAILURE;
+	}
+	printf("Samples dumped to %08lx, size %#zx\n",
+	       (ulong)map_to_sysmem(buff + buff_ptr), needed);
+	env_set_hex("profbase", map_to_sysmem(buff));
+	env_set_hex("profsize", buff_size);
+	env_set_hex("profoffset", buff_ptr + needed);
+
+	return 0;
+}
+
+static char profile_help_text[] =
+	"start [<period_us>] - start taking samples (default period 1000us)\n"
+	"profile stop               - stop taking samples\n"
+	"profile clear              - drop all samples\n"
+	"profile stats              - display profiling statistics\n"
+	"profile samples [<addr> <size>] - dump samples into buffer";
+
+U_BOOT_CMD_WITH_SUBCMDS(profile, "sampling profiler", profile_help_text,
+	U_BOOT_SUBCMD_MKENT(start, 2, 1, do_profile_start),
+	U_BOOT_SUBCMD_MKENT(stop, 1, 1, do_profile_stop),
+	U_BOOT_SUBCMD_MKENT(clear, 1, 1, do_profile_clear),
+	U_BOOT_SUBCMD_MKENT(stats, 1, 1, do_profile_stats),
+	U_BOOT_SUBCMD_MKENT(samples, 3, 1, do_profile_samples));
@@ -9,6 +9,7 @@
 #include <cpu_func.h>
 #include <image.h>
 #include <malloc.h>
+#include <memalign.h>
 #include <part.h>
 #include <tee.h>
 #include <tee/optee_ta_avb.h>
@@ -392,6 +393,7 @@ static AvbIOResult mmc_byte_io(AvbOps *ops,
 			       enum mmc_io_type io_type)
 {
 	ulong ret;
+	AvbIOResult io_ret = AVB_IO_RESULT_OK;
 	struct mmc_part *part;
 	u64 start_offset, start_sector, sectors, residue;
 	u8 *tmp_buf;
@@ -404,8 +406,10 @@ static AvbIOResult mmc_byte_io(AvbOps *ops,
 	if (!part)
 		return AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION;
 
-	if (!part->info.blksz)
-		return AVB_IO_RESULT_ERROR_IO;
+	if (!part->info.blksz) {
+		io_ret = AVB_IO_RESULT_ERROR_IO;
+		goto out;
+	}
 
 	start_offset = calc_offset(part, offset);
 	while (num_bytes) {
@@ -433,7 +437,8 @@ static AvbIOResult mmc_byte_io(AvbOps *ops,
 				if (ret != 1) {
 					printf("%s: read error (%ld, %lld)\n",
 					       __func__, ret, start_sector);
-					return AVB_IO_RESULT_ERROR_IO;
+					io_ret = AVB_IO_RESULT_ERROR_IO;
+					goto out;
 				}
 				/*
 				 * if this is not aligned at sector start,
@@ -450,7 +455,8 @@ static AvbIOResult mmc_byte_io(AvbOps *ops,
 				if (ret != 1) {
 					printf("%s: read error (%ld, %lld)\n",
 					       __func__, ret, start_sector);
-					return AVB_IO_RESULT_ERROR_IO;
+					io_ret = AVB_IO_RESULT_ERROR_IO;
+					goto out;
 				}
 				memcpy((void *)tmp_buf +
 					start_offset % part->info.blksz,
@@ -461,7 +467,8 @@ static AvbIOResult mmc_byte_io(AvbOps *ops,
 				if (ret != 1) {
 					printf("%s: write error (%ld, %lld)\n",
 					       __func__, ret, start_sector);
-					return AVB_IO_RESULT_ERROR_IO;
+					io_ret = AVB_IO_RESULT_ERROR_IO;
+					goto out;
 				}
 			}
 
@@ -487,7 +494,8 @@ static AvbIOResult mmc_byte_io(AvbOps *ops,
 
 			if (!ret) {
 				printf("%s: sector read error\n", __func__);
-				return AVB_IO_RESULT_ERROR_IO;
+				io_ret = AVB_IO_RESULT_ERROR_IO;
+				goto out;
 			}
 
 			io_cnt += ret * part->info.blksz;
@@ -501,7 +509,10 @@ static AvbIOResult mmc_byte_io(AvbOps *ops,
 	if (io_type == IO_READ && out_num_read)
 		*out_num_read = io_cnt;
 
-	return AVB_IO_RESULT_OK;
+out:
+	free(part);
+
+	return io_ret;
 }
 
 /**
@@ -539,6 +550,77 @@ static AvbIOResult read_from_partition(AvbOps *ops,
 			   num_bytes, buffer, out_num_read, IO_READ);
 }
 
+#ifdef CONFIG_AVB_PRELOAD
+/**
+ * get_preloaded_partition() - loads a whole partition into the preload area
+ *
+ * @ops: contains AVB ops handlers
+ * @partition: partition name, NUL-terminated UTF-8 string
+ * @num_bytes: amount of bytes to load from the start of the partition
+ * @out_pointer: returns the address of the loaded data, or NULL if it did not
+ *      fit in the preload area and must be read with read_from_partition()
+ * @out_num_bytes_preloaded: returns the amount of bytes loaded
+ *
+ * The partition is read with a single whole-block read straight to its place
+ * in the preload area, so libavb can hash it there without copying it again.
+ * The data stays valid until the next avb_ops_reset_preload() call.
+ *
+ * @return:
+ *      AVB_IO_RESULT_OK, if the partition was loaded or does not fit
+ *      AVB_IO_RESULT_ERROR_IO, if an i/o error occurred
+ *      AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION, if there is no partition with
+ *      the given name
+ */
+static AvbIOResult get_preloaded_partition(AvbOps *ops,
+					   const char *partition,
+					   size_t num_bytes,
+					   u8 **out_pointer,
+					   size_t *out_num_bytes_preloaded)
+{
+	struct AvbOpsData *data = ops->user_data;
+	ulong end = CONFIG_AVB_PRELOAD_ADDR + CONFIG_AVB_PRELOAD_SIZE;
+	AvbIOResult io_ret = AVB_IO_RESULT_OK;
+	struct mmc_part *part;
+	lbaint_t sectors;
+	ulong size;
+	void *buf;
+
+	*out_pointer = NULL;
+	*out_num_bytes_preloaded = 0;
+
+	part = get_partition(ops, partition);
+	if (!part)
+		return AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION;
+
+	if (!part->info.blksz) {
+		io_ret = AVB_IO_RESULT_ERROR_IO;
+		goto out;
+	}
+
+	sectors = DIV_ROUND_UP(num_bytes, part->info.blksz);
+	size = sectors * part->info.blksz;
+	if (sectors > part->info.size || data->preload_top + size > end)
+		goto out;
+
+	buf = map_sysmem(data->preload_top, size);
+	if (mmc_read_and_flush(part, part->info.start, sectors, buf) !=
+	    sectors) {
+		printf("%s: read error (%s)\n", __func__, partition);
+		unmap_sysmem(buf);
+		io_ret = AVB_IO_RESULT_ERROR_IO;
+		goto out;
+	}
+
+	data->preload_top = ALIGN(data->preload_top + size, ARCH_DMA_MINALIGN);
+	*out_pointer = buf;
+	*out_num_bytes_preloaded = num_bytes;
+out:
+	free(part);
+
+	return io_ret;
+}
+#endif
+
 /**
  * write_to_partition() - writes N bytes to a partition identified by a string
  * name
@@ -811,11 +893,14 @@ static AvbIOResult get_unique_guid_for_partition(AvbOps *ops,
 		return AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION;
 
 	uuid_size = sizeof(part->info.uuid);
-	if (uuid_size > guid_buf_size)
+	if (uuid_size > guid_buf_size) {
+		free(part);
 		return AVB_IO_RESULT_ERROR_IO;
+	}
 
 	memcpy(guid_buf, part->info.uuid, uuid_size);
 	guid_buf[uuid_size - 1] = 0;
+	free(part);
 
 	return AVB_IO_RESULT_OK;
 }
@@ -847,6 +932,7 @@ static AvbIOResult get_size_of_partition(AvbOps *ops,
 		return AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION;
 
 	*out_size_num_bytes = part->info.blksz * part->info.size;
+	free(part);
 
 	return AVB_IO_RESULT_OK;
 }
@@ -987,6 +1073,10 @@ AvbOps *avb_ops_alloc(int boot_device)
 	ops_data->ops.user_data = ops_data;
 
 	ops_data->ops.read_from_partition = read_from_partition;
+#ifdef CONFIG_AVB_PRELOAD
+	ops_data->ops.get_preloaded_partition = get_preloaded_partition;
+#endif
+	avb_ops_reset_preload(&ops_data->ops);
 	ops_data->ops.write_to_partition = write_to_partition;
 	ops_data->ops.validate_vbmeta_public_key = validate_vbmeta_public_key;
 	ops_data->ops.read_rollback_index = read_rollback_index;
@@ -1004,6 +1094,15 @@ AvbOps *avb_ops_alloc(int boot_device)
 	return &ops_data->ops;
 }
 
+void avb_ops_reset_preload(AvbOps *ops)
+{
+#ifdef CONFIG_AVB_PRELOAD
+	struct AvbOpsData *data = ops->user_data;
+
+	data->preload_top = ALIGN(CONFIG_AVB_PRELOAD_ADDR, ARCH_DMA_MINALIGN);
+#endif
+}
+
 void avb_ops_free(AvbOps *ops)
 {
 	struct AvbOpsData *ops_data;
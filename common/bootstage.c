@@ -12,20 +12,26 @@
 #define LOG_CATEGORY	LOGC_BOOT
 
 #include <common.h>
+#include <blk.h>
 #include <bootstage.h>
 #include <hang.h>
 #include <log.h>
 #include <malloc.h>
+#include <perf_counter.h>
 #include <sort.h>
 #include <spl.h>
 #include <asm/global_data.h>
 #include <linux/compiler.h>
 #include <linux/libfdt.h>
+#include <linux/log2.h>
+#include <linux/mtd/mtd.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
 enum {
 	RECORD_COUNT = CONFIG_VAL(BOOTSTAGE_RECORD_COUNT),
+	PERF_RECORD_COUNT = 16,
+	REGION_DEPTH = 16,
 };
 
 struct bootstage_record {
@@ -34,16 +40,63 @@ struct bootstage_record {
 	const char *name;
 	int flags;		/* see enum bootstage_flags */
 	enum bootstage_id id;
+	enum bootstage_id parent;	/* enclosing stage, or 0 if none */
+	int active;		/* number of starts not yet accumulated */
 };
 
+/**
+ * struct bootstage_perf - performance counters for an accumulated stage
+ *
+ * These are kept separate from the records so that the stash format does not
+ * change.
+ *
+ * @id: Bootstage ID of the stage
+ * @start: Counters when the stage was last started
+ * @total: Total change in the counters while in the stage
+ */
+struct bootstage_perf {
+	enum bootstage_id id;
+	struct perf_counter_values start;
+	struct perf_counter_values total;
+};
+
+/**
+ * struct bootstage_data - bootstage records and lookup table
+ *
+ * This is followed in memory by a hash table of u16 record indices (plus one,
+ * so zero means an empty slot), found with rec_hash(). Records are entered
+ * by ID and, if BOOTSTAGEF_NAMED is set, also by name. After relocation, and
+ * after the records are grown, the names of the existing records are copied to
+ * follow the hash table.
+ *
+ * @rec_count: Number of records in use
+ * @rec_max: Number of records there is space for
+ * @hash_mask: Number of hash-table slots minus one
+ * @next_id: Next ID to use for BOOTSTAGE_ID_ALLOC
+ * @malloced: true if this was allocated with the full malloc(), so can be
+ *	freed when growing
+ * @depth: Number of active entries in @region
+ * @region: IDs of the accumulated stages which are currently started,
+ *	innermost last
+ * @record: Records
+ */
 struct bootstage_data {
 	uint rec_count;
+	uint rec_max;
+	uint hash_mask;
 	uint next_id;
-	struct bootstage_record record[RECORD_COUNT];
+	bool malloced;
+	uint depth;
+	enum bootstage_id region[REGION_DEPTH];
+#ifdef CONFIG_BOOTSTAGE_PERF
+	uint perf_count;
+	struct bootstage_perf perf[PERF_RECORD_COUNT];
+#endif
+	struct bootstage_record record[];
 };
 
 enum {
-	BOOTSTAGE_VERSION	= 0,
+	BOOTSTAGE_VERSION	= 1,
 	BOOTSTAGE_MAGIC		= 0xb00757a3,
 	BOOTSTAGE_DIGITS	= 9,
 };
@@ -56,39 +109,123 @@ struct bootstage_hdr {
 	u32 next_id;		/* Next ID to use for bootstage */
 };
 
-int bootstage_relocate(void)
+static uint hash_slots(uint rec_max)
+{
+	/* Allow for each record being entered by ID and by name */
+	return roundup_pow_of_two(rec_max * 4);
+}
+
+/* Get the size of bootstage data with space for @rec_max records */
+static uint data_size(uint rec_max)
+{
+	return sizeof(struct bootstage_data) +
+		rec_max * sizeof(struct bootstage_record) +
+		hash_slots(rec_max) * sizeof(u16);
+}
+
+static u16 *rec_hash(struct bootstage_data *data)
+{
+	return (u16 *)(data->record + data->rec_max);
+}
+
+static uint hash_id(enum bootstage_id id)
+{
+	return id * 2654435761U;
+}
+
+static uint hash_name(const char *name)
+{
+	uint hash = 5381;
+
+	while (*name)
+		hash = hash * 33 + *name++;
+
+	return hash;
+}
+
+static void hash_insert(struct bootstage_data *data, uint hash, uint recnum)
+{
+	u16 *table = rec_hash(data);
+	uint slot;
+
+	for (slot = hash & data->hash_mask; table[slot];
+	     slot = (slot + 1) & data->hash_mask)
+		;
+	table[slot] = recnum + 1;
+}
+
+static void hash_add(struct bootstage_data *data, uint recnum)
+{
+	struct bootstage_record *rec = &data->record[recnum];
+
+	hash_insert(data, hash_id(rec->id), recnum);
+	if (rec->flags & BOOTSTAGEF_NAMED)
+		hash_insert(data, hash_name(rec->name), recnum);
+}
+
+/* Rebuild the hash table, e.g. after the records are moved or sorted */
+static void hash_rebuild(struct bootstage_data *data)
 {
-	struct bootstage_data *data = gd->bootstage;
 	int i;
-	char *ptr;
 
-	/* Figure out where to relocate the strings to */
-	ptr = (char *)(data + 1);
+	memset(rec_hash(data), '\0', (data->hash_mask + 1) * sizeof(u16));
+	for (i = 0; i < data->rec_count; i++)
+		hash_add(data, i);
+}
+
+/* Get the space needed for the record names */
+static uint names_size(struct bootstage_data *data)
+{
+	uint size = 0;
+	int i;
+
+	for (i = 0; i < data->rec_count; i++) {
+		if (data->record[i].name)
+			size += strlen(data->record[i].name) + 1;
+	}
+
+	return size;
+}
+
+/* Copy the record names to just after the hash table */
+static void copy_names(struct bootstage_data *data)
+{
+	char *ptr = (char *)(rec_hash(data) + data->hash_mask + 1);
+	int i;
 
-	/*
-	 * Duplicate all strings.  They may point to an old location in the
-	 * program .text section that can eventually get trashed.
-	 */
-	debug("Relocating %d records\n", data->rec_count);
 	for (i = 0; i < data->rec_count; i++) {
 		const char *from = data->record[i].name;
 
+		if (!from)
+			continue;
 		strcpy(ptr, from);
 		data->record[i].name = ptr;
 		ptr += strlen(ptr) + 1;
 	}
+}
+
+int bootstage_relocate(void)
+{
+	/*
+	 * Duplicate all strings.  They may point to an old location in the
+	 * program .text section that can eventually get trashed.
+	 */
+	debug("Relocating %d records\n", gd->bootstage->rec_count);
+	copy_names(gd->bootstage);
 
 	return 0;
 }
 
-struct bootstage_record *find_id(struct bootstage_data *data,
-				 enum bootstage_id id)
+static struct bootstage_record *find_id(struct bootstage_data *data,
+					enum bootstage_id id)
 {
-	struct bootstage_record *rec;
-	struct bootstage_record *end;
+	u16 *table = rec_hash(data);
+	uint slot;
+
+	for (slot = hash_id(id) & data->hash_mask; table[slot];
+	     slot = (slot + 1) & data->hash_mask) {
+		struct bootstage_record *rec = &data->record[table[slot] - 1];
 
-	for (rec = data->record, end = rec + data->rec_count; rec < end;
-	     rec++) {
 		if (rec->id == id)
 			return rec;
 	}
@@ -96,17 +233,104 @@ struct bootstage_record *find_id(struct bootstage_data *data,
 	return NULL;
 }
 
-struct bootstage_record *ensure_id(struct bootstage_data *data,
-				   enum bootstage_id id)
+static struct bootstage_record *find_name(struct bootstage_data *data,
+					  const char *name)
+{
+	u16 *table = rec_hash(data);
+	uint slot;
+
+	for (slot = hash_name(name) & data->hash_mask; table[slot];
+	     slot = (slot + 1) & data->hash_mask) {
+		struct bootstage_record *rec = &data->record[table[slot] - 1];
+
+		if ((rec->flags & BOOTSTAGEF_NAMED) && !strcmp(rec->name, name))
+			return rec;
+	}
+
+	return NULL;
+}
+
+/**
+ * grow() - Move the records to a larger block of memory
+ *
+ * This is only possible once the full malloc() is available. Before that, the
+ * records are limited to CONFIG_BOOTSTAGE_RECORD_COUNT
+ *
+ * @data: Current bootstage data
+ * Return: new bootstage data, or NULL if it could not be grown
+ */
+static struct bootstage_data *grow(struct bootstage_data *data)
+{
+	struct bootstage_data *new;
+	uint rec_max = data->rec_max * 2;
+
+	if (!(gd->flags & GD_FLG_FULL_MALLOC_INIT))
+		return NULL;
+	new = malloc(data_size(rec_max) + names_size(data));
+	if (!new)
+		return NULL;
+	memcpy(new, data, sizeof(*data) +
+	       data->rec_count * sizeof(struct bootstage_record));
+	new->rec_max = rec_max;
+	new->hash_mask = hash_slots(rec_max) - 1;
+	new->malloced = true;
+
+	/*
+	 * After bootstage_relocate() the names are held in the old data, so
+	 * copy them before it is freed
+	 */
+	copy_names(new);
+	hash_rebuild(new);
+	if (data->malloced)
+		free(data);
+	gd->bootstage = new;
+	debug("Bootstage grown to %d records\n", rec_max);
+
+	return new;
+}
+
+/**
+ * add_record() - Add a new record
+ *
+ * This may move the bootstage data, so gd->bootstage must be re-read after
+ * calling this
+ *
+ * @id: ID of the record
+ * @name: Name of the record, or NULL
+ * @flags: Flags for the record (enum bootstage_flags)
+ * Return: new record, or NULL if there is no space
+ */
+static struct bootstage_record *add_record(enum bootstage_id id,
+					   const char *name, int flags)
 {
+	struct bootstage_data *data = gd->bootstage;
 	struct bootstage_record *rec;
 
-	rec = find_id(data, id);
-	if (!rec && data->rec_count < RECORD_COUNT) {
-		rec = &data->record[data->rec_count++];
-		rec->id = id;
-		return rec;
+	if (data->rec_count == data->rec_max) {
+		data = grow(data);
+		if (!data) {
+			log_warning("Bootstage space exhasuted\n");
+			return NULL;
+		}
 	}
+	rec = &data->record[data->rec_count];
+	memset(rec, '\0', sizeof(*rec));
+	rec->id = id;
+	rec->name = name;
+	rec->flags = flags;
+	hash_add(data, data->rec_count++);
+
+	return rec;
+}
+
+static struct bootstage_record *ensure_id(struct bootstage_data *data,
+					  enum bootstage_id id)
+{
+	struct bootstage_record *rec;
+
+	rec = find_id(data, id);
+	if (!rec)
+		rec = add_record(id, NULL, 0);
 
 	return rec;
 }
@@ -130,15 +354,9 @@ ulong bootstage_add_record(enum bootstage_id id, const char *name,
 	/* Only record the first event for each */
 	rec = find_id(data, id);
 	if (!rec) {
-		if (data->rec_count < RECORD_COUNT) {
-			rec = &data->record[data->rec_count++];
+		rec = add_record(id, name, flags);
+		if (rec)
 			rec->time_us = mark;
-			rec->name = name;
-			rec->flags = flags;
-			rec->id = id;
-		} else {
-			log_warning("Bootstage space exhasuted\n");
-		}
 	}
 
 	/* Tell the board about this progress */
@@ -196,28 +414,137 @@ ulong bootstage_mark_code(const char *file, const char *func, int linenum)
 	return bootstage_mark_name(BOOTSTAGE_ID_ALLOC, str);
 }
 
+#ifdef CONFIG_BOOTSTAGE_PERF
+static struct bootstage_perf *find_perf(struct bootstage_data *data,
+					enum bootstage_id id, bool create)
+{
+	struct bootstage_perf *perf;
+	int i;
+
+	for (i = 0, perf = data->perf; i < data->perf_count; i++, perf++) {
+		if (perf->id == id)
+			return perf;
+	}
+	if (!create || data->perf_count == PERF_RECORD_COUNT)
+		return NULL;
+	perf = &data->perf[data->perf_count++];
+	memset(perf, '\0', sizeof(*perf));
+	perf->id = id;
+
+	return perf;
+}
+
+static void perf_start(struct bootstage_data *data, enum bootstage_id id)
+{
+	struct bootstage_perf *perf = find_perf(data, id, true);
+
+	if (perf)
+		perf_counter_read(&perf->start);
+}
+
+static void perf_accum(struct bootstage_data *data, enum bootstage_id id)
+{
+	struct bootstage_perf *perf = find_perf(data, id, false);
+	struct perf_counter_values end;
+
+	if (perf && !perf_counter_read(&end))
+		perf_counter_add(&perf->total, &perf->start, &end);
+}
+
+static void perf_print(struct bootstage_data *data, enum bootstage_id id)
+{
+	struct bootstage_perf *perf = find_perf(data, id, false);
+
+	if (perf && perf->total.valid) {
+		printf("%24s", "");
+		perf_counter_print(&perf->total);
+	}
+}
+#else
+static inline void perf_start(struct bootstage_data *data,
+			      enum bootstage_id id) {}
+static inline void perf_accum(struct bootstage_data *data,
+			      enum bootstage_id id) {}
+static inline void perf_print(struct bootstage_data *data,
+			      enum bootstage_id id) {}
+#endif
+
+/* Start timing a record, noting the enclosing stage, if any */
+static void start_record(struct bootstage_data *data,
+			 struct bootstage_record *rec, ulong start_us)
+{
+	/* Nothing to do if this is a recursive start, e.g. a nested probe */
+	if (rec->active++)
+		return;
+	/* The enclosing stage is the one active when first started */
+	if (!rec->start_us && data->depth)
+		rec->parent = data->region[data->depth - 1];
+	rec->start_us = start_us;
+	if (data->depth < REGION_DEPTH)
+		data->region[data->depth++] = rec->id;
+	perf_start(data, rec->id);
+}
+
 uint32_t bootstage_start(enum bootstage_id id, const char *name)
 {
-	struct bootstage_data *data = gd->bootstage;
-	struct bootstage_record *rec = ensure_id(data, id);
+	struct bootstage_record *rec = ensure_id(gd->bootstage, id);
 	ulong start_us = timer_get_boot_us();
 
 	if (rec) {
-		rec->start_us = start_us;
 		rec->name = name;
+		start_record(gd->bootstage, rec, start_us);
 	}
 
 	return start_us;
 }
 
+int bootstage_start_name(const char *name)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct bootstage_record *rec;
+	ulong start_us = timer_get_boot_us();
+
+	if (!data)
+		return 0;
+	rec = find_name(data, name);
+	if (!rec) {
+		rec = add_record(data->next_id, name, BOOTSTAGEF_NAMED);
+		if (!rec)
+			return 0;
+		data = gd->bootstage;
+		data->next_id++;
+	}
+	start_record(data, rec, start_us);
+
+	return rec->id;
+}
+
 uint32_t bootstage_accum(enum bootstage_id id)
 {
 	struct bootstage_data *data = gd->bootstage;
-	struct bootstage_record *rec = ensure_id(data, id);
+	struct bootstage_record *rec;
 	uint32_t duration;
+	int i;
 
+	if (!data || !id)
+		return 0;
+	rec = ensure_id(data, id);
 	if (!rec)
 		return 0;
+	data = gd->bootstage;
+	if (rec->active > 1) {
+		rec->active--;
+		return 0;
+	}
+	rec->active = 0;
+	/* Pop the stage, along with any inner ones which were not accumulated */
+	for (i = data->depth; i > 0; i--) {
+		if (data->region[i - 1] == id) {
+			data->depth = i - 1;
+			break;
+		}
+	}
+	perf_accum(data, id);
 	duration = (uint32_t)timer_get_boot_us() - rec->start_us;
 	rec->time_us += duration;
 
@@ -269,6 +596,64 @@ static int h_compare_record(const void *r1, const void *r2)
 }
 
 #ifdef CONFIG_OF_LIBFDT
+/**
+ * add_nested_stages() - Add accumulated stages within a parent stage
+ *
+ * @blob: Device tree blob
+ * @node: Node to add the stages to
+ * @parent: ID of the parent stage, or 0 for the top level
+ * Return: 0 on success, -ve FDT error on failure
+ */
+static int add_nested_stages(void *blob, int node, enum bootstage_id parent)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct bootstage_record *rec;
+	char buf[20];
+	int subnode;
+	int ret;
+	int i;
+
+	for (i = 0, rec = data->record; i < data->rec_count; i++, rec++) {
+		if (!rec->start_us || rec->parent != parent)
+			continue;
+		subnode = fdt_add_subnode(blob, node, simple_itoa(rec->id));
+		if (subnode < 0)
+			return subnode;
+		ret = fdt_setprop_string(blob, subnode, "name",
+					 get_record_name(buf, sizeof(buf), rec));
+		if (!ret)
+			ret = fdt_setprop_cell(blob, subnode, "accum",
+					       rec->time_us);
+		if (!ret)
+			ret = add_nested_stages(blob, subnode, rec->id);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * Add the accumulated stages to a device tree, nested by enclosing stage
+ *
+ * This creates a 'nested' node containing a node for each top-level stage,
+ * named by its ID, with the stages started within it as subnodes.
+ *
+ * @param blob		Device tree blob
+ * @param bootstage	Offset of bootstage node
+ * Return: 0 on success, != 0 on failure.
+ */
+static int add_nested_devicetree(void *blob, int bootstage)
+{
+	int node;
+
+	node = fdt_add_subnode(blob, bootstage, "nested");
+	if (node < 0)
+		return node;
+
+	return add_nested_stages(blob, node, 0);
+}
+
 /**
  * Add all bootstage timings to a device tree.
  *
@@ -321,6 +706,19 @@ static int add_bootstages_devicetree(struct fdt_header *blob)
 			return -EINVAL;
 	}
 
+	if (add_nested_devicetree(blob, bootstage))
+		return -EINVAL;
+
+	/* Add the storage statistics, so the OS can see where time went */
+#if CONFIG_IS_ENABLED(BLK_STATS)
+	if (blk_stats_fdt_add(blob, bootstage))
+		return -EINVAL;
+#endif
+#if CONFIG_IS_ENABLED(MTD_STATS)
+	if (mtd_stats_fdt_add(blob, bootstage))
+		return -EINVAL;
+#endif
+
 	return 0;
 }
 
@@ -333,6 +731,34 @@ int bootstage_fdt_add_report(void)
 }
 #endif
 
+/**
+ * print_nested() - Print the accumulated stages within a parent stage
+ *
+ * Each stage is followed by the stages started within it, indented
+ *
+ * @data: Bootstage data
+ * @parent: ID of the parent stage, or 0 for the top level
+ * @depth: Nesting depth of @parent
+ */
+static void print_nested(struct bootstage_data *data,
+			 enum bootstage_id parent, int depth)
+{
+	struct bootstage_record *rec;
+	char buf[20];
+	int i;
+
+	for (i = 0, rec = data->record; i < data->rec_count; i++, rec++) {
+		if (!rec->start_us || rec->parent != parent)
+			continue;
+		printf("%11s", "");
+		print_grouped_ull(rec->time_us, BOOTSTAGE_DIGITS);
+		printf("  %*s%s\n", depth * 2, "",
+		       get_record_name(buf, sizeof(buf), rec));
+		perf_print(data, rec->id);
+		print_nested(data, rec->id, depth + 1);
+	}
+}
+
 void bootstage_report(void)
 {
 	struct bootstage_data *data = gd->bootstage;
@@ -348,21 +774,15 @@ void bootstage_report(void)
 
 	/* Sort records by increasing time */
 	qsort(data->record, data->rec_count, sizeof(*rec), h_compare_record);
+	hash_rebuild(data);
 
 	for (i = 1, rec++; i < data->rec_count; i++, rec++) {
 		if (rec->id && !rec->start_us)
 			prev = print_time_record(rec, prev);
 	}
-	if (data->rec_count > RECORD_COUNT)
-		printf("Overflowed internal boot id table by %d entries\n"
-		       "Please increase CONFIG_(SPL_TPL_)BOOTSTAGE_RECORD_COUNT\n",
-		       data->rec_count - RECORD_COUNT);
 
 	puts("\nAccumulated time:\n");
-	for (i = 0, rec = data->record; i < data->rec_count; i++, rec++) {
-		if (rec->start_us)
-			prev = print_time_record(rec, -1);
-	}
+	print_nested(data, 0, 0);
 }
 
 /**
@@ -475,11 +895,16 @@ int bootstage_unstash(const void *base, int size)
 		return -EINVAL;
 	}
 
-	if (data->rec_count + hdr->count > RECORD_COUNT) {
-		debug("%s: Bootstage has %d records, we have space for %d\n"
-			"Please increase CONFIG_(SPL_)BOOTSTAGE_RECORD_COUNT\n",
-		      __func__, hdr->count, RECORD_COUNT - data->rec_count);
-		return -ENOSPC;
+	while (data->rec_count + hdr->count > data->rec_max) {
+		data = grow(data);
+		if (!data) {
+			data = gd->bootstage;
+			debug("%s: Bootstage has %d records, we have space for %d\n"
+			      "Please increase CONFIG_(SPL_)BOOTSTAGE_RECORD_COUNT\n",
+			      __func__, hdr->count,
+			      data->rec_max - data->rec_count);
+			return -ENOSPC;
+		}
 	}
 
 	ptr += sizeof(*hdr);
@@ -490,8 +915,9 @@ int bootstage_unstash(const void *base, int size)
 
 	/* Read the name strings */
 	ptr += rec_size;
-	for (rec = data->record + data->next_id, i = 0; i < hdr->count;
+	for (rec = data->record + data->rec_count, i = 0; i < hdr->count;
 	     i++, rec++) {
+		rec->active = 0;
 		rec->name = ptr;
 		if (spl_phase() == PHASE_SPL)
 			rec->name = strdup(ptr);
@@ -503,6 +929,7 @@ int bootstage_unstash(const void *base, int size)
 	/* Mark the records as read */
 	data->rec_count += hdr->count;
 	data->next_id = hdr->next_id;
+	hash_rebuild(data);
 	debug("Unstashed %d records\n", hdr->count);
 
 	return 0;
@@ -511,28 +938,23 @@ int bootstage_unstash(const void *base, int size)
 int bootstage_get_size(void)
 {
 	struct bootstage_data *data = gd->bootstage;
-	struct bootstage_record *rec;
-	int size;
-	int i;
-
-	size = sizeof(struct bootstage_data);
-	for (rec = data->record, i = 0; i < data->rec_count;
-	     i++, rec++)
-		size += strlen(rec->name) + 1;
 
-	return size;
+	return data_size(data->rec_max) + names_size(data);
 }
 
 int bootstage_init(bool first)
 {
 	struct bootstage_data *data;
-	int size = sizeof(struct bootstage_data);
+	int size = data_size(RECORD_COUNT);
 
 	gd->bootstage = (struct bootstage_data *)malloc(size);
 	if (!gd->bootstage)
 		return -ENOMEM;
 	data = gd->bootstage;
 	memset(data, '\0', size);
+	data->rec_max = RECORD_COUNT;
+	data->hash_mask = hash_slots(RECORD_COUNT) - 1;
+	data->malloced = gd->flags & GD_FLG_FULL_MALLOC_INIT;
 	if (first) {
 		data->next_id = BOOTSTAGE_ID_USER;
 		bootstage_add_record(BOOTSTAGE_ID_AWAKE, "reset", 0, 0);
@@ -29,6 +29,10 @@ static int fdt_simplefb_configure_node(void *blob, int off)
 	int ret;
 
 	ret = uclass_first_device_err(UCLASS_VIDEO, &dev);
+	if (ret)
+		return ret;
+	/* The OS expects the display at the base address */
+	ret = video_fix_offset(dev);
 	if (ret)
 		return ret;
 	uc_priv = dev_get_uclass_priv(dev);
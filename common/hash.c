@@ -208,6 +208,8 @@ static int __maybe_unused hash_finish_crc32(struct hash_algo *algo, void *ctx,
 /*
  * These are the hash algorithms we support.  If we have hardware acceleration
  * is enable we will use that, otherwise a software version of the algorithm.
+ * The software SHA-256 and SHA-384/512 versions use CPU instructions where
+ * available (e.g. CONFIG_CRYPTO_SHA512_ARM64_CE), falling back to C code.
  * Note that algorithm names must be in lower case.
  */
 static struct hash_algo hash_algo[] = {
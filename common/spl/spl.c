@@ -10,6 +10,7 @@
 #include <bloblist.h>
 #include <binman_sym.h>
 #include <bootstage.h>
+#include <cpu_func.h>
 #include <dm.h>
 #include <handoff.h>
 #include <hang.h>
@@ -724,6 +725,9 @@ void board_init_r(gd_t *dummy1, ulong dummy2)
 	 */
 	timer_init();
 #endif
+	/* DRAM is set up now, so map it and run the rest of SPL cached */
+	if (CONFIG_IS_ENABLED(MMU_EARLY))
+		mmu_setup_early(NULL);
 	if (CONFIG_IS_ENABLED(BLOBLIST)) {
 		ret = bloblist_init();
 		if (ret) {
@@ -838,6 +842,11 @@ void board_init_r(gd_t *dummy1, ulong dummy2)
 		debug("Failed to stash bootstage: err=%d\n", ret);
 #endif
 
+	if (CONFIG_IS_ENABLED(MMU_EARLY)) {
+		/* Write back the loaded image and hand over with caches off */
+		dcache_disable();
+		invalidate_icache_all();
+	}
 	spl_board_prepare_for_boot();
 	jump_to_image_no_args(&spl_image);
 }
@@ -20,6 +20,7 @@
 #include <spi_flash.h>
 #include <splash.h>
 #include <usb.h>
+#include <video.h>
 #include <virtio.h>
 #include <asm/global_data.h>
 
@@ -101,6 +102,12 @@ static int splash_load_raw(struct splash_location *location, u32 bmp_load_addr)
 
 	bmp_hdr = (struct bmp_header *)(uintptr_t)bmp_load_addr;
 	bmp_size = le32_to_cpu(bmp_hdr->file_size);
+	if (IS_ENABLED(CONFIG_VIDEO_RAW_IMAGE)) {
+		struct video_raw_header *raw = (void *)bmp_hdr;
+
+		if (le32_to_cpu(raw->magic) == VIDEO_RAW_MAGIC)
+			bmp_size = sizeof(*raw) + le32_to_cpu(raw->size);
+	}
 
 	if (bmp_load_addr + bmp_size >= gd->start_addr_sp)
 		goto splash_address_too_high;
@@ -293,6 +293,45 @@ int usb_bulk_msg(struct usb_device *dev, unsigned int pipe,
 		return -EIO;
 }
 
+/*
+ * submits a batch of bulk messages, keeping them all queued in the host
+ * controller where it supports that, and waits for completion.
+ * Each request's act_len and status is filled in. Once a request fails, the
+ * remaining requests are not processed.
+ * Returns 0 if all requests succeeded, negative on error.
+ */
+int usb_bulk_msg_queue(struct usb_device *dev, struct usb_bulk_req *reqs,
+		       int count, int timeout)
+{
+	struct usb_bulk_req *req;
+	int ret, i;
+
+	for (i = 0; i < count; i++) {
+		if (reqs[i].length < 0)
+			return -EINVAL;
+		reqs[i].act_len = 0;
+		reqs[i].status = USB_ST_NOT_PROC;
+	}
+
+#if CONFIG_IS_ENABLED(DM_USB)
+	ret = submit_bulk_queue(dev, reqs, count);
+	if (ret != -ENOSYS)
+		return ret ? -EIO : 0;
+#endif
+
+	/* No queueing in the controller, so send the messages one by one */
+	for (i = 0; i < count; i++) {
+		req = &reqs[i];
+		ret = usb_bulk_msg(dev, req->pipe, req->buffer, req->length,
+				   &req->act_len, timeout);
+		req->status = dev->status;
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 
 /*-------------------------------------------------------------------
  * Max Packet stuff
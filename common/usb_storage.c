@@ -43,6 +43,7 @@
 #include <asm/byteorder.h>
 #include <asm/cache.h>
 #include <asm/processor.h>
+#include <asm/unaligned.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
 #include <linux/delay.h>
@@ -83,6 +84,7 @@ struct us_data {
 
 	unsigned int	flags;			/* from filter initially */
 #	define USB_READY	(1 << 0)
+#	define USB_XFER_TUNED	(1 << 1)	/* max_xfer_blk is final */
 	unsigned char	ifnum;			/* interface number */
 	unsigned char	ep_in;			/* in endpoint */
 	unsigned char	ep_out;			/* out ....... */
@@ -101,6 +103,13 @@ struct us_data {
 	trans_reset	transport_reset;	/* reset routine */
 	trans_cmnd	transport;		/* transport routine */
 	unsigned short	max_xfer_blk;		/* maximum transfer blocks */
+#ifdef CONFIG_USB_STORAGE_UAS
+	unsigned char	ep_cmd;			/* UAS command endpoint */
+	unsigned char	ep_status;		/* UAS status endpoint */
+	unsigned char	uas_tags;		/* UAS commands in flight */
+	unsigned int	uas_max_xfer;		/* max bytes per UAS command */
+	unsigned char	uas_sense[18];		/* sense of last UAS command */
+#endif
 };
 
 #if !CONFIG_IS_ENABLED(BLK)
@@ -111,6 +120,22 @@ static struct us_data usb_stor[USB_MAX_STOR_DEV];
 #define USB_STOR_TRANSPORT_FAILED -1
 #define USB_STOR_TRANSPORT_ERROR  -2
 
+#ifdef CONFIG_USB_STORAGE_UAS
+/*
+ * Maximum number of UAS commands kept in flight. Tag n uses stream n, so
+ * this also bounds the number of streams allocated per endpoint.
+ */
+#define UAS_MAX_TAGS	8
+
+/* Information units of one UAS command; these need to be DMA-able */
+struct uas_tag_buf {
+	struct uas_command_iu cmd __aligned(ARCH_DMA_MINALIGN);
+	struct uas_sense_iu sense __aligned(ARCH_DMA_MINALIGN);
+};
+
+static struct uas_tag_buf uas_tag_bufs[UAS_MAX_TAGS];
+#endif
+
 int usb_stor_get_info(struct usb_device *dev, struct us_data *us,
 		      struct blk_desc *dev_desc);
 int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
@@ -528,16 +553,16 @@ static int usb_stor_CB_reset(struct us_data *us)
 }
 
 /*
- * Set up the command for a BBB device. Note that the actual SCSI
- * command is copied into cbw.CBWCDB.
+ * Fill in the CBW for a BBB device. Note that the actual SCSI command is
+ * copied into cbw.CBWCDB.
  */
-static int usb_stor_BBB_comdat(struct scsi_cmd *srb, struct us_data *us)
+static int usb_stor_BBB_setup_cbw(struct scsi_cmd *srb,
+				  struct umass_bbb_cbw *cbw)
 {
-	int result;
-	int actlen;
 	int dir_in;
-	unsigned int pipe;
-	ALLOC_CACHE_ALIGN_BUFFER(struct umass_bbb_cbw, cbw, 1);
+#ifdef BBB_COMDAT_TRACE
+	int i;
+#endif
 
 	dir_in = US_DIRECTION(srb->cmd[0]);
 
@@ -546,8 +571,8 @@ static int usb_stor_BBB_comdat(struct scsi_cmd *srb, struct us_data *us)
 		dir_in, srb->lun, srb->cmdlen, srb->cmd, srb->datalen,
 		srb->pdata);
 	if (srb->cmdlen) {
-		for (result = 0; result < srb->cmdlen; result++)
-			printf("cmd[%d] %#x ", result, srb->cmd[result]);
+		for (i = 0; i < srb->cmdlen; i++)
+			printf("cmd[%d] %#x ", i, srb->cmd[i]);
 		printf("\n");
 	}
 #endif
@@ -557,9 +582,6 @@ static int usb_stor_BBB_comdat(struct scsi_cmd *srb, struct us_data *us)
 		return -1;
 	}
 
-	/* always OUT to the ep */
-	pipe = usb_sndbulkpipe(us->pusb_dev, us->ep_out);
-
 	cbw->dCBWSignature = cpu_to_le32(CBWSIGNATURE);
 	cbw->dCBWTag = cpu_to_le32(CBWTag++);
 	cbw->dCBWDataTransferLength = cpu_to_le32(srb->datalen);
@@ -570,6 +592,27 @@ static int usb_stor_BBB_comdat(struct scsi_cmd *srb, struct us_data *us)
 	/* DST SRC LEN!!! */
 
 	memcpy(cbw->CBWCDB, srb->cmd, srb->cmdlen);
+
+	return 0;
+}
+
+/*
+ * Set up the command for a BBB device and send it.
+ */
+static int usb_stor_BBB_comdat(struct scsi_cmd *srb, struct us_data *us)
+{
+	int result;
+	int actlen;
+	unsigned int pipe;
+	ALLOC_CACHE_ALIGN_BUFFER(struct umass_bbb_cbw, cbw, 1);
+
+	result = usb_stor_BBB_setup_cbw(srb, cbw);
+	if (result < 0)
+		return result;
+
+	/* always OUT to the ep */
+	pipe = usb_sndbulkpipe(us->pusb_dev, us->ep_out);
+
 	result = usb_bulk_msg(us->pusb_dev, pipe, cbw, UMASS_BBB_CBW_SIZE,
 			      &actlen, USB_CNTL_TIMEOUT * 5);
 	if (result < 0)
@@ -717,6 +760,56 @@ static int usb_stor_BBB_transport(struct scsi_cmd *srb, struct us_data *us)
 #endif
 
 	dir_in = US_DIRECTION(srb->cmd[0]);
+	pipein = usb_rcvbulkpipe(us->pusb_dev, us->ep_in);
+	pipeout = usb_sndbulkpipe(us->pusb_dev, us->ep_out);
+	data_actlen = 0;
+
+	/*
+	 * Once the device is ready, queue all three phases of a read at once
+	 * so that the host controller does not idle between them
+	 */
+	if ((us->flags & USB_READY) && dir_in && srb->datalen) {
+		ALLOC_CACHE_ALIGN_BUFFER(struct umass_bbb_cbw, cbw, 1);
+		struct usb_bulk_req reqs[] = {
+			{ pipeout, cbw, UMASS_BBB_CBW_SIZE },
+			{ pipein, srb->pdata, srb->datalen },
+			{ pipein, csw, UMASS_BBB_CSW_SIZE },
+		};
+
+		debug("COMMAND/DATA/STATUS phases queued\n");
+		result = usb_stor_BBB_setup_cbw(srb, cbw);
+		if (result >= 0)
+			result = usb_bulk_msg_queue(us->pusb_dev, reqs,
+						    ARRAY_SIZE(reqs),
+						    USB_CNTL_TIMEOUT * 5);
+		data_actlen = reqs[1].act_len;
+		if (result >= 0)
+			goto check_csw;
+		if (reqs[0].status) {
+			debug("failed to send CBW status %ld\n",
+			      reqs[0].status);
+			usb_stor_BBB_reset(us);
+			return USB_STOR_TRANSPORT_FAILED;
+		}
+		if (reqs[1].status & USB_ST_STALLED) {
+			debug("DATA:stall\n");
+			/* clear the STALL and continue on to STATUS phase */
+			result = usb_stor_BBB_clear_endpt_stall(us, us->ep_in);
+			if (result >= 0)
+				goto st;
+		} else if (reqs[2].status & USB_ST_STALLED) {
+			debug("STATUS:stall\n");
+			/* clear the STALL on the endpoint and do a retry */
+			result = usb_stor_BBB_clear_endpt_stall(us, us->ep_in);
+			retry = 1;
+			if (result >= 0)
+				goto again;
+		}
+		debug("usb_bulk_msg error status %ld\n",
+		      us->pusb_dev->status);
+		usb_stor_BBB_reset(us);
+		return USB_STOR_TRANSPORT_FAILED;
+	}
 
 	/* COMMAND phase */
 	debug("COMMAND phase\n");
@@ -729,10 +822,7 @@ static int usb_stor_BBB_transport(struct scsi_cmd *srb, struct us_data *us)
 	}
 	if (!(us->flags & USB_READY))
 		mdelay(5);
-	pipein = usb_rcvbulkpipe(us->pusb_dev, us->ep_in);
-	pipeout = usb_sndbulkpipe(us->pusb_dev, us->ep_out);
 	/* DATA phase + error handling */
-	data_actlen = 0;
 	/* no data, go immediately to the STATUS phase */
 	if (srb->datalen == 0)
 		goto st;
@@ -789,6 +879,7 @@ again:
 		usb_stor_BBB_reset(us);
 		return USB_STOR_TRANSPORT_FAILED;
 	}
+check_csw:
 #ifdef BBB_XPORT_TRACE
 	ptr = (unsigned char *)csw;
 	for (index = 0; index < UMASS_BBB_CSW_SIZE; index++)
@@ -827,6 +918,176 @@ again:
 	return result;
 }
 
+#ifdef CONFIG_USB_STORAGE_UAS
+static int usb_stor_UAS_reset(struct us_data *us)
+{
+	struct usb_device *dev = us->pusb_dev;
+
+	debug("UAS Reset\n");
+	usb_clear_halt(dev, usb_sndbulkpipe(dev, us->ep_cmd));
+	usb_clear_halt(dev, usb_rcvbulkpipe(dev, us->ep_status));
+	usb_clear_halt(dev, usb_rcvbulkpipe(dev, us->ep_in));
+	usb_clear_halt(dev, usb_sndbulkpipe(dev, us->ep_out));
+
+	return 0;
+}
+
+/*
+ * Add the transfers for one tagged command to @reqs: the status and data
+ * stages go on the command's stream and are queued ahead of the command
+ * IU, so that the device always finds them waiting. A command which fails
+ * may be answered with only a status IU, so that ends the tag's stream and
+ * cancels its data stage rather than leaving it to time out.
+ */
+static int usb_stor_UAS_queue_cmd(struct scsi_cmd *srb, struct us_data *us,
+				  struct usb_bulk_req *reqs, int tag,
+				  void *data, unsigned long datalen)
+{
+	struct usb_device *dev = us->pusb_dev;
+	struct uas_tag_buf *buf = &uas_tag_bufs[tag - 1];
+	int n = 0;
+
+	memset(&buf->cmd, '\0', sizeof(buf->cmd));
+	buf->cmd.iu_id = UAS_IU_ID_COMMAND;
+	buf->cmd.tag = cpu_to_be16(tag);
+	buf->cmd.prio_attr = UAS_SIMPLE_TAG;
+	buf->cmd.lun[1] = srb->lun;
+	memcpy(buf->cmd.cdb, srb->cmd, min_t(int, srb->cmdlen,
+					     sizeof(buf->cmd.cdb)));
+	memset(&buf->sense, '\0', sizeof(buf->sense));
+
+	reqs[n].pipe = usb_rcvbulkpipe(dev, us->ep_status);
+	reqs[n].buffer = &buf->sense;
+	reqs[n].length = sizeof(buf->sense);
+	reqs[n].flags = USB_BULK_REQ_END_STREAM;
+	reqs[n++].stream_id = tag;
+	if (datalen) {
+		if (US_DIRECTION(srb->cmd[0]))
+			reqs[n].pipe = usb_rcvbulkpipe(dev, us->ep_in);
+		else
+			reqs[n].pipe = usb_sndbulkpipe(dev, us->ep_out);
+		reqs[n].buffer = data;
+		reqs[n].length = datalen;
+		reqs[n].flags = 0;
+		reqs[n++].stream_id = tag;
+	}
+	reqs[n].pipe = usb_sndbulkpipe(dev, us->ep_cmd);
+	reqs[n].buffer = &buf->cmd;
+	reqs[n].length = UAS_COMMAND_IU_SIZE;
+	reqs[n].flags = 0;
+	reqs[n++].stream_id = 0;
+
+	return n;
+}
+
+static int usb_stor_UAS_check_status(struct us_data *us, int tag)
+{
+	struct uas_sense_iu *sense = &uas_tag_bufs[tag - 1].sense;
+	int len;
+
+	if (be16_to_cpu(sense->tag) != tag) {
+		debug("UAS: bad tag %d instead of %d\n",
+		      be16_to_cpu(sense->tag), tag);
+		return USB_STOR_TRANSPORT_ERROR;
+	}
+	if (sense->iu_id != UAS_IU_ID_STATUS) {
+		debug("UAS: command %d rejected, IU %#x\n", tag, sense->iu_id);
+		return USB_STOR_TRANSPORT_ERROR;
+	}
+	if (sense->status == UAS_STATUS_GOOD)
+		return USB_STOR_TRANSPORT_GOOD;
+
+	debug("UAS: command %d status %#x\n", tag, sense->status);
+	len = min_t(int, be16_to_cpu(sense->len), sizeof(us->uas_sense));
+	memcpy(us->uas_sense, sense->sense, len);
+
+	return USB_STOR_TRANSPORT_FAILED;
+}
+
+/*
+ * UAS transport. Large READ(10) and WRITE(10) commands are split into up to
+ * uas_tags tagged commands which are queued together, so that the device
+ * can keep every data stream busy.
+ */
+static int usb_stor_UAS_transport(struct scsi_cmd *srb, struct us_data *us)
+{
+	struct usb_bulk_req reqs[UAS_MAX_TAGS * 3];
+	unsigned long start = 0, blocks = 0, blksz = 0, per_cmd = 0;
+	unsigned long done = 0, count;
+	void *data = srb->pdata;
+	unsigned long datalen = srb->datalen;
+	bool split;
+	int tag, ntags, n, ret, result;
+
+	/* UAS reports sense with the status, so answer from what we kept */
+	if (srb->cmd[0] == SCSI_REQ_SENSE) {
+		if (!us->uas_sense[0]) {
+			us->uas_sense[0] = 0x70;	/* fixed format */
+			us->uas_sense[7] = sizeof(us->uas_sense) - 8;
+		}
+		memcpy(srb->pdata, us->uas_sense,
+		       min_t(unsigned long, srb->datalen,
+			     sizeof(us->uas_sense)));
+		memset(us->uas_sense, '\0', sizeof(us->uas_sense));
+		return USB_STOR_TRANSPORT_GOOD;
+	}
+	memset(us->uas_sense, '\0', sizeof(us->uas_sense));
+
+	split = (srb->cmd[0] == SCSI_READ10 || srb->cmd[0] == SCSI_WRITE10) &&
+		srb->datalen > us->uas_max_xfer;
+	if (split) {
+		start = get_unaligned_be32(&srb->cmd[2]);
+		blocks = get_unaligned_be16(&srb->cmd[7]);
+		blksz = srb->datalen / blocks;
+		per_cmd = us->uas_max_xfer / blksz;
+	}
+
+	do {
+		n = 0;
+		ntags = 0;
+		while (ntags < us->uas_tags) {
+			struct uas_command_iu *cmd = &uas_tag_bufs[ntags].cmd;
+
+			tag = ++ntags;
+
+			if (split) {
+				count = min(per_cmd, blocks - done);
+				data = srb->pdata + done * blksz;
+				datalen = count * blksz;
+			}
+			n += usb_stor_UAS_queue_cmd(srb, us, &reqs[n], tag,
+						    data, datalen);
+			if (!split)
+				break;
+			put_unaligned_be32(start + done, &cmd->cdb[2]);
+			put_unaligned_be16(count, &cmd->cdb[7]);
+			done += count;
+			if (done == blocks)
+				break;
+		}
+
+		ret = usb_bulk_msg_queue(us->pusb_dev, reqs, n,
+					 USB_CNTL_TIMEOUT * 5);
+		if (ret) {
+			debug("UAS: transfer failed %d, status %lX\n", ret,
+			      us->pusb_dev->status);
+			usb_stor_UAS_reset(us);
+			return USB_STOR_TRANSPORT_FAILED;
+		}
+
+		for (tag = 1; tag <= ntags; tag++) {
+			result = usb_stor_UAS_check_status(us, tag);
+			if (result == USB_STOR_TRANSPORT_ERROR)
+				usb_stor_UAS_reset(us);
+			if (result != USB_STOR_TRANSPORT_GOOD)
+				return USB_STOR_TRANSPORT_FAILED;
+		}
+	} while (split && done < blocks);
+
+	return USB_STOR_TRANSPORT_GOOD;
+}
+#endif
+
 static int usb_stor_CB_transport(struct scsi_cmd *srb, struct us_data *us)
 {
 	int result, status;
@@ -939,11 +1200,20 @@ do_retry:
 	return USB_STOR_TRANSPORT_FAILED;
 }
 
+/* Devices which fail transfers above a certain size */
+static const struct usb_stor_quirk {
+	u16		vendor;
+	u16		product;
+	unsigned short	max_xfer_blk;
+} usb_stor_quirks[] = {
+	{ 0x090c, 0x1000, 64 },		/* Samsung Flash Drive FIT */
+};
+
 static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 				      struct us_data *us)
 {
 	/*
-	 * Limit the total size of a transfer to 120 KB.
+	 * By default, limit the total size of a transfer to 120 KB.
 	 *
 	 * Some devices are known to choke with anything larger. It seems like
 	 * the problem stems from the fact that original IDE controllers had
@@ -958,8 +1228,13 @@ static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 	 * Windows 7 limiting transfers to 128 sectors for both USB2 and USB3
 	 * and Apple Mac OS X 10.11 limiting transfers to 256 sectors for USB2
 	 * and 2048 for USB3 devices.
+	 *
+	 * Boards which only use known-good devices may raise the limit with
+	 * CONFIG_USB_STORAGE_MAX_XFER_BLK, optionally checked at runtime by
+	 * usb_stor_probe_max_xfer().
 	 */
-	unsigned short blk = 240;
+	unsigned short blk = CONFIG_USB_STORAGE_MAX_XFER_BLK;
+	int i;
 
 #if CONFIG_IS_ENABLED(DM_USB)
 	size_t size;
@@ -969,6 +1244,24 @@ static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 	if ((ret >= 0) && (size < blk * 512))
 		blk = size / 512;
 #endif
+#ifdef CONFIG_USB_STORAGE_UAS
+	/*
+	 * UAS devices are modern enough not to need the limit above; one
+	 * transfer is split into a tagged command per stream instead.
+	 */
+	if (us->protocol == US_PR_UAS)
+		blk = min_t(unsigned long, USHRT_MAX,
+			    us->uas_tags * (us->uas_max_xfer / 512));
+#endif
+
+	for (i = 0; i < ARRAY_SIZE(usb_stor_quirks); i++) {
+		if (udev->descriptor.idVendor == usb_stor_quirks[i].vendor &&
+		    udev->descriptor.idProduct == usb_stor_quirks[i].product) {
+			blk = min(blk, usb_stor_quirks[i].max_xfer_blk);
+			us->flags |= USB_XFER_TUNED;
+			break;
+		}
+	}
 
 	us->max_xfer_blk = blk;
 }
@@ -1295,6 +1588,116 @@ retry_it:
 
 }
 
+#ifdef CONFIG_USB_STORAGE_UAS
+/*
+ * Look for a UAS alternate setting of the interface and switch to it. The
+ * pipe usage descriptors are not kept by the USB core, so walk the raw
+ * configuration descriptor to find which endpoint is which.
+ */
+static int usb_stor_UAS_probe(struct usb_device *dev,
+			      struct usb_interface *iface, struct us_data *ss)
+{
+	struct usb_interface_descriptor *if_desc = NULL;
+	struct usb_endpoint_descriptor *ep = NULL;
+	struct usb_ss_ep_comp_descriptor *comp;
+	struct usb_pipe_usage_descriptor *usage;
+	unsigned char *buf, *eps[UAS_DATA_OUT_PIPE_ID + 1] = { NULL };
+	unsigned int streams = UAS_MAX_TAGS, ep_streams = 0;
+	unsigned long pipes[3];
+	int alt = -1, len, i, ret;
+	size_t size;
+
+	if (dev->speed < USB_SPEED_SUPER)
+		return -ENOSYS;
+
+	len = usb_get_configuration_len(dev, dev->configno);
+	if (len < 0)
+		return len;
+	buf = malloc_cache_aligned(len);
+	if (!buf)
+		return -ENOMEM;
+	ret = usb_get_configuration_no(dev, dev->configno, buf, len);
+	if (ret < 0)
+		goto out;
+
+	for (i = 0; i + 2 <= len && buf[i] >= 2; i += buf[i]) {
+		switch (buf[i + 1]) {
+		case USB_DT_INTERFACE:
+			if_desc = (struct usb_interface_descriptor *)&buf[i];
+			if (if_desc->bInterfaceNumber ==
+			    iface->desc.bInterfaceNumber &&
+			    if_desc->bInterfaceClass == USB_CLASS_MASS_STORAGE &&
+			    if_desc->bInterfaceSubClass == US_SC_SCSI &&
+			    if_desc->bInterfaceProtocol == US_PR_UAS)
+				alt = if_desc->bAlternateSetting;
+			else if (alt >= 0)
+				i = len;	/* done with the UAS setting */
+			ep = NULL;
+			break;
+		case USB_DT_ENDPOINT:
+			if (alt >= 0)
+				ep = (struct usb_endpoint_descriptor *)&buf[i];
+			ep_streams = 0;
+			break;
+		case USB_DT_SS_ENDPOINT_COMP:
+			comp = (struct usb_ss_ep_comp_descriptor *)&buf[i];
+			ep_streams = usb_ss_max_streams(comp);
+			break;
+		case USB_DT_PIPE_USAGE:
+			usage = (struct usb_pipe_usage_descriptor *)&buf[i];
+			if (ep && usage->bPipeID >= UAS_CMD_PIPE_ID &&
+			    usage->bPipeID <= UAS_DATA_OUT_PIPE_ID) {
+				eps[usage->bPipeID] = &ep->bEndpointAddress;
+				/* all but the command pipe need streams */
+				if (usage->bPipeID != UAS_CMD_PIPE_ID)
+					streams = min(streams, ep_streams);
+			}
+			break;
+		}
+	}
+
+	ret = -ENOENT;
+	for (i = UAS_CMD_PIPE_ID; i <= UAS_DATA_OUT_PIPE_ID; i++) {
+		if (!eps[i])
+			goto out;
+	}
+	if (alt < 0 || !streams)
+		goto out;
+
+	ss->ep_cmd = *eps[UAS_CMD_PIPE_ID] & USB_ENDPOINT_NUMBER_MASK;
+	ss->ep_status = *eps[UAS_STATUS_PIPE_ID] & USB_ENDPOINT_NUMBER_MASK;
+	ss->ep_in = *eps[UAS_DATA_IN_PIPE_ID] & USB_ENDPOINT_NUMBER_MASK;
+	ss->ep_out = *eps[UAS_DATA_OUT_PIPE_ID] & USB_ENDPOINT_NUMBER_MASK;
+	debug("UAS alt %d: Cmd %d Status %d In %d Out %d, %u streams\n", alt,
+	      ss->ep_cmd, ss->ep_status, ss->ep_in, ss->ep_out, streams);
+
+	ret = usb_set_interface(dev, iface->desc.bInterfaceNumber, alt);
+	if (ret)
+		goto out;
+
+	pipes[0] = usb_rcvbulkpipe(dev, ss->ep_status);
+	pipes[1] = usb_rcvbulkpipe(dev, ss->ep_in);
+	pipes[2] = usb_sndbulkpipe(dev, ss->ep_out);
+	ret = usb_alloc_streams(dev, pipes, ARRAY_SIZE(pipes), streams);
+	if (ret <= 0) {
+		debug("UAS: cannot allocate streams (err=%d)\n", ret);
+		usb_set_interface(dev, iface->desc.bInterfaceNumber, 0);
+		ret = ret ? ret : -ENOSPC;
+		goto out;
+	}
+
+	ss->uas_tags = min_t(unsigned int, ret, streams);
+	ss->uas_max_xfer = 240 * 512;
+	if (!usb_get_max_xfer_size(dev, &size))
+		ss->uas_max_xfer = size;
+	ret = 0;
+out:
+	free(buf);
+
+	return ret;
+}
+#endif
+
 /* Probe to see if a new device is actually a Storage device */
 int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 		      struct us_data *ss)
@@ -1329,6 +1732,12 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 	ss->subclass = iface->desc.bInterfaceSubClass;
 	ss->protocol = iface->desc.bInterfaceProtocol;
 
+#ifdef CONFIG_USB_STORAGE_UAS
+	if (iface->desc.bInterfaceSubClass == US_SC_SCSI &&
+	    !usb_stor_UAS_probe(dev, iface, ss))
+		ss->protocol = US_PR_UAS;
+#endif
+
 	/* set the handler pointers based on the protocol */
 	debug("Transport: ");
 	switch (ss->protocol) {
@@ -1348,6 +1757,13 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 		ss->transport = usb_stor_BBB_transport;
 		ss->transport_reset = usb_stor_BBB_reset;
 		break;
+#ifdef CONFIG_USB_STORAGE_UAS
+	case US_PR_UAS:
+		debug("UAS\n");
+		ss->transport = usb_stor_UAS_transport;
+		ss->transport_reset = usb_stor_UAS_reset;
+		break;
+#endif
 	default:
 		printf("USB Storage Transport unknown / not yet implemented\n");
 		return 0;
@@ -1357,9 +1773,10 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 	/*
 	 * We are expecting a minimum of 2 endpoints - in and out (bulk).
 	 * An optional interrupt is OK (necessary for CBI protocol).
-	 * We will ignore any others.
+	 * We will ignore any others. UAS has already found its endpoints.
 	 */
-	for (i = 0; i < iface->desc.bNumEndpoints; i++) {
+	for (i = 0; ss->protocol != US_PR_UAS &&
+	     i < iface->desc.bNumEndpoints; i++) {
 		ep_desc = &iface->ep_desc[i];
 		/* is it an BULK endpoint? */
 		if ((ep_desc->bmAttributes &
@@ -1385,7 +1802,8 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 	      ss->ep_in, ss->ep_out, ss->ep_int);
 
 	/* Do some basic sanity checks, and bail if we find a problem */
-	if (usb_set_interface(dev, iface->desc.bInterfaceNumber, 0) ||
+	if ((ss->protocol != US_PR_UAS &&
+	     usb_set_interface(dev, iface->desc.bInterfaceNumber, 0)) ||
 	    !ss->ep_in || !ss->ep_out ||
 	    (ss->protocol == US_PR_CBI && ss->ep_int == 0)) {
 		debug("Problems with device\n");
@@ -1418,6 +1836,53 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 	return 1;
 }
 
+#ifdef CONFIG_USB_STORAGE_PROBE_XFER
+/*
+ * Find the largest transfer the device actually handles by reading from
+ * the start of the medium, halving the size after each failure. Sizes up
+ * to the conservative 240 blocks are assumed to work.
+ */
+static void usb_stor_probe_max_xfer(struct us_data *ss,
+				    struct blk_desc *dev_desc)
+{
+	struct scsi_cmd *srb = &usb_ccb;
+	unsigned short blk = ss->max_xfer_blk;
+	bool failed = false;
+	void *buf;
+
+	if (ss->flags & USB_XFER_TUNED || blk <= 240 || dev_desc->lba < blk)
+		return;
+
+	buf = memalign(ARCH_DMA_MINALIGN, blk * dev_desc->blksz);
+	if (!buf)
+		return;
+
+	srb->lun = dev_desc->lun;
+	while (blk > 240) {
+		srb->pdata = buf;
+		srb->datalen = blk * dev_desc->blksz;
+		if (!usb_read_10(srb, ss, 0, blk))
+			break;
+		debug("%s: %u blocks failed\n", __func__, blk);
+		usb_request_sense(srb, ss);
+		failed = true;
+		blk = max(blk / 2, 240);
+	}
+	free(buf);
+
+	/*
+	 * A failed probe read is expected, so leave USB_READY alone, but
+	 * check that the device came back before it is used for real.
+	 */
+	if (failed && usb_test_unit_ready(srb, ss))
+		ss->flags &= ~USB_READY;
+
+	debug("%s: using %u blocks\n", __func__, blk);
+	ss->max_xfer_blk = blk;
+	ss->flags |= USB_XFER_TUNED;
+}
+#endif
+
 int usb_stor_get_info(struct usb_device *dev, struct us_data *ss,
 		      struct blk_desc *dev_desc)
 {
@@ -1500,6 +1965,9 @@ int usb_stor_get_info(struct usb_device *dev, struct us_data *ss,
 	dev_desc->log2blksz = LOG2(dev_desc->blksz);
 	dev_desc->type = perq;
 	debug(" address %d\n", dev_desc->target);
+#ifdef CONFIG_USB_STORAGE_PROBE_XFER
+	usb_stor_probe_max_xfer(ss, dev_desc);
+#endif
 
 	return 1;
 }
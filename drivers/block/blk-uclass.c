@@ -9,13 +9,16 @@
 #include <common.h>
 #include <blk.h>
 #include <dm.h>
+#include <io_stats.h>
 #include <log.h>
 #include <malloc.h>
 #include <part.h>
+#include <time.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
 #include <dm/uclass-internal.h>
 #include <linux/err.h>
+#include <linux/libfdt.h>
 
 static const char *if_typename_str[IF_TYPE_COUNT] = {
 	[IF_TYPE_IDE]		= "ide",
@@ -436,20 +439,44 @@ int blk_get_device(int if_type, int devnum, struct udevice **devp)
 	return device_probe(*devp);
 }
 
+static inline ulong blk_stats_start(void)
+{
+	return CONFIG_IS_ENABLED(BLK_STATS) ? timer_get_us() : 0;
+}
+
+static void blk_stats_add(struct blk_desc *desc, enum io_stats_op op,
+			  lbaint_t blkcnt, ulong done, ulong start_us)
+{
+#if CONFIG_IS_ENABLED(BLK_STATS)
+	/* Drivers may return a -ve error code cast to ulong on failure */
+	if (done > blkcnt)
+		done = 0;
+	io_stats_add(&desc->stats, op, (u64)done * desc->blksz, start_us,
+		     done == blkcnt);
+#endif
+}
+
 unsigned long blk_dread(struct blk_desc *block_dev, lbaint_t start,
 			lbaint_t blkcnt, void *buffer)
 {
 	struct udevice *dev = block_dev->bdev;
 	const struct blk_ops *ops = blk_get_ops(dev);
 	ulong blks_read;
+	ulong start_us;
 
 	if (!ops->read)
 		return -ENOSYS;
 
 	if (blkcache_read(block_dev->if_type, block_dev->devnum,
-			  start, blkcnt, block_dev->blksz, buffer))
+			  start, blkcnt, block_dev->blksz, buffer)) {
+#if CONFIG_IS_ENABLED(BLK_STATS)
+		block_dev->stats.cache_hits++;
+#endif
 		return blkcnt;
+	}
+	start_us = blk_stats_start();
 	blks_read = ops->read(dev, start, blkcnt, buffer);
+	blk_stats_add(block_dev, IO_STATS_READ, blkcnt, blks_read, start_us);
 	if (blks_read == blkcnt)
 		blkcache_fill(block_dev->if_type, block_dev->devnum,
 			      start, blkcnt, block_dev->blksz, buffer);
@@ -462,12 +489,19 @@ unsigned long blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 {
 	struct udevice *dev = block_dev->bdev;
 	const struct blk_ops *ops = blk_get_ops(dev);
+	ulong blks_written;
+	ulong start_us;
 
 	if (!ops->write)
 		return -ENOSYS;
 
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
-	return ops->write(dev, start, blkcnt, buffer);
+	start_us = blk_stats_start();
+	blks_written = ops->write(dev, start, blkcnt, buffer);
+	blk_stats_add(block_dev, IO_STATS_WRITE, blkcnt, blks_written,
+		      start_us);
+
+	return blks_written;
 }
 
 unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
@@ -475,12 +509,50 @@ unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
 {
 	struct udevice *dev = block_dev->bdev;
 	const struct blk_ops *ops = blk_get_ops(dev);
+	ulong blks_erased;
+	ulong start_us;
 
 	if (!ops->erase)
 		return -ENOSYS;
 
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
-	return ops->erase(dev, start, blkcnt);
+	start_us = blk_stats_start();
+	blks_erased = ops->erase(dev, start, blkcnt);
+	blk_stats_add(block_dev, IO_STATS_ERASE, blkcnt, blks_erased,
+		      start_us);
+
+	return blks_erased;
+}
+
+int blk_stats_fdt_add(void *blob, int parent)
+{
+#if CONFIG_IS_ENABLED(BLK_STATS)
+	struct udevice *dev;
+	struct uclass *uc;
+	int node;
+	int ret;
+
+	ret = uclass_get(UCLASS_BLK, &uc);
+	if (ret)
+		return 0;
+	node = -FDT_ERR_NOTFOUND;
+	uclass_foreach_dev(dev, uc) {
+		struct blk_desc *desc = dev_get_uclass_plat(dev);
+
+		if (!io_stats_active(&desc->stats))
+			continue;
+		if (node < 0) {
+			node = fdt_add_subnode(blob, parent, "blk");
+			if (node < 0)
+				return node;
+		}
+		ret = io_stats_fdt_add(blob, node, dev->name, &desc->stats);
+		if (ret)
+			return ret;
+	}
+#endif
+
+	return 0;
 }
 
 int blk_get_from_parent(struct udevice *parent, struct udevice **devp)
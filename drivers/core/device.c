@@ -9,6 +9,7 @@
  */
 
 #include <common.h>
+#include <bootstage.h>
 #include <cpu_func.h>
 #include <log.h>
 #include <asm/global_data.h>
@@ -259,7 +260,14 @@ int device_bind_by_name(struct udevice *parent, bool pre_reloc_only,
 	uint plat_size = 0;
 	int ret;
 
+#if CONFIG_IS_ENABLED(OF_PLATDATA_DRIVER_REF)
+	/* Hand-written U_BOOT_DRVINFO() records only give the driver name */
+	drv = info->drv;
+	if (!drv)
+		drv = lists_driver_lookup_name(info->name);
+#else
 	drv = lists_driver_lookup_name(info->name);
+#endif
 	if (!drv)
 		return -ENOENT;
 	if (pre_reloc_only && !(drv->flags & DM_FLAG_PRE_RELOC))
@@ -581,7 +589,14 @@ int device_probe(struct udevice *dev)
 	}
 
 	if (drv->probe) {
+		int stage = 0;
+
+		/* Only after relocation, since records are limited before */
+		if (CONFIG_IS_ENABLED(BOOTSTAGE_DM_PROBE) &&
+		    (gd->flags & GD_FLG_RELOC))
+			stage = bootstage_start_name(drv->name);
 		ret = drv->probe(dev);
+		bootstage_accum(stage);
 		if (ret)
 			goto fail;
 	}
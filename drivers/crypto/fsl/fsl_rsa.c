@@ -54,6 +54,22 @@ int fsl_mod_exp(struct udevice *dev, const uint8_t *sig, uint32_t sig_len,
 	return 0;
 }
 
+/*
+ * Make sure the job ring is up. If there is no CAAM, RSA verification falls
+ * back to the next UCLASS_MOD_EXP device, normally mod_exp_sw.
+ */
+static int fsl_mod_exp_probe(struct udevice *dev)
+{
+#if CONFIG_IS_ENABLED(DM)
+	struct udevice *jr;
+
+	return uclass_get_device_by_driver(UCLASS_MISC, DM_DRIVER_GET(caam_jr),
+					   &jr);
+#else
+	return 0;
+#endif
+}
+
 static const struct mod_exp_ops fsl_mod_exp_ops = {
 	.mod_exp	= fsl_mod_exp,
 };
@@ -62,6 +78,7 @@ U_BOOT_DRIVER(fsl_rsa_mod_exp) = {
 	.name	= "fsl_rsa_mod_exp",
 	.id	= UCLASS_MOD_EXP,
 	.ops	= &fsl_mod_exp_ops,
+	.probe	= fsl_mod_exp_probe,
 };
 
 U_BOOT_DRVINFO(fsl_rsa) = {
@@ -29,6 +29,8 @@
 #include <linux/bitops.h>
 #include <linux/bug.h>
 #include <linux/err.h>
+#include <linux/libfdt.h>
+#include <time.h>
 #include <ubi_uboot.h>
 #endif
 
@@ -169,6 +171,43 @@ bool mtd_dev_list_updated(void)
 	return false;
 }
 
+int mtd_stats_fdt_add(void *blob, int parent)
+{
+#if CONFIG_IS_ENABLED(MTD_STATS)
+	struct mtd_info *mtd;
+	int node = -FDT_ERR_NOTFOUND;
+	int ret;
+
+	mtd_for_each_device(mtd) {
+		if (!io_stats_active(&mtd->stats))
+			continue;
+		if (node < 0) {
+			node = fdt_add_subnode(blob, parent, "mtd");
+			if (node < 0)
+				return node;
+		}
+		ret = io_stats_fdt_add(blob, node, mtd->name, &mtd->stats);
+		if (ret)
+			return ret;
+	}
+#endif
+
+	return 0;
+}
+
+static inline ulong mtd_stats_start(void)
+{
+	return CONFIG_IS_ENABLED(MTD_STATS) ? timer_get_us() : 0;
+}
+
+static void mtd_stats_add(struct mtd_info *mtd, enum io_stats_op op,
+			  u64 bytes, ulong start_us, bool ok)
+{
+#if CONFIG_IS_ENABLED(MTD_STATS)
+	io_stats_add(&mtd->stats, op, bytes, start_us, ok);
+#endif
+}
+
 #ifndef __UBOOT__
 static LIST_HEAD(mtd_notifiers);
 
@@ -908,6 +947,9 @@ EXPORT_SYMBOL_GPL(__put_mtd_device);
 
 int mtd_erase(struct mtd_info *mtd, struct erase_info *instr)
 {
+	ulong start_us;
+	int ret;
+
 	if (instr->addr > mtd->size || instr->len > mtd->size - instr->addr)
 		return -EINVAL;
 	if (!(mtd->flags & MTD_WRITEABLE))
@@ -917,7 +959,12 @@ int mtd_erase(struct mtd_info *mtd, struct erase_info *instr)
 		instr->state = MTD_ERASE_DONE;
 		return 0;
 	}
-	return mtd->_erase(mtd, instr);
+	start_us = mtd_stats_start();
+	ret = mtd->_erase(mtd, instr);
+	mtd_stats_add(mtd, IO_STATS_ERASE, ret ? 0 : instr->len, start_us,
+		      !ret);
+
+	return ret;
 }
 EXPORT_SYMBOL_GPL(mtd_erase);
 
@@ -975,6 +1022,7 @@ EXPORT_SYMBOL_GPL(mtd_get_unmapped_area);
 int mtd_read(struct mtd_info *mtd, loff_t from, size_t len, size_t *retlen,
 	     u_char *buf)
 {
+	ulong start_us;
 	int ret_code;
 	*retlen = 0;
 	if (from < 0 || from > mtd->size || len > mtd->size - from)
@@ -987,6 +1035,7 @@ int mtd_read(struct mtd_info *mtd, loff_t from, size_t len, size_t *retlen,
 	 * representing the maximum number of bitflips that were corrected on
 	 * any one ecc region (if applicable; zero otherwise).
 	 */
+	start_us = mtd_stats_start();
 	if (mtd->_read) {
 		ret_code = mtd->_read(mtd, from, len, retlen, buf);
 	} else if (mtd->_read_oob) {
@@ -1000,6 +1049,7 @@ int mtd_read(struct mtd_info *mtd, loff_t from, size_t len, size_t *retlen,
 	} else {
 		return -ENOTSUPP;
 	}
+	mtd_stats_add(mtd, IO_STATS_READ, *retlen, start_us, ret_code >= 0);
 
 	if (unlikely(ret_code < 0))
 		return ret_code;
@@ -1012,6 +1062,9 @@ EXPORT_SYMBOL_GPL(mtd_read);
 int mtd_write(struct mtd_info *mtd, loff_t to, size_t len, size_t *retlen,
 	      const u_char *buf)
 {
+	ulong start_us;
+	int ret;
+
 	*retlen = 0;
 	if (to < 0 || to > mtd->size || len > mtd->size - to)
 		return -EINVAL;
@@ -1021,19 +1074,21 @@ int mtd_write(struct mtd_info *mtd, loff_t to, size_t len, size_t *retlen,
 	if (!len)
 		return 0;
 
+	start_us = mtd_stats_start();
 	if (!mtd->_write) {
 		struct mtd_oob_ops ops = {
 			.len = len,
 			.datbuf = (u8 *)buf,
 		};
-		int ret;
 
 		ret = mtd->_write_oob(mtd, to, &ops);
 		*retlen = ops.retlen;
-		return ret;
+	} else {
+		ret = mtd->_write(mtd, to, len, retlen, buf);
 	}
+	mtd_stats_add(mtd, IO_STATS_WRITE, *retlen, start_us, !ret);
 
-	return mtd->_write(mtd, to, len, retlen, buf);
+	return ret;
 }
 EXPORT_SYMBOL_GPL(mtd_write);
 
@@ -1095,6 +1150,7 @@ static int mtd_check_oob_ops(struct mtd_info *mtd, loff_t offs,
 
 int mtd_read_oob(struct mtd_info *mtd, loff_t from, struct mtd_oob_ops *ops)
 {
+	ulong start_us;
 	int ret_code;
 	ops->retlen = ops->oobretlen = 0;
 
@@ -1106,11 +1162,14 @@ int mtd_read_oob(struct mtd_info *mtd, loff_t from, struct mtd_oob_ops *ops)
 	if (!mtd->_read_oob && (!mtd->_read || ops->oobbuf))
 		return -EOPNOTSUPP;
 
+	start_us = mtd_stats_start();
 	if (mtd->_read_oob)
 		ret_code = mtd->_read_oob(mtd, from, ops);
 	else
 		ret_code = mtd->_read(mtd, from, ops->len, &ops->retlen,
 				      ops->datbuf);
+	mtd_stats_add(mtd, IO_STATS_READ, ops->retlen + ops->oobretlen,
+		      start_us, ret_code >= 0);
 
 	/*
 	 * In cases where ops->datbuf != NULL, mtd->_read_oob() has semantics
@@ -1129,6 +1188,7 @@ EXPORT_SYMBOL_GPL(mtd_read_oob);
 int mtd_write_oob(struct mtd_info *mtd, loff_t to,
 				struct mtd_oob_ops *ops)
 {
+	ulong start_us;
 	int ret;
 
 	ops->retlen = ops->oobretlen = 0;
@@ -1144,11 +1204,16 @@ int mtd_write_oob(struct mtd_info *mtd, loff_t to,
 	if (!mtd->_write_oob && (!mtd->_write || ops->oobbuf))
 		return -EOPNOTSUPP;
 
+	start_us = mtd_stats_start();
 	if (mtd->_write_oob)
-		return mtd->_write_oob(mtd, to, ops);
+		ret = mtd->_write_oob(mtd, to, ops);
 	else
-		return mtd->_write(mtd, to, ops->len, &ops->retlen,
-				   ops->datbuf);
+		ret = mtd->_write(mtd, to, ops->len, &ops->retlen,
+				  ops->datbuf);
+	mtd_stats_add(mtd, IO_STATS_WRITE, ops->retlen + ops->oobretlen,
+		      start_us, !ret);
+
+	return ret;
 }
 EXPORT_SYMBOL_GPL(mtd_write_oob);
 
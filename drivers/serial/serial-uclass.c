@@ -185,14 +185,98 @@ int serial_initialize(void)
 	return serial_init();
 }
 
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+/* Send the oldest buffered character, -EAGAIN if the UART is busy */
+static int serial_tx_push(struct udevice *dev)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+	struct dm_serial_ops *ops = serial_get_ops(dev);
+	int err;
+
+	err = ops->putc(dev, upriv->tx_buf[upriv->tx_rd_ptr]);
+	if (err == -EAGAIN)
+		return err;
+
+	upriv->tx_rd_ptr++;
+	upriv->tx_rd_ptr %= CONFIG_SERIAL_TX_BUFFER_SIZE;
+
+	return 0;
+}
+
+/*
+ * Send buffered output until the buffer is empty or, unless @wait is set,
+ * the UART cannot take any more
+ */
+static void serial_tx_drain(struct udevice *dev, bool wait)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+
+	if (!upriv->tx_buf)
+		return;
+
+	while (upriv->tx_rd_ptr != upriv->tx_wr_ptr) {
+		if (serial_tx_push(dev) == -EAGAIN && !wait)
+			return;
+	}
+}
+
+static void serial_tx_queue(struct udevice *dev, char ch)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+	struct dm_serial_ops *ops = serial_get_ops(dev);
+	int next;
+
+	serial_tx_drain(dev, false);
+
+	/* Skip the buffer if it is empty and the UART has room */
+	if (upriv->tx_rd_ptr == upriv->tx_wr_ptr &&
+	    ops->putc(dev, ch) != -EAGAIN)
+		return;
+
+	/* Only wait for the UART when the buffer is full */
+	next = (upriv->tx_wr_ptr + 1) % CONFIG_SERIAL_TX_BUFFER_SIZE;
+	while (next == upriv->tx_rd_ptr)
+		serial_tx_push(dev);
+
+	upriv->tx_buf[upriv->tx_wr_ptr] = ch;
+	upriv->tx_wr_ptr = next;
+}
+
+void serial_flush(void)
+{
+	struct udevice *dev;
+	struct uclass *uc;
+
+	uclass_id_foreach_dev(UCLASS_SERIAL, dev, uc) {
+		if (device_active(dev))
+			serial_tx_drain(dev, true);
+	}
+}
+#else /* CONFIG_IS_ENABLED(SERIAL_TX_BUFFER) */
+
+static inline void serial_tx_drain(struct udevice *dev, bool wait)
+{
+}
+#endif /* CONFIG_IS_ENABLED(SERIAL_TX_BUFFER) */
+
 static void _serial_putc(struct udevice *dev, char ch)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+#endif
 	int err;
 
 	if (ch == '\n')
 		_serial_putc(dev, '\r');
 
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+	if (upriv->tx_buf) {
+		serial_tx_queue(dev, ch);
+		return;
+	}
+#endif
+
 	do {
 		err = ops->putc(dev, ch);
 	} while (err == -EAGAIN);
@@ -204,6 +288,7 @@ static void _serial_puts(struct udevice *dev, const char *str)
 	int err;
 
 	if (ops->puts) {
+		serial_tx_drain(dev, true);
 		do {
 			err = ops->puts(dev, str);
 		} while (err == -EAGAIN);
@@ -220,8 +305,10 @@ static int __serial_getc(struct udevice *dev)
 
 	do {
 		err = ops->getc(dev);
-		if (err == -EAGAIN)
+		if (err == -EAGAIN) {
 			WATCHDOG_RESET();
+			serial_tx_drain(dev, false);
+		}
 	} while (err == -EAGAIN);
 
 	return err >= 0 ? err : 0;
@@ -231,6 +318,7 @@ static int __serial_tstc(struct udevice *dev)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
 
+	serial_tx_drain(dev, false);
 	if (ops->pending)
 		return ops->pending(dev, true);
 
@@ -314,8 +402,10 @@ void serial_setbrg(void)
 		return;
 
 	ops = serial_get_ops(gd->cur_serial_dev);
-	if (ops->setbrg)
+	if (ops->setbrg) {
+		serial_tx_drain(gd->cur_serial_dev, true);
 		ops->setbrg(gd->cur_serial_dev, gd->baudrate);
+	}
 }
 
 int serial_getconfig(struct udevice *dev, uint *config)
@@ -502,6 +592,10 @@ static int serial_post_probe(struct udevice *dev)
 	/* Allocate the RX buffer */
 	upriv->buf = malloc(CONFIG_SERIAL_RX_BUFFER_SIZE);
 #endif
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+	/* Allocate the TX buffer; without one output is not buffered */
+	upriv->tx_buf = malloc(CONFIG_SERIAL_TX_BUFFER_SIZE);
+#endif
 
 	stdio_register_dev(&sdev, &upriv->sdev);
 #endif
@@ -512,7 +606,10 @@ static int serial_pre_remove(struct udevice *dev)
 {
 #if CONFIG_IS_ENABLED(SYS_STDIO_DEREGISTER)
 	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+#endif
 
+	serial_tx_drain(dev, true);
+#if CONFIG_IS_ENABLED(SYS_STDIO_DEREGISTER)
 	if (stdio_deregister_dev(upriv->sdev, true))
 		return -EPERM;
 #endif
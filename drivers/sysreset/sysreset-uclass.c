@@ -14,6 +14,7 @@
 #include <hang.h>
 #include <log.h>
 #include <regmap.h>
+#include <serial.h>
 #include <spl.h>
 #include <sysreset.h>
 #include <dm/device-internal.h>
@@ -132,6 +133,7 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 	}
 
 	printf("resetting ...\n");
+	serial_flush();
 	mdelay(100);
 
 	sysreset_walk_halt(reset_type);
@@ -692,28 +692,36 @@ static int sandbox_tpm2_xfer(struct udevice *dev, const u8 *sendbuf,
 			printf("Invalid index %d, sandbox TPM handles up to %d PCR(s)\n",
 			       pcr_index, SANDBOX_TPM_PCR_NB);
 			rc = TPM2_RC_VALUE;
+			return sandbox_tpm2_fill_buf(recv, recv_len, tag, rc);
 		}
 
 		/* Check the number of hashes */
 		pcr_nb = get_unaligned_be32(sent);
 		sent += sizeof(pcr_nb);
-		if (pcr_nb != 1) {
-			printf("Sandbox cannot handle more than one PCR\n");
+		if (!pcr_nb) {
+			printf("No hash to extend the PCR with\n");
 			rc = TPM2_RC_VALUE;
 			return sandbox_tpm2_fill_buf(recv, recv_len, tag, rc);
 		}
 
-		/* Check the hash algorithm */
-		alg = get_unaligned_be16(sent);
-		sent += sizeof(alg);
-		if (alg != TPM2_ALG_SHA256) {
-			printf("Sandbox TPM only handle SHA256 algorithm\n");
-			rc = TPM2_RC_VALUE;
-			return sandbox_tpm2_fill_buf(recv, recv_len, tag, rc);
-		}
+		/* There is only a SHA256 bank, extend it with each hash */
+		for (i = 0; i < pcr_nb; i++) {
+			/* Check the hash algorithm */
+			alg = get_unaligned_be16(sent);
+			sent += sizeof(alg);
+			if (alg != TPM2_ALG_SHA256) {
+				printf("Sandbox TPM only handle SHA256 algorithm\n");
+				rc = TPM2_RC_VALUE;
+				return sandbox_tpm2_fill_buf(recv, recv_len,
+							     tag, rc);
+			}
 
-		/* Extend the PCR */
-		rc = sandbox_tpm2_extend(dev, pcr_index, sent);
+			/* Extend the PCR */
+			rc = sandbox_tpm2_extend(dev, pcr_index, sent);
+			if (rc)
+				break;
+			sent += TPM2_DIGEST_LEN;
+		}
 
 		sandbox_tpm2_fill_buf(recv, recv_len, tag, rc);
 		break;
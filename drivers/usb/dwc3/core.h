@@ -545,6 +545,8 @@ enum dwc3_link_state {
 
 /* TRB Length, PCM and Status */
 #define DWC3_TRB_SIZE_MASK	(0x00ffffff)
+/* Largest length per TRB that is a multiple of every maxpacket size */
+#define DWC3_TRB_MAX_LENGTH	(0x00ff0000)
 #define DWC3_TRB_SIZE_LENGTH(n)	((n) & DWC3_TRB_SIZE_MASK)
 #define DWC3_TRB_SIZE_PCM1(n)	(((n) & 0x03) << 24)
 #define DWC3_TRB_SIZE_TRBSTS(n)	(((n) & (0x0f << 28)) >> 28)
@@ -635,6 +637,8 @@ struct dwc3_request {
 	struct list_head	list;
 	struct dwc3_ep		*dep;
 	u32			start_slot;
+	u32			num_trbs;
+	u32			remaining;
 
 	u8			epnum;
 	struct dwc3_trb		*trb;
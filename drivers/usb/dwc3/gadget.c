@@ -233,7 +233,7 @@ void dwc3_gadget_giveback(struct dwc3_ep *dep, struct dwc3_request *req,
 	struct dwc3			*dwc = dep->dwc;
 
 	if (req->queued) {
-		dep->busy_slot++;
+		dep->busy_slot += req->num_trbs;
 		/*
 		 * Skip LINK TRB. We can't use req->trb and check for
 		 * DWC3_TRBCTL_LINK_TRB because it points the TRB we
@@ -723,6 +723,7 @@ static void dwc3_prepare_one_trb(struct dwc3_ep *dep,
 		req->start_slot = dep->free_slot & DWC3_TRB_MASK;
 	}
 
+	req->num_trbs++;
 	dep->free_slot++;
 	/* Skip the LINK-TRB on ISOC */
 	if (((dep->free_slot & DWC3_TRB_MASK) == DWC3_TRB_NUM - 1) &&
@@ -767,9 +768,18 @@ static void dwc3_prepare_one_trb(struct dwc3_ep *dep,
 		trb->ctrl |= DWC3_TRB_CTRL_LST;
 	}
 
-	if (chain)
+	if (chain) {
 		trb->ctrl |= DWC3_TRB_CTRL_CHN;
 
+		/*
+		 * A short packet in the middle of an OUT chain ends the
+		 * transfer: raise an event and skip the rest of the chain,
+		 * as Linux does, rather than waiting for more data.
+		 */
+		if (!dep->direction)
+			trb->ctrl |= DWC3_TRB_CTRL_ISP_IMI | DWC3_TRB_CTRL_CSP;
+	}
+
 	if (usb_endpoint_xfer_bulk(dep->endpoint.desc) && dep->stream_capable)
 		trb->ctrl |= DWC3_TRB_CTRL_SID_SOFN(req->request.stream_id);
 
@@ -846,6 +856,18 @@ static void dwc3_prepare_trbs(struct dwc3_ep *dep, bool starting)
 		dma = req->request.dma;
 		length = req->request.length;
 
+		/*
+		 * Requests longer than one TRB can hold are split into a
+		 * chain, so that a single transfer can move the whole buffer.
+		 */
+		while (length > DWC3_TRB_MAX_LENGTH && trbs_left > 1) {
+			dwc3_prepare_one_trb(dep, req, dma, DWC3_TRB_MAX_LENGTH,
+					     false, true, 0);
+			dma += DWC3_TRB_MAX_LENGTH;
+			length -= DWC3_TRB_MAX_LENGTH;
+			trbs_left--;
+		}
+
 		dwc3_prepare_one_trb(dep, req, dma, length,
 				     true, false, 0);
 
@@ -966,6 +988,12 @@ static int __dwc3_gadget_ep_queue(struct dwc3_ep *dep, struct dwc3_request *req)
 	req->request.status	= -EINPROGRESS;
 	req->direction		= dep->direction;
 	req->epnum		= dep->number;
+	req->num_trbs		= 0;
+
+	/* A request must fit into one chain of TRBs */
+	if (req->request.length > DWC3_TRB_NUM * DWC3_TRB_MAX_LENGTH &&
+	    !usb_endpoint_xfer_isoc(dep->endpoint.desc))
+		return -EINVAL;
 
 	/*
 	 * DWC3 hangs on OUT requests smaller than maxpacket size,
@@ -1746,7 +1774,7 @@ static int __dwc3_cleanup_done_trbs(struct dwc3 *dwc, struct dwc3_ep *dep,
 	 * should receive and we simply bounce the request back to the
 	 * gadget driver for further processing.
 	 */
-	req->request.actual += req->request.length - count;
+	req->remaining += count;
 	if (s_pkt)
 		return 1;
 	if ((event->status & DEPEVT_STATUS_LST) &&
@@ -1765,6 +1793,9 @@ static int dwc3_cleanup_done_reqs(struct dwc3 *dwc, struct dwc3_ep *dep,
 	struct dwc3_request	*req;
 	struct dwc3_trb		*trb;
 	unsigned int		slot;
+	unsigned int		i;
+	bool			skipped = false;
+	int			done = 0;
 
 	req = next_request(&dep->req_queued);
 	if (!req) {
@@ -1776,11 +1807,35 @@ static int dwc3_cleanup_done_reqs(struct dwc3 *dwc, struct dwc3_ep *dep,
 	if ((slot == DWC3_TRB_NUM - 1) &&
 	    usb_endpoint_xfer_isoc(dep->endpoint.desc))
 		slot++;
-	slot %= DWC3_TRB_NUM;
-	trb = &dep->trb_pool[slot];
 
-	dwc3_flush_cache((uintptr_t)trb, sizeof(*trb));
-	__dwc3_cleanup_done_trbs(dwc, dep, req, trb, event, status);
+	req->remaining = 0;
+	for (i = 0; i < req->num_trbs; i++) {
+		trb = &dep->trb_pool[(slot + i) % DWC3_TRB_NUM];
+		dwc3_flush_cache((uintptr_t)trb, sizeof(*trb));
+
+		/*
+		 * After a short packet the core skips the rest of the chain
+		 * without handing its TRBs back, so clear HWO here
+		 */
+		if (done) {
+			req->remaining += trb->size & DWC3_TRB_SIZE_MASK;
+			trb->ctrl &= ~DWC3_TRB_CTRL_HWO;
+			dwc3_flush_cache((uintptr_t)trb, sizeof(*trb));
+			skipped = true;
+			continue;
+		}
+		done = __dwc3_cleanup_done_trbs(dwc, dep, req, trb, event,
+						status);
+	}
+
+	/*
+	 * The skipped TRBs include the one with LST set, so the transfer is
+	 * still active. End it so that the next request can start a new one.
+	 */
+	if (skipped && !usb_endpoint_xfer_isoc(dep->endpoint.desc))
+		dwc3_stop_active_transfer(dwc, dep->number, true);
+
+	req->request.actual += req->request.length - req->remaining;
 	dwc3_gadget_giveback(dep, req, status);
 
 	if (usb_endpoint_xfer_isoc(dep->endpoint.desc) &&
@@ -1816,6 +1871,15 @@ static void dwc3_endpoint_transfer_complete(struct dwc3 *dwc,
 	if (clean_busy)
 		dep->flags &= ~DWC3_EP_BUSY;
 
+	/*
+	 * Start the next request right away if the gadget driver has
+	 * already queued one, rather than waiting for the host to be NAKed
+	 * and the core to report XferNotReady.
+	 */
+	if (clean_busy && !usb_endpoint_xfer_isoc(dep->endpoint.desc) &&
+	    !list_empty(&dep->request_list))
+		__dwc3_gadget_kick_transfer(dep, 0, 1);
+
 	/*
 	 * WORKAROUND: This is the 2nd half of U1/U2 -> U0 workaround.
 	 * See dwc3_gadget_linksts_change_interrupt() for 1st half.
@@ -53,6 +53,11 @@ struct f_fastboot {
 	struct usb_ep *in_ep, *out_ep;
 	struct usb_request *in_req, *out_req;
 
+	/* Download requests, queued together on out_ep */
+	struct usb_request *dl_req[CONFIG_FASTBOOT_USB_DL_REQS];
+	/* Bytes requested by download requests which have not completed */
+	unsigned int dl_pending;
+
 	usb_req *front, *rear;
 };
 
@@ -207,6 +212,7 @@ extern struct stdio_dev g_fastboot_stdio;
 #endif
 
 static void rx_handler_command(struct usb_ep *ep, struct usb_request *req);
+static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req);
 
 static void fastboot_fifo_complete(struct usb_ep *ep, struct usb_request *req)
 {
@@ -321,10 +327,19 @@ static void fastboot_unbind(struct usb_configuration *c, struct usb_function *f)
 static void fastboot_disable(struct usb_function *f)
 {
 	struct f_fastboot *f_fb = func_to_fastboot(f);
+	int i;
 
 	usb_ep_disable(f_fb->out_ep);
 	usb_ep_disable(f_fb->in_ep);
 
+	for (i = 0; i < CONFIG_FASTBOOT_USB_DL_REQS; i++) {
+		if (!f_fb->dl_req[i])
+			continue;
+		free(f_fb->dl_req[i]->buf);
+		usb_ep_free_request(f_fb->out_ep, f_fb->dl_req[i]);
+		f_fb->dl_req[i] = NULL;
+	}
+
 	if (f_fb->out_req) {
 		free(f_fb->out_req->buf);
 		usb_ep_free_request(f_fb->out_ep, f_fb->out_req);
@@ -337,7 +352,8 @@ static void fastboot_disable(struct usb_function *f)
 	}
 }
 
-static struct usb_request *fastboot_start_ep(struct usb_ep *ep)
+static struct usb_request *fastboot_start_ep(struct usb_ep *ep,
+					     unsigned int size)
 {
 	struct usb_request *req;
 
@@ -345,8 +361,8 @@ static struct usb_request *fastboot_start_ep(struct usb_ep *ep)
 	if (!req)
 		return NULL;
 
-	req->length = EP_BUFFER_SIZE;
-	req->buf = memalign(CONFIG_SYS_CACHELINE_SIZE, EP_BUFFER_SIZE);
+	req->length = size;
+	req->buf = memalign(CONFIG_SYS_CACHELINE_SIZE, size);
 	if (!req->buf) {
 		usb_ep_free_request(ep, req);
 		return NULL;
@@ -364,6 +380,7 @@ static int fastboot_set_alt(struct usb_function *f,
 	struct usb_gadget *gadget = cdev->gadget;
 	struct f_fastboot *f_fb = func_to_fastboot(f);
 	const struct usb_endpoint_descriptor *d;
+	int i;
 
 	debug("%s: func: %s intf: %d alt: %d\n",
 	      __func__, f->name, interface, alt);
@@ -375,7 +392,7 @@ static int fastboot_set_alt(struct usb_function *f,
 		return ret;
 	}
 
-	f_fb->out_req = fastboot_start_ep(f_fb->out_ep);
+	f_fb->out_req = fastboot_start_ep(f_fb->out_ep, EP_BUFFER_SIZE);
 	if (!f_fb->out_req) {
 		puts("failed to alloc out req\n");
 		ret = -EINVAL;
@@ -383,6 +400,17 @@ static int fastboot_set_alt(struct usb_function *f,
 	}
 	f_fb->out_req->complete = rx_handler_command;
 
+	for (i = 0; i < CONFIG_FASTBOOT_USB_DL_REQS; i++) {
+		f_fb->dl_req[i] = fastboot_start_ep(f_fb->out_ep,
+					CONFIG_FASTBOOT_USB_DL_BUF_SIZE);
+		if (!f_fb->dl_req[i]) {
+			puts("failed to alloc download req\n");
+			ret = -EINVAL;
+			goto err;
+		}
+		f_fb->dl_req[i]->complete = rx_handler_dl_image;
+	}
+
 	d = fb_ep_desc(gadget, &fs_ep_in, &hs_ep_in, &ss_ep_in);
 	ret = usb_ep_enable(f_fb->in_ep, d);
 	if (ret) {
@@ -390,7 +418,7 @@ static int fastboot_set_alt(struct usb_function *f,
 		goto err;
 	}
 
-	f_fb->in_req = fastboot_start_ep(f_fb->in_ep);
+	f_fb->in_req = fastboot_start_ep(f_fb->in_ep, EP_BUFFER_SIZE);
 	if (!f_fb->in_req) {
 		puts("failed alloc req in\n");
 		ret = -EINVAL;
@@ -463,7 +491,7 @@ int fastboot_tx_write_more(const char *buffer)
 	}
 
 	/* alloc in request for current node */
-	req->in_req = fastboot_start_ep(fastboot_func->in_ep);
+	req->in_req = fastboot_start_ep(fastboot_func->in_ep, EP_BUFFER_SIZE);
 	if (!req->in_req) {
 		printf("failed alloc req in\n");
 		fastboot_disable(&(fastboot_func->usb_function));
@@ -523,14 +551,14 @@ static void compl_do_reset(struct usb_ep *ep, struct usb_request *req)
 
 static unsigned int rx_bytes_expected(struct usb_ep *ep)
 {
-	int rx_remain = fastboot_data_remaining();
+	int rx_remain = fastboot_data_remaining() - fastboot_func->dl_pending;
 	unsigned int rem;
 	unsigned int maxpacket = usb_endpoint_maxp(ep->desc);
 
 	if (rx_remain <= 0)
 		return 0;
-	else if (rx_remain > EP_BUFFER_SIZE)
-		return EP_BUFFER_SIZE;
+	else if (rx_remain > CONFIG_FASTBOOT_USB_DL_BUF_SIZE)
+		return CONFIG_FASTBOOT_USB_DL_BUF_SIZE;
 
 	/*
 	 * Some controllers e.g. DWC3 don't like OUT transfers to be
@@ -545,6 +573,35 @@ static unsigned int rx_bytes_expected(struct usb_ep *ep)
 	return rx_remain;
 }
 
+/* Queue @req for the next part of the download, if there is any left */
+static int fastboot_dl_queue(struct usb_ep *ep, struct usb_request *req)
+{
+	int ret;
+
+	req->length = rx_bytes_expected(ep);
+	if (!req->length)
+		return -ENODATA;
+
+	req->actual = 0;
+	ret = usb_ep_queue(ep, req, 0);
+	if (!ret)
+		fastboot_func->dl_pending += req->length;
+
+	return ret;
+}
+
+/* Fill the endpoint with download requests, the rest follow on completion */
+static void fastboot_dl_start(struct usb_ep *ep)
+{
+	int i;
+
+	fastboot_func->dl_pending = 0;
+	for (i = 0; i < CONFIG_FASTBOOT_USB_DL_REQS; i++) {
+		if (fastboot_dl_queue(ep, fastboot_func->dl_req[i]))
+			break;
+	}
+}
+
 static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 {
 	char response[FASTBOOT_RESPONSE_LEN] = {0};
@@ -557,6 +614,7 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 		return;
 	}
 
+	fastboot_func->dl_pending -= req->length;
 	if (buffer_size < transfer_size)
 		transfer_size = buffer_size;
 
@@ -565,20 +623,15 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 		fastboot_tx_write_str(response);
 	} else if (!fastboot_data_remaining()) {
 		fastboot_data_complete(response);
-
-		/*
-		 * Reset global transfer variable
-		 */
-		req->complete = rx_handler_command;
-		req->length = EP_BUFFER_SIZE;
-
 		fastboot_tx_write_str(response);
-	} else {
-		req->length = rx_bytes_expected(ep);
+
+		/* Go back to waiting for commands */
+		fastboot_func->out_req->actual = 0;
+		usb_ep_queue(ep, fastboot_func->out_req, 0);
+		return;
 	}
 
-	req->actual = 0;
-	usb_ep_queue(ep, req, 0);
+	fastboot_dl_queue(ep, req);
 }
 
 static void do_exit_on_complete(struct usb_ep *ep, struct usb_request *req)
@@ -625,11 +678,6 @@ static void rx_handler_command(struct usb_ep *ep, struct usb_request *req)
 		fastboot_fail("buffer overflow", response);
 	}
 
-	if (!strncmp("DATA", response, 4)) {
-		req->complete = rx_handler_dl_image;
-		req->length = rx_bytes_expected(ep);
-	}
-
 	if (!strncmp("OKAY", response, 4)) {
 		switch (cmd) {
 		case FASTBOOT_COMMAND_BOOT:
@@ -661,5 +709,8 @@ static void rx_handler_command(struct usb_ep *ep, struct usb_request *req)
 
 	*cmdbuf = '\0';
 	req->actual = 0;
-	usb_ep_queue(ep, req, 0);
+	if (!strncmp("DATA", response, 4) && fastboot_data_remaining())
+		fastboot_dl_start(ep);
+	else
+		usb_ep_queue(ep, req, 0);
 }
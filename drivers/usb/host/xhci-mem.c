@@ -22,6 +22,7 @@
 #include <malloc.h>
 #include <asm/cache.h>
 #include <linux/bug.h>
+#include <linux/dma-mapping.h>
 #include <linux/errno.h>
 
 #include <usb/xhci.h>
@@ -38,6 +39,9 @@ void xhci_flush_cache(uintptr_t addr, u32 len)
 {
 	BUG_ON((void *)addr == NULL || len == 0);
 
+	if (dma_is_uncached((void *)addr))
+		return;
+
 	flush_dcache_range(addr & ~(CACHELINE_SIZE - 1),
 				ALIGN(addr + len, CACHELINE_SIZE));
 }
@@ -53,11 +57,25 @@ void xhci_inval_cache(uintptr_t addr, u32 len)
 {
 	BUG_ON((void *)addr == NULL || len == 0);
 
+	if (dma_is_uncached((void *)addr))
+		return;
+
 	invalidate_dcache_range(addr & ~(CACHELINE_SIZE - 1),
 				ALIGN(addr + len, CACHELINE_SIZE));
 }
 
 
+/**
+ * frees memory allocated by xhci_malloc()
+ *
+ * @param ptr	pointer to the memory to be freed
+ * Return: none
+ */
+static void xhci_free(void *ptr)
+{
+	dma_free_uncached(ptr);
+}
+
 /**
  * frees the "segment" pointer passed
  *
@@ -66,7 +84,7 @@ void xhci_inval_cache(uintptr_t addr, u32 len)
  */
 static void xhci_segment_free(struct xhci_segment *seg)
 {
-	free(seg->trbs);
+	xhci_free(seg->trbs);
 	seg->trbs = NULL;
 
 	free(seg);
@@ -111,7 +129,7 @@ static void xhci_scratchpad_free(struct xhci_ctrl *ctrl)
 	ctrl->dcbaa->dev_context_ptrs[0] = 0;
 
 	free(xhci_bus_to_virt(ctrl, le64_to_cpu(ctrl->scratchpad->sp_array[0])));
-	free(ctrl->scratchpad->sp_array);
+	xhci_free(ctrl->scratchpad->sp_array);
 	free(ctrl->scratchpad);
 	ctrl->scratchpad = NULL;
 }
@@ -124,7 +142,7 @@ static void xhci_scratchpad_free(struct xhci_ctrl *ctrl)
  */
 static void xhci_free_container_ctx(struct xhci_container_ctx *ctx)
 {
-	free(ctx->bytes);
+	xhci_free(ctx->bytes);
 	free(ctx);
 }
 
@@ -151,9 +169,11 @@ static void xhci_free_virt_devices(struct xhci_ctrl *ctrl)
 
 		ctrl->dcbaa->dev_context_ptrs[slot_id] = 0;
 
-		for (i = 0; i < 31; ++i)
+		for (i = 0; i < 31; ++i) {
 			if (virt_dev->eps[i].ring)
 				xhci_ring_free(virt_dev->eps[i].ring);
+			xhci_free_stream_rings(&virt_dev->eps[i]);
+		}
 
 		if (virt_dev->in_ctx)
 			xhci_free_container_ctx(virt_dev->in_ctx);
@@ -178,8 +198,8 @@ void xhci_cleanup(struct xhci_ctrl *ctrl)
 	xhci_ring_free(ctrl->cmd_ring);
 	xhci_scratchpad_free(ctrl);
 	xhci_free_virt_devices(ctrl);
-	free(ctrl->erst.entries);
-	free(ctrl->dcbaa);
+	xhci_free(ctrl->erst.entries);
+	xhci_free(ctrl->dcbaa);
 	memset(ctrl, '\0', sizeof(struct xhci_ctrl));
 }
 
@@ -193,6 +213,15 @@ static void *xhci_malloc(unsigned int size)
 {
 	void *ptr;
 	size_t cacheline_size = max(XHCI_ALIGNMENT, CACHELINE_SIZE);
+	dma_addr_t handle;
+
+	/* Rings and contexts need no cache maintenance if non-cached */
+	if (ARCH_DMA_MINALIGN >= cacheline_size) {
+		ptr = dma_alloc_uncached(size, &handle);
+		BUG_ON(!ptr);
+
+		return ptr;
+	}
 
 	ptr = memalign(cacheline_size, ALIGN(size, cacheline_size));
 	BUG_ON(!ptr);
@@ -342,6 +371,72 @@ struct xhci_ring *xhci_ring_alloc(struct xhci_ctrl *ctrl, unsigned int num_segs,
 	return ring;
 }
 
+/**
+ * Allocate the stream context array and the stream rings of an endpoint.
+ * Any streams the endpoint had before are freed.
+ *
+ * @param ctrl		Host controller data structure
+ * @param ep		endpoint to allocate the streams for
+ * @param num_streams	number of entries in the stream context array,
+ *			including the reserved stream ID 0. This must be a
+ *			power of two.
+ * Return: 0 if OK, -ENOMEM if out of memory
+ */
+int xhci_alloc_stream_rings(struct xhci_ctrl *ctrl, struct xhci_virt_ep *ep,
+			    unsigned int num_streams)
+{
+	struct xhci_ring *ring;
+	unsigned int i;
+	u64 val_64;
+
+	xhci_free_stream_rings(ep);
+
+	ep->stream_rings = calloc(num_streams, sizeof(struct xhci_ring *));
+	if (!ep->stream_rings)
+		return -ENOMEM;
+	ep->stream_ctx = xhci_malloc(num_streams *
+				     sizeof(struct xhci_stream_ctx));
+
+	/* Stream ID 0 is reserved, so its context is left empty */
+	for (i = 1; i < num_streams; i++) {
+		ring = xhci_ring_alloc(ctrl, 1, true);
+		ep->stream_rings[i] = ring;
+
+		val_64 = xhci_virt_to_bus(ctrl, ring->enqueue);
+		ep->stream_ctx[i].stream_ring = cpu_to_le64(val_64 |
+				SCT_FOR_CTX(SCT_PRI_TR) | ring->cycle_state);
+	}
+	ep->num_streams = num_streams;
+
+	xhci_flush_cache((uintptr_t)ep->stream_ctx,
+			 num_streams * sizeof(struct xhci_stream_ctx));
+
+	return 0;
+}
+
+/**
+ * Free the stream context array and the stream rings of an endpoint
+ *
+ * @param ep	endpoint whose streams are freed
+ * Return: none
+ */
+void xhci_free_stream_rings(struct xhci_virt_ep *ep)
+{
+	unsigned int i;
+
+	if (ep->stream_rings) {
+		for (i = 1; i < ep->num_streams; i++)
+			if (ep->stream_rings[i])
+				xhci_ring_free(ep->stream_rings[i]);
+		free(ep->stream_rings);
+	}
+	xhci_free(ep->stream_ctx);
+
+	ep->stream_rings = NULL;
+	ep->stream_ctx = NULL;
+	ep->num_streams = 0;
+}
+
 /**
  * Set up the scratchpad buffer array and scratchpad buffers
  *
@@ -404,7 +499,7 @@ static int xhci_scratchpad_alloc(struct xhci_ctrl *ctrl)
 	return 0;
 
 fail_sp3:
-	free(scratchpad->sp_array);
+	xhci_free(scratchpad->sp_array);
 
 fail_sp2:
 	free(scratchpad);
@@ -20,6 +20,7 @@
 #include <usb.h>
 #include <asm/unaligned.h>
 #include <linux/bug.h>
+#include <linux/dma-mapping.h>
 #include <linux/errno.h>
 
 #include <usb/xhci.h>
@@ -261,18 +262,19 @@ static int prepare_ring(struct xhci_ctrl *ctrl, struct xhci_ring *ep_ring,
 }
 
 /**
- * Generic function for queueing a command TRB on the command ring.
+ * Queues a command TRB on the command ring, for a stream of an endpoint.
  * Check to make sure there's room on the command ring for one command TRB.
  *
  * @param ctrl		Host controller data structure
  * @param ptr		Pointer address to write in the first two fields (opt.)
  * @param slot_id	Slot ID to encode in the flags field (opt.)
  * @param ep_index	Endpoint index to encode in the flags field (opt.)
+ * @param stream_id	Stream ID to encode in the status field (opt.)
  * @param cmd		Command type to enqueue
  * Return: none
  */
-void xhci_queue_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
-			u32 ep_index, trb_type cmd)
+static void queue_stream_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
+				 u32 ep_index, u32 stream_id, trb_type cmd)
 {
 	u32 fields[4];
 	u64 val_64 = 0;
@@ -284,7 +286,7 @@ void xhci_queue_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
 
 	fields[0] = lower_32_bits(val_64);
 	fields[1] = upper_32_bits(val_64);
-	fields[2] = 0;
+	fields[2] = STREAM_ID_FOR_TRB(stream_id);
 	fields[3] = TRB_TYPE(cmd) | SLOT_ID_FOR_TRB(slot_id) |
 		    ctrl->cmd_ring->cycle_state;
 
@@ -301,6 +303,23 @@ void xhci_queue_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
 	xhci_writel(&ctrl->dba->doorbell[0], DB_VALUE_HOST);
 }
 
+/**
+ * Generic function for queueing a command TRB on the command ring.
+ * Check to make sure there's room on the command ring for one command TRB.
+ *
+ * @param ctrl		Host controller data structure
+ * @param ptr		Pointer address to write in the first two fields (opt.)
+ * @param slot_id	Slot ID to encode in the flags field (opt.)
+ * @param ep_index	Endpoint index to encode in the flags field (opt.)
+ * @param cmd		Command type to enqueue
+ * Return: none
+ */
+void xhci_queue_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
+			u32 ep_index, trb_type cmd)
+{
+	queue_stream_command(ctrl, ptr, slot_id, ep_index, 0, cmd);
+}
+
 /*
  * For xHCI 1.0 host controllers, TD size is the number of max packet sized
  * packets remaining in the TD (*not* including this TRB).
@@ -359,12 +378,13 @@ static u32 xhci_td_remainder(struct xhci_ctrl *ctrl, int transferred,
  *
  * @param udev		pointer to the USB device structure
  * @param ep_index	index of the endpoint
+ * @param stream_id	stream ID of the ring, 0 if not using streams
  * @param start_cycle	cycle flag of the first TRB
  * @param start_trb	pionter to the first TRB
  * Return: none
  */
 static void giveback_first_trb(struct usb_device *udev, int ep_index,
-				int start_cycle,
+				unsigned int stream_id, int start_cycle,
 				struct xhci_generic_trb *start_trb)
 {
 	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
@@ -382,7 +402,7 @@ static void giveback_first_trb(struct usb_device *udev, int ep_index,
 
 	/* Ringing EP doorbell here */
 	xhci_writel(&ctrl->dba->doorbell[udev->slot_id],
-				DB_VALUE(ep_index, 0));
+				DB_VALUE(ep_index, stream_id));
 
 	return;
 }
@@ -463,6 +483,17 @@ union xhci_trb *xhci_wait_for_event(struct xhci_ctrl *ctrl, trb_type expected)
 			BUG_ON(GET_COMP_CODE(
 				le32_to_cpu(event->generic.field[2])) !=
 								COMP_SUCCESS);
+		else if (type == TRB_TRANSFER &&
+			 (GET_COMP_CODE(le32_to_cpu(
+				event->trans_event.transfer_len)) == COMP_STOP ||
+			  GET_COMP_CODE(le32_to_cpu(
+				event->trans_event.transfer_len)) ==
+								COMP_STOP_INVAL))
+			/*
+			 * Stopping an endpoint reports where it stopped; its
+			 * TDs resume from there when it is restarted
+			 */
+			debug("XHCI endpoint stopped, skipping event\n");
 		else
 			printf("Unexpected XHCI event TRB, skipping... "
 				"(%08x %08x %08x %08x)\n",
@@ -481,6 +512,49 @@ union xhci_trb *xhci_wait_for_event(struct xhci_ctrl *ctrl, trb_type expected)
 	BUG();
 }
 
+/*
+ * Sets the xHC's dequeue pointer of one ring of a stopped or halted endpoint
+ * to our enqueue pointer, throwing away all unprocessed TRBs on it.
+ */
+static void set_stream_tr_deq(struct usb_device *udev, int ep_index,
+			      unsigned int stream_id)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	struct xhci_virt_ep *ep = &ctrl->devs[udev->slot_id]->eps[ep_index];
+	struct xhci_ring *ring = xhci_ep_ring(ep, stream_id);
+	union xhci_trb *event;
+	uintptr_t deq;
+
+	deq = (uintptr_t)ring->enqueue | ring->cycle_state;
+	if (ep->num_streams)
+		deq |= SCT_FOR_CTX(SCT_PRI_TR);
+	queue_stream_command(ctrl, (void *)deq, udev->slot_id, ep_index,
+			     stream_id, TRB_SET_DEQ);
+	event = xhci_wait_for_event(ctrl, TRB_COMPLETION);
+	BUG_ON(TRB_TO_SLOT_ID(le32_to_cpu(event->event_cmd.flags))
+		!= udev->slot_id || GET_COMP_CODE(le32_to_cpu(
+		event->event_cmd.status)) != COMP_SUCCESS);
+	xhci_acknowledge_event(ctrl);
+}
+
+/*
+ * Sets the xHC's dequeue pointer(s) of a stopped or halted endpoint to our
+ * enqueue pointer(s), throwing away all unprocessed TRBs. For an endpoint
+ * using streams, this is done for each of its stream rings.
+ */
+static void set_tr_deq(struct usb_device *udev, int ep_index)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	struct xhci_virt_ep *ep = &ctrl->devs[udev->slot_id]->eps[ep_index];
+	unsigned int stream_id, last_stream;
+
+	/* Stream ID 0 is reserved if the endpoint uses streams */
+	stream_id = ep->num_streams ? 1 : 0;
+	last_stream = ep->num_streams ? ep->num_streams - 1 : 0;
+	for (; stream_id <= last_stream; stream_id++)
+		set_stream_tr_deq(udev, ep_index, stream_id);
+}
+
 /*
  * Send reset endpoint command for given endpoint. This recovers from a
  * halted endpoint (e.g. due to a stall error).
@@ -488,7 +562,6 @@ union xhci_trb *xhci_wait_for_event(struct xhci_ctrl *ctrl, trb_type expected)
 static void reset_ep(struct usb_device *udev, int ep_index)
 {
 	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
-	struct xhci_ring *ring =  ctrl->devs[udev->slot_id]->eps[ep_index].ring;
 	union xhci_trb *event;
 	u32 field;
 
@@ -499,13 +572,7 @@ static void reset_ep(struct usb_device *udev, int ep_index)
 	BUG_ON(TRB_TO_SLOT_ID(field) != udev->slot_id);
 	xhci_acknowledge_event(ctrl);
 
-	xhci_queue_command(ctrl, (void *)((uintptr_t)ring->enqueue |
-		ring->cycle_state), udev->slot_id, ep_index, TRB_SET_DEQ);
-	event = xhci_wait_for_event(ctrl, TRB_COMPLETION);
-	BUG_ON(TRB_TO_SLOT_ID(le32_to_cpu(event->event_cmd.flags))
-		!= udev->slot_id || GET_COMP_CODE(le32_to_cpu(
-		event->event_cmd.status)) != COMP_SUCCESS);
-	xhci_acknowledge_event(ctrl);
+	set_tr_deq(udev, ep_index);
 }
 
 /*
@@ -519,7 +586,6 @@ static void reset_ep(struct usb_device *udev, int ep_index)
 static void abort_td(struct usb_device *udev, int ep_index)
 {
 	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
-	struct xhci_ring *ring =  ctrl->devs[udev->slot_id]->eps[ep_index].ring;
 	union xhci_trb *event;
 	u32 field;
 
@@ -539,13 +605,28 @@ static void abort_td(struct usb_device *udev, int ep_index)
 		event->event_cmd.status)) != COMP_SUCCESS);
 	xhci_acknowledge_event(ctrl);
 
-	xhci_queue_command(ctrl, (void *)((uintptr_t)ring->enqueue |
-		ring->cycle_state), udev->slot_id, ep_index, TRB_SET_DEQ);
+	set_tr_deq(udev, ep_index);
+}
+
+/*
+ * Throws away the TDs queued on one stream of an endpoint, leaving its other
+ * streams alone. The endpoint is stopped for this, so the caller needs to
+ * ring the doorbell again for any streams which still have TDs pending.
+ */
+static void abort_stream_td(struct usb_device *udev, int ep_index,
+			    unsigned int stream_id)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	union xhci_trb *event;
+
+	xhci_queue_command(ctrl, NULL, udev->slot_id, ep_index, TRB_STOP_RING);
 	event = xhci_wait_for_event(ctrl, TRB_COMPLETION);
 	BUG_ON(TRB_TO_SLOT_ID(le32_to_cpu(event->event_cmd.flags))
 		!= udev->slot_id || GET_COMP_CODE(le32_to_cpu(
 		event->event_cmd.status)) != COMP_SUCCESS);
 	xhci_acknowledge_event(ctrl);
+
+	set_stream_tr_deq(udev, ep_index, stream_id);
 }
 
 static void record_transfer_result(struct usb_device *udev,
@@ -577,31 +658,83 @@ static void record_transfer_result(struct usb_device *udev,
 }
 
 /**** Bulk and Control transfer methods ****/
+
+/*
+ * Number of TRBs which may be queued on a transfer ring at once: the ring
+ * consists of a single segment whose last TRB is the link TRB.
+ */
+#define XHCI_BULK_RING_TRBS	(TRBS_PER_SEGMENT - 1)
+
 /**
- * Queues up the BULK Request
+ * Calculates the number of TRBs needed for a BULK transfer
  *
- * @param udev		pointer to the USB device structure
- * @param pipe		contains the DIR_IN or OUT , devnum
+ * @param ctrl		Host controller data structure
+ * @param buffer	buffer to be read/written
  * @param length	length of the buffer
- * @param buffer	buffer to be read/written based on the request
- * Return: returns 0 if successful else -1 on failure
+ * Return: number of TRBs
  */
-int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
-			int length, void *buffer)
+static int xhci_bulk_num_trbs(struct xhci_ctrl *ctrl, void *buffer,
+			      int length)
 {
+	u64 val_64 = xhci_virt_to_bus(ctrl, buffer);
+	int running_total;
 	int num_trbs = 0;
+
+	/*
+	 * How much data is (potentially) left before the 64KB boundary?
+	 * XHCI Spec puts restriction( TABLE 49 and 6.4.1 section of XHCI Spec)
+	 * that the buffer should not span 64KB boundary. if so
+	 * we send request in more than 1 TRB by chaining them.
+	 */
+	running_total = TRB_MAX_BUFF_SIZE -
+			(lower_32_bits(val_64) & (TRB_MAX_BUFF_SIZE - 1));
+	running_total &= TRB_MAX_BUFF_SIZE - 1;
+
+	/*
+	 * If there's some data on this 64KB chunk, or we have to send a
+	 * zero-length transfer, we need at least one TRB
+	 */
+	if (running_total != 0 || length == 0)
+		num_trbs++;
+
+	/* How many more 64KB chunks to transfer, how many more TRBs? */
+	while (running_total < length) {
+		num_trbs++;
+		running_total += TRB_MAX_BUFF_SIZE;
+	}
+
+	return num_trbs;
+}
+
+/**
+ * Queues up one BULK TD and hands it over to the hardware
+ *
+ * This does not wait for the TD to complete, so further TDs may be queued
+ * behind it, on the same or on other endpoints.
+ *
+ * @param udev		pointer to the USB device structure
+ * @param req		the bulk request to queue; on return req->hcpriv
+ *			points to the last TRB of the TD
+ * Return: returns 0 if successful else error code on failure
+ */
+static int xhci_queue_bulk_td(struct usb_device *udev,
+			      struct usb_bulk_req *req)
+{
+	int num_trbs;
 	struct xhci_generic_trb *start_trb;
 	bool first_trb = false;
 	int start_cycle;
 	u32 field = 0;
 	u32 length_field = 0;
 	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	unsigned long pipe = req->pipe;
+	void *buffer = req->buffer;
+	int length = req->length;
 	int slot_id = udev->slot_id;
 	int ep_index;
 	struct xhci_virt_device *virt_dev;
 	struct xhci_ep_ctx *ep_ctx;
 	struct xhci_ring *ring;		/* EP transfer ring */
-	union xhci_trb *event;
 
 	int running_total, trb_buff_len;
 	bool more_trbs_coming = true;
@@ -610,13 +743,10 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 	int ret;
 	u32 trb_fields[4];
 	u64 val_64 = xhci_virt_to_bus(ctrl, buffer);
-	void *last_transfer_trb_addr;
-	int available_length;
 
 	debug("dev=%p, pipe=%lx, buffer=%p, length=%d\n",
 		udev, pipe, buffer, length);
 
-	available_length = length;
 	ep_index = usb_pipe_ep_index(pipe);
 	virt_dev = ctrl->devs[slot_id];
 
@@ -625,30 +755,11 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 
 	ep_ctx = xhci_get_ep_ctx(ctrl, virt_dev->out_ctx, ep_index);
 
-	ring = virt_dev->eps[ep_index].ring;
-	/*
-	 * How much data is (potentially) left before the 64KB boundary?
-	 * XHCI Spec puts restriction( TABLE 49 and 6.4.1 section of XHCI Spec)
-	 * that the buffer should not span 64KB boundary. if so
-	 * we send request in more than 1 TRB by chaining them.
-	 */
-	running_total = TRB_MAX_BUFF_SIZE -
-			(lower_32_bits(val_64) & (TRB_MAX_BUFF_SIZE - 1));
-	trb_buff_len = running_total;
-	running_total &= TRB_MAX_BUFF_SIZE - 1;
-
-	/*
-	 * If there's some data on this 64KB chunk, or we have to send a
-	 * zero-length transfer, we need at least one TRB
-	 */
-	if (running_total != 0 || length == 0)
-		num_trbs++;
+	ring = xhci_ep_ring(&virt_dev->eps[ep_index], req->stream_id);
+	if (!ring)
+		return -EINVAL;
 
-	/* How many more 64KB chunks to transfer, how many more TRBs? */
-	while (running_total < length) {
-		num_trbs++;
-		running_total += TRB_MAX_BUFF_SIZE;
-	}
+	num_trbs = xhci_bulk_num_trbs(ctrl, buffer, length);
 
 	/*
 	 * XXX: Calling routine prepare_ring() called in place of
@@ -679,15 +790,14 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 	 * we send request in more than 1 TRB by chaining them.
 	 */
 	addr = val_64;
+	trb_buff_len = TRB_MAX_BUFF_SIZE -
+		       (lower_32_bits(val_64) & (TRB_MAX_BUFF_SIZE - 1));
 
 	if (trb_buff_len > length)
 		trb_buff_len = length;
 
 	first_trb = true;
 
-	/* flush the buffer before use */
-	xhci_flush_cache((uintptr_t)buffer, length);
-
 	/* Queue the first TRB, even if it's zero-length */
 	do {
 		u32 remainder = 0;
@@ -730,7 +840,7 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 		trb_fields[2] = length_field;
 		trb_fields[3] = field | TRB_TYPE(TRB_NORMAL);
 
-		last_transfer_trb_addr = queue_trb(ctrl, ring, (num_trbs > 1), trb_fields);
+		req->hcpriv = queue_trb(ctrl, ring, (num_trbs > 1), trb_fields);
 
 		--num_trbs;
 
@@ -741,35 +851,324 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 		trb_buff_len = min((length - running_total), TRB_MAX_BUFF_SIZE);
 	} while (running_total < length);
 
-	giveback_first_trb(udev, ep_index, start_cycle, start_trb);
+	/* Count down the residue of short packets from the full length */
+	req->act_len = length;
+	giveback_first_trb(udev, ep_index, req->stream_id, start_cycle,
+			   start_trb);
 
-again:
-	event = xhci_wait_for_event(ctrl, TRB_TRANSFER);
-	if (!event) {
-		debug("XHCI bulk transfer timed out, aborting...\n");
-		abort_td(udev, ep_index);
-		udev->status = USB_ST_NAK_REC;  /* closest thing to a timeout */
-		udev->act_len = 0;
-		return -ETIMEDOUT;
+	return 0;
+}
+
+/**
+ * Checks whether a TRB is part of a ring
+ *
+ * @param ctrl		Host controller data structure
+ * @param ring		pointer to the ring
+ * @param trb_64	bus address of the TRB
+ * Return: true if the TRB is in one of the ring's segments
+ */
+static bool trb_in_ring(struct xhci_ctrl *ctrl, struct xhci_ring *ring,
+			u64 trb_64)
+{
+	struct xhci_segment *seg = ring->first_seg;
+	u64 start;
+
+	do {
+		start = xhci_virt_to_bus(ctrl, seg->trbs);
+		if (trb_64 >= start && trb_64 < start + SEGMENT_SIZE)
+			return true;
+		seg = seg->next;
+	} while (seg != ring->first_seg);
+
+	return false;
+}
+
+/**
+ * Cancels all pending BULK TDs of a batch after one of them failed
+ *
+ * A halted endpoint is reset, which also discards the TDs queued on it.
+ * Any other endpoint which still has TDs pending is stopped and its queued
+ * TDs are thrown away.
+ *
+ * @param udev		pointer to the USB device structure
+ * @param reqs		the bulk requests which were queued
+ * @param count		number of requests in @reqs
+ * Return: none
+ */
+static void xhci_cancel_bulk_tds(struct usb_device *udev,
+				 struct usb_bulk_req *reqs, int count)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	struct xhci_virt_device *virt_dev = ctrl->devs[udev->slot_id];
+	bool done[MAX_EP_CTX_NUM] = { false };
+	struct xhci_ep_ctx *ep_ctx;
+	int ep_index;
+	bool pending;
+	int i, j;
+
+	xhci_inval_cache((uintptr_t)virt_dev->out_ctx->bytes,
+			 virt_dev->out_ctx->size);
+
+	for (i = 0; i < count; i++) {
+		ep_index = usb_pipe_ep_index(reqs[i].pipe);
+		if (done[ep_index])
+			continue;
+		done[ep_index] = true;
+
+		ep_ctx = xhci_get_ep_ctx(ctrl, virt_dev->out_ctx, ep_index);
+		if ((le32_to_cpu(ep_ctx->ep_info) & EP_STATE_MASK) ==
+		    EP_STATE_HALTED) {
+			reset_ep(udev, ep_index);
+			continue;
+		}
+
+		pending = false;
+		for (j = i; j < count; j++) {
+			if (reqs[j].status == USB_ST_NOT_PROC &&
+			    reqs[j].hcpriv &&
+			    usb_pipe_ep_index(reqs[j].pipe) == ep_index)
+				pending = true;
+		}
+		if (pending)
+			abort_td(udev, ep_index);
 	}
+}
+
+/**
+ * Cancels the TDs left on the stream of a request which ended it
+ *
+ * The other endpoints which still have a TD pending on the same stream are
+ * stopped, that TD is thrown away and the endpoint is restarted for its
+ * remaining streams. The cancelled requests keep status USB_ST_NOT_PROC.
+ *
+ * @param udev		pointer to the USB device structure
+ * @param reqs		the bulk requests which were queued
+ * @param count		number of requests in @reqs
+ * @param end		the completed request with USB_BULK_REQ_END_STREAM
+ * Return: number of requests cancelled
+ */
+static int xhci_end_bulk_stream(struct usb_device *udev,
+				struct usb_bulk_req *reqs, int count,
+				struct usb_bulk_req *end)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	int ep_index;
+	int cancelled = 0;
+	int i, j;
 
-	if ((uintptr_t)(le64_to_cpu(event->trans_event.buffer)) !=
-	    (uintptr_t)xhci_virt_to_bus(ctrl, last_transfer_trb_addr)) {
-		available_length -=
-			(int)EVENT_TRB_LEN(le32_to_cpu(event->trans_event.transfer_len));
+	for (i = 0; i < count; i++) {
+		if (reqs[i].status != USB_ST_NOT_PROC || !reqs[i].hcpriv ||
+		    reqs[i].stream_id != end->stream_id ||
+		    reqs[i].pipe == end->pipe)
+			continue;
+
+		ep_index = usb_pipe_ep_index(reqs[i].pipe);
+		debug("XHCI cancelling TD on EP %d stream %u\n", ep_index,
+		      reqs[i].stream_id);
+		abort_stream_td(udev, ep_index, reqs[i].stream_id);
+		reqs[i].hcpriv = NULL;
+		reqs[i].act_len = 0;
+		cancelled++;
+
+		for (j = 0; j < count; j++) {
+			if (reqs[j].status == USB_ST_NOT_PROC &&
+			    reqs[j].hcpriv &&
+			    usb_pipe_ep_index(reqs[j].pipe) == ep_index)
+				xhci_writel(&ctrl->dba->doorbell[udev->slot_id],
+					    DB_VALUE(ep_index,
+						     reqs[j].stream_id));
+		}
+	}
+
+	return cancelled;
+}
+
+/**
+ * Waits for a batch of queued BULK TDs to complete
+ *
+ * TDs complete in order on each transfer ring, so every transfer event
+ * belongs to the oldest TD still pending on its ring. A request with
+ * USB_BULK_REQ_END_STREAM cancels what is left on its stream once it
+ * completes, so that the batch does not wait for TDs which the device will
+ * never process.
+ *
+ * @param udev		pointer to the USB device structure
+ * @param reqs		the bulk requests which were queued
+ * @param count		number of requests in @reqs
+ * Return: returns 0 if all TDs completed or were cancelled by their stream
+ *	   ending, else error code
+ */
+static int xhci_reap_bulk_tds(struct usb_device *udev,
+			      struct usb_bulk_req *reqs, int count)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	struct xhci_virt_device *virt_dev = ctrl->devs[udev->slot_id];
+	struct usb_bulk_req *req;
+	union xhci_trb *event;
+	struct xhci_virt_ep *ep;
+	int ep_index;
+	int done = 0;
+	u64 trb_64;
+	u32 field;
+	int i;
+
+	while (done < count) {
+		event = xhci_wait_for_event(ctrl, TRB_TRANSFER);
+		if (!event) {
+			debug("XHCI bulk transfer timed out, aborting...\n");
+			xhci_cancel_bulk_tds(udev, reqs, count);
+			udev->status = USB_ST_NAK_REC;  /* closest thing to a timeout */
+			udev->act_len = 0;
+			return -ETIMEDOUT;
+		}
+
+		field = le32_to_cpu(event->trans_event.flags);
+		BUG_ON(TRB_TO_SLOT_ID(field) != udev->slot_id);
+		ep_index = TRB_TO_EP_INDEX(field);
+		ep = &virt_dev->eps[ep_index];
+		trb_64 = le64_to_cpu(event->trans_event.buffer);
+
+		req = NULL;
+		for (i = 0; i < count; i++) {
+			if (reqs[i].status != USB_ST_NOT_PROC ||
+			    !reqs[i].hcpriv ||
+			    usb_pipe_ep_index(reqs[i].pipe) != ep_index)
+				continue;
+			if (!ep->num_streams ||
+			    trb_in_ring(ctrl, xhci_ep_ring(ep,
+							   reqs[i].stream_id),
+					trb_64)) {
+				req = &reqs[i];
+				break;
+			}
+		}
+		BUG_ON(!req);
+
+		if ((uintptr_t)trb_64 !=
+		    (uintptr_t)xhci_virt_to_bus(ctrl, req->hcpriv)) {
+			req->act_len -= (int)EVENT_TRB_LEN(
+				le32_to_cpu(event->trans_event.transfer_len));
+			xhci_acknowledge_event(ctrl);
+			continue;
+		}
+
+		record_transfer_result(udev, event, req->act_len);
 		xhci_acknowledge_event(ctrl);
-		goto again;
+		req->act_len = udev->act_len;
+		req->status = udev->status;
+		done++;
+
+		if (req->status) {
+			xhci_cancel_bulk_tds(udev, reqs, count);
+			udev->status = req->status;
+			udev->act_len = req->act_len;
+			return -EIO;
+		}
+
+		if ((req->flags & USB_BULK_REQ_END_STREAM) && req->stream_id)
+			done += xhci_end_bulk_stream(udev, reqs, count, req);
 	}
 
-	field = le32_to_cpu(event->trans_event.flags);
-	BUG_ON(TRB_TO_SLOT_ID(field) != slot_id);
-	BUG_ON(TRB_TO_EP_INDEX(field) != ep_index);
+	return 0;
+}
 
-	record_transfer_result(udev, event, available_length);
-	xhci_acknowledge_event(ctrl);
-	xhci_inval_cache((uintptr_t)buffer, length);
+/**
+ * Queues up several BULK Requests and waits for all of them to complete
+ *
+ * The TDs are handed to the hardware back-to-back without waiting in
+ * between, so the controller never idles between them. If they do not all
+ * fit in the endpoint rings at once, the remaining TDs are queued once the
+ * earlier ones have completed.
+ *
+ * @param udev		pointer to the USB device structure
+ * @param reqs		the bulk requests to transfer
+ * @param count		number of requests in @reqs
+ * Return: returns 0 if successful else error code on failure
+ */
+int xhci_bulk_tx_queue(struct usb_device *udev, struct usb_bulk_req *reqs,
+		       int count)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	struct dma_sync_batch batch;
+	int first, next, i;
+	int ring_trbs;
+	int ret, err;
 
-	return (udev->status != USB_ST_NOT_PROC) ? 0 : -1;
+	/*
+	 * Flush all the buffers before use. Consecutive buffers are merged,
+	 * so a large transfer split into several TDs needs one operation.
+	 */
+	dma_sync_batch_init(&batch, DMA_BIDIRECTIONAL, false);
+	for (next = 0; next < count; next++) {
+		reqs[next].status = USB_ST_NOT_PROC;
+		reqs[next].hcpriv = NULL;
+		dma_sync_batch_add(&batch, reqs[next].buffer, reqs[next].length);
+	}
+	dma_sync_batch_run(&batch);
+
+	for (first = 0; first < count; first = next) {
+		ret = 0;
+
+		for (next = first; next < count; next++) {
+			/* Count the TRBs this TD adds to its ring */
+			ring_trbs = 0;
+			for (i = first; i <= next; i++) {
+				if (reqs[i].pipe == reqs[next].pipe &&
+				    reqs[i].stream_id == reqs[next].stream_id)
+					ring_trbs += xhci_bulk_num_trbs(ctrl,
+							reqs[i].buffer,
+							reqs[i].length);
+			}
+			if (next > first && ring_trbs > XHCI_BULK_RING_TRBS)
+				break;
+
+			ret = xhci_queue_bulk_td(udev, &reqs[next]);
+			if (ret)
+				break;
+		}
+
+		/* Wait for what was queued, even if queueing failed */
+		err = xhci_reap_bulk_tds(udev, &reqs[first], next - first);
+
+		/* The TDs are complete or cancelled, so the CPU owns them */
+		dma_sync_batch_init(&batch, DMA_BIDIRECTIONAL, true);
+		for (i = first; i < next; i++)
+			dma_sync_batch_add(&batch, reqs[i].buffer,
+					   reqs[i].length);
+		dma_sync_batch_run(&batch);
+		if (err)
+			return err;
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * Queues up the BULK Request
+ *
+ * @param udev		pointer to the USB device structure
+ * @param pipe		contains the DIR_IN or OUT , devnum
+ * @param length	length of the buffer
+ * @param buffer	buffer to be read/written based on the request
+ * Return: returns 0 if successful else -1 on failure
+ */
+int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
+			int length, void *buffer)
+{
+	struct usb_bulk_req req = {
+		.pipe = pipe,
+		.buffer = buffer,
+		.length = length,
+	};
+	int ret;
+
+	ret = xhci_bulk_tx_queue(udev, &req, 1);
+	if (ret == -EIO)
+		return 0;	/* the error is reported in udev->status */
+
+	return ret;
 }
 
 /**
@@ -943,7 +1342,7 @@ int xhci_ctrl_tx(struct usb_device *udev, unsigned long pipe,
 
 	queue_trb(ctrl, ep_ring, false, trb_fields);
 
-	giveback_first_trb(udev, ep_index, start_cycle, start_trb);
+	giveback_first_trb(udev, ep_index, 0, start_cycle, start_trb);
 
 	event = xhci_wait_for_event(ctrl, TRB_TRANSFER);
 	if (!event)
@@ -36,6 +36,7 @@
 #include <linux/delay.h>
 #include <linux/errno.h>
 #include <linux/iopoll.h>
+#include <linux/log2.h>
 
 #ifndef CONFIG_USB_MAX_CONTROLLER_COUNT
 #define CONFIG_USB_MAX_CONTROLLER_COUNT 1
@@ -1396,6 +1397,24 @@ static int xhci_submit_bulk_msg(struct udevice *dev, struct usb_device *udev,
 	return _xhci_submit_bulk_msg(udev, pipe, buffer, length);
 }
 
+static int xhci_submit_bulk_queue(struct udevice *dev, struct usb_device *udev,
+				  struct usb_bulk_req *reqs, int count)
+{
+	int i;
+
+	debug("%s: dev='%s', udev=%p, count=%d\n", __func__, dev->name, udev,
+	      count);
+	for (i = 0; i < count; i++) {
+		if (usb_pipetype(reqs[i].pipe) != PIPE_BULK) {
+			printf("non-bulk pipe (type=%lu)",
+			       usb_pipetype(reqs[i].pipe));
+			return -EINVAL;
+		}
+	}
+
+	return xhci_bulk_tx_queue(udev, reqs, count);
+}
+
 static int xhci_submit_int_msg(struct udevice *dev, struct usb_device *udev,
 			       unsigned long pipe, void *buffer, int length,
 			       int interval, bool nonblock)
@@ -1477,6 +1496,76 @@ static int xhci_update_hub_device(struct udevice *dev, struct usb_device *udev)
 	return xhci_configure_endpoints(udev, false);
 }
 
+static int xhci_alloc_streams(struct udevice *dev, struct usb_device *udev,
+			      unsigned long *pipes, int num_pipes,
+			      unsigned int num_streams)
+{
+	struct xhci_ctrl *ctrl = dev_get_priv(dev);
+	struct xhci_virt_device *virt_dev = ctrl->devs[udev->slot_id];
+	struct xhci_container_ctx *in_ctx = virt_dev->in_ctx;
+	struct xhci_container_ctx *out_ctx = virt_dev->out_ctx;
+	struct xhci_input_control_ctx *ctrl_ctx;
+	struct xhci_ep_ctx *ep_ctx;
+	unsigned int array_size;
+	u32 ep_flags = 0;
+	int ep_index;
+	u32 hcc;
+	int i, ret;
+
+	hcc = xhci_readl(&ctrl->hccr->cr_hccparams);
+	if (!((hcc >> 12) & 0xf)) {
+		debug("%s: controller does not support streams\n", __func__);
+		return -ENOSYS;
+	}
+
+	/*
+	 * Stream ID 0 is reserved, the stream context array size must be a
+	 * power of two and at least 4 entries (MaxPStreams of 1)
+	 */
+	array_size = __roundup_pow_of_two(num_streams + 1);
+	array_size = clamp(array_size, 4U, (unsigned int)HCC_MAX_PSA(hcc));
+
+	xhci_inval_cache((uintptr_t)out_ctx->bytes, out_ctx->size);
+
+	for (i = 0; i < num_pipes; i++) {
+		ep_index = usb_pipe_ep_index(pipes[i]);
+		ret = xhci_alloc_stream_rings(ctrl, &virt_dev->eps[ep_index],
+					      array_size);
+		if (ret)
+			goto err;
+
+		xhci_endpoint_copy(ctrl, in_ctx, out_ctx, ep_index);
+		ep_ctx = xhci_get_ep_ctx(ctrl, in_ctx, ep_index);
+		ep_ctx->ep_info &= cpu_to_le32(~(EP_MAXPSTREAMS_MASK |
+						 EP_STATE_MASK));
+		ep_ctx->ep_info |= cpu_to_le32(EP_HAS_LSA |
+				EP_MAXPSTREAMS(ilog2(array_size) - 1));
+		ep_ctx->deq = cpu_to_le64(xhci_virt_to_bus(ctrl,
+				virt_dev->eps[ep_index].stream_ctx));
+		ep_flags |= 1 << (ep_index + 1);
+	}
+
+	/* Drop and re-add the endpoints to switch them over to streams */
+	ctrl_ctx = xhci_get_input_control_ctx(in_ctx);
+	ctrl_ctx->add_flags = cpu_to_le32(SLOT_FLAG | ep_flags);
+	ctrl_ctx->drop_flags = cpu_to_le32(ep_flags);
+	xhci_slot_copy(ctrl, in_ctx, out_ctx);
+
+	ret = xhci_configure_endpoints(udev, false);
+	if (ret)
+		goto err;
+
+	return array_size - 1;
+
+err:
+	for (i = 0; i < num_pipes; i++) {
+		ep_index = usb_pipe_ep_index(pipes[i]);
+		xhci_free_stream_rings(&virt_dev->eps[ep_index]);
+	}
+
+	return ret;
+}
+
 static int xhci_get_max_xfer_size(struct udevice *dev, size_t *size)
 {
 	/*
@@ -1541,6 +1630,8 @@ int xhci_deregister(struct udevice *dev)
 struct dm_usb_ops xhci_usb_ops = {
 	.control = xhci_submit_control_msg,
 	.bulk = xhci_submit_bulk_msg,
+	.bulk_queue = xhci_submit_bulk_queue,
+	.alloc_streams = xhci_alloc_streams,
 	.interrupt = xhci_submit_int_msg,
 	.alloc_device = xhci_alloc_device,
 	.update_hub_device = xhci_update_hub_device,
@@ -93,6 +93,37 @@ struct pos_info {
  */
 #define POS_HISTORY_SIZE	(CONFIG_SYS_CBSIZE * 11 / 10)
 
+/*
+ * Number of sub-pixel positions kept for each character in the glyph cache,
+ * and the number of cache entries. The cache is direct-mapped, with enough
+ * entries that each 7-bit character has its own slots.
+ */
+#define TT_GLYPH_SUBPIXELS	4
+#define TT_GLYPH_CACHE_SIZE	512
+
+/**
+ * struct tt_glyph - A rendered character
+ *
+ * @bits:	8bpp image of the character, NULL if it has no visible pixels
+ * @ch:		Character that was rendered
+ * @shift:	Sub-pixel position, in units of 1 / TT_GLYPH_SUBPIXELS pixel
+ * @width:	Width of the image in pixels
+ * @height:	Height of the image in pixels
+ * @xoff:	X offset of the image from the cursor position
+ * @yoff:	Y offset of the image from the baseline
+ * @valid:	true if this cache entry holds a character
+ */
+struct tt_glyph {
+	u8 *bits;
+	int ch;
+	int shift;
+	int width;
+	int height;
+	int xoff;
+	int yoff;
+	bool valid;
+};
+
 /**
  * struct console_tt_priv - Private data for this driver
  *
@@ -112,6 +143,9 @@ struct pos_info {
  * @scale:	Scale of the font. This is calculated from the pixel height
  *		of the font. It is used by the STB library to generate images
  *		of the correct size.
+ * @glyphs:	Cache of rendered characters (TT_GLYPH_CACHE_SIZE entries),
+ *		allocated on first use. Only used with
+ *		CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
  */
 struct console_tt_priv {
 	int font_size;
@@ -121,6 +155,9 @@ struct console_tt_priv {
 	int pos_ptr;
 	int baseline;
 	double scale;
+#if CONFIG_IS_ENABLED(CONSOLE_TRUETYPE_GLYPH_CACHE)
+	struct tt_glyph *glyphs;
+#endif
 };
 
 static int console_truetype_set_row(struct udevice *dev, uint row, int clr)
@@ -195,6 +232,61 @@ static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
 	return 0;
 }
 
+/**
+ * console_truetype_get_glyph() - Get the image of a character
+ *
+ * With the glyph cache enabled, @x_shift is rounded to the nearest cached
+ * sub-pixel position and the image is taken from the cache, rendering it only
+ * if it is not already there.
+ *
+ * @priv:	Private data
+ * @ch:		Character to render
+ * @x_shift:	Fractional pixel position of the character (0 <= x_shift < 1)
+ * @glyph:	Returns the image and its metrics
+ * Return: true if the caller must free glyph->bits, false if it is owned by
+ *	the cache
+ */
+static bool console_truetype_get_glyph(struct console_tt_priv *priv, char ch,
+				       double x_shift, struct tt_glyph *glyph)
+{
+#if CONFIG_IS_ENABLED(CONSOLE_TRUETYPE_GLYPH_CACHE)
+	int shift = (int)(x_shift * TT_GLYPH_SUBPIXELS + 0.5);
+	struct tt_glyph *slot;
+
+	if (!priv->glyphs)
+		priv->glyphs = calloc(TT_GLYPH_CACHE_SIZE, sizeof(*slot));
+	if (priv->glyphs) {
+		/* Rounding up can take us to the next pixel */
+		if (shift == TT_GLYPH_SUBPIXELS)
+			shift--;
+		slot = &priv->glyphs[((u8)ch * TT_GLYPH_SUBPIXELS + shift) %
+				     TT_GLYPH_CACHE_SIZE];
+		if (!slot->valid || slot->ch != ch || slot->shift != shift) {
+			free(slot->bits);
+			slot->bits = stbtt_GetCodepointBitmapSubpixel(&priv->font,
+					priv->scale, priv->scale,
+					(double)shift / TT_GLYPH_SUBPIXELS, 0,
+					ch, &slot->width, &slot->height,
+					&slot->xoff, &slot->yoff);
+			slot->ch = ch;
+			slot->shift = shift;
+			slot->valid = true;
+		}
+		*glyph = *slot;
+
+		return false;
+	}
+#endif
+	glyph->bits = stbtt_GetCodepointBitmapSubpixel(&priv->font, priv->scale,
+						       priv->scale, x_shift, 0,
+						       ch, &glyph->width,
+						       &glyph->height,
+						       &glyph->xoff,
+						       &glyph->yoff);
+
+	return true;
+}
+
 static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 				    char ch)
 {
@@ -203,12 +295,14 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 	struct video_priv *vid_priv = dev_get_uclass_priv(vid);
 	struct console_tt_priv *priv = dev_get_priv(dev);
 	stbtt_fontinfo *font = &priv->font;
-	int width, height, xoff, yoff;
+	struct tt_glyph glyph;
 	double xpos, x_shift;
 	int lsb;
 	int width_frac, linenum;
 	struct pos_info *pos;
-	u8 *bits, *data;
+	u8 *bits;
+	bool must_free, set;
+	u8 invert;
 	int advance;
 	void *start, *end, *line;
 	int row, ret;
@@ -249,20 +343,18 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 	/*
 	 * Figure out how much past the start of a pixel we are, and pass this
 	 * information into the render, which will return a 8-bit-per-pixel
-	 * image of the character. For empty characters, like ' ', data will
-	 * return NULL;
+	 * image of the character. For empty characters, like ' ', the image
+	 * will be NULL;
 	 */
-	data = stbtt_GetCodepointBitmapSubpixel(font, priv->scale, priv->scale,
-						x_shift, 0, ch, &width, &height,
-						&xoff, &yoff);
-	if (!data)
+	must_free = console_truetype_get_glyph(priv, ch, x_shift, &glyph);
+	if (!glyph.bits)
 		return width_frac;
 
 	/* Figure out where to write the character in the frame buffer */
-	bits = data;
+	bits = glyph.bits;
 	start = vid_priv->fb + y * vid_priv->line_length +
 		VID_TO_PIXEL(x) * VNBYTES(vid_priv->bpix);
-	linenum = priv->baseline + yoff;
+	linenum = priv->baseline + glyph.yoff;
 	if (linenum > 0)
 		start += linenum * vid_priv->line_length;
 	line = start;
@@ -270,50 +362,44 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 	/*
 	 * Write a row at a time, converting the 8bpp image into the colour
 	 * depth of the display. We only expect white-on-black or the reverse
-	 * so the code only handles this simple case.
+	 * so the code only handles this simple case: the image is inverted
+	 * for a non-black background (invert ^ val == 255 - val) and then
+	 * ORed onto a dark background or ANDed onto a light one. The colour
+	 * tests are done once per character rather than once per pixel.
 	 */
-	for (row = 0; row < height; row++) {
+	invert = vid_priv->colour_bg ? 0xff : 0;
+	set = vid_priv->colour_fg;
+	for (row = 0; row < glyph.height; row++) {
 		switch (vid_priv->bpix) {
 		case VIDEO_BPP8:
 			if (IS_ENABLED(CONFIG_VIDEO_BPP8)) {
-				u8 *dst = line + xoff;
-				int i;
-
-				for (i = 0; i < width; i++) {
-					int val = *bits;
-					int out;
-
-					if (vid_priv->colour_bg)
-						val = 255 - val;
-					out = val;
-					if (vid_priv->colour_fg)
-						*dst++ |= out;
-					else
-						*dst++ &= out;
-					bits++;
+				u8 *dst = line + glyph.xoff;
+				u8 *last = dst + glyph.width;
+
+				if (set) {
+					while (dst < last)
+						*dst++ |= *bits++ ^ invert;
+				} else {
+					while (dst < last)
+						*dst++ &= *bits++ ^ invert;
 				}
 				end = dst;
 			}
 			break;
 #ifdef CONFIG_VIDEO_BPP16
 		case VIDEO_BPP16: {
-			uint16_t *dst = (uint16_t *)line + xoff;
-			int i;
-
-			for (i = 0; i < width; i++) {
-				int val = *bits;
-				int out;
+			u16 *dst = (u16 *)line + glyph.xoff;
+			u16 *last = dst + glyph.width;
 
-				if (vid_priv->colour_bg)
-					val = 255 - val;
-				out = val >> 3 |
-					(val >> 2) << 5 |
+			while (dst < last) {
+				uint val = *bits++ ^ invert;
+				u16 out = val >> 3 | (val >> 2) << 5 |
 					(val >> 3) << 11;
-				if (vid_priv->colour_fg)
+
+				if (set)
 					*dst++ |= out;
 				else
 					*dst++ &= out;
-				bits++;
 			}
 			end = dst;
 			break;
@@ -321,37 +407,39 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 #endif
 #ifdef CONFIG_VIDEO_BPP32
 		case VIDEO_BPP32: {
-			u32 *dst = (u32 *)line + xoff;
-			int i;
+			u32 *dst = (u32 *)line + glyph.xoff;
+			u32 *last = dst + glyph.width;
 
-			for (i = 0; i < width; i++) {
-				int val = *bits;
-				int out;
+			if (set) {
+				while (dst < last) {
+					u32 val = *bits++ ^ invert;
 
-				if (vid_priv->colour_bg)
-					val = 255 - val;
-				out = val | val << 8 | val << 16;
-				if (vid_priv->colour_fg)
-					*dst++ |= out;
-				else
-					*dst++ &= out;
-				bits++;
+					*dst++ |= val | val << 8 | val << 16;
+				}
+			} else {
+				while (dst < last) {
+					u32 val = *bits++ ^ invert;
+
+					*dst++ &= val | val << 8 | val << 16;
+				}
 			}
 			end = dst;
 			break;
 		}
 #endif
 		default:
-			free(data);
+			if (must_free)
+				free(glyph.bits);
 			return -ENOSYS;
 		}
 
 		line += vid_priv->line_length;
 	}
+	if (must_free)
+		free(glyph.bits);
 	ret = vidconsole_sync_copy(dev, start, line);
 	if (ret)
 		return ret;
-	free(data);
 
 	return width_frac;
 }
@@ -594,6 +682,23 @@ static int console_truetype_probe(struct udevice *dev)
 	return 0;
 }
 
+static int console_truetype_remove(struct udevice *dev)
+{
+#if CONFIG_IS_ENABLED(CONSOLE_TRUETYPE_GLYPH_CACHE)
+	struct console_tt_priv *priv = dev_get_priv(dev);
+	int i;
+
+	if (priv->glyphs) {
+		for (i = 0; i < TT_GLYPH_CACHE_SIZE; i++)
+			free(priv->glyphs[i].bits);
+		free(priv->glyphs);
+		priv->glyphs = NULL;
+	}
+#endif
+
+	return 0;
+}
+
 struct vidconsole_ops console_truetype_ops = {
 	.putc_xy	= console_truetype_putc_xy,
 	.move_rows	= console_truetype_move_rows,
@@ -607,5 +712,6 @@ U_BOOT_DRIVER(vidconsole_truetype) = {
 	.id	= UCLASS_VIDEO_CONSOLE,
 	.ops	= &console_truetype_ops,
 	.probe	= console_truetype_probe,
+	.remove	= console_truetype_remove,
 	.priv_auto	= sizeof(struct console_tt_priv),
 };
@@ -671,6 +671,18 @@ static int mxs_video_probe(struct udevice *dev)
 	return ret;
 }
 
+static int mxs_video_set_offset(struct udevice *dev, ulong offset)
+{
+	struct video_uc_plat *plat = dev_get_uclass_plat(dev);
+	struct mxsfb_priv *priv = dev_get_priv(dev);
+	struct mxs_lcdif_regs *regs = (struct mxs_lcdif_regs *)priv->reg_base;
+
+	/* The controller switches to the new buffer at the next frame */
+	writel(plat->base + offset, &regs->hw_lcdif_next_buf);
+
+	return 0;
+}
+
 static int mxs_video_bind(struct udevice *dev)
 {
 	struct video_uc_plat *plat = dev_get_uclass_plat(dev);
@@ -697,6 +709,10 @@ static int mxs_video_remove(struct udevice *dev)
 	return 0;
 }
 
+static const struct video_ops mxs_video_ops = {
+	.set_offset	= mxs_video_set_offset,
+};
+
 static const struct udevice_id mxs_video_ids[] = {
 	{ .compatible = "fsl,imx23-lcdif" },
 	{ .compatible = "fsl,imx28-lcdif" },
@@ -711,6 +727,7 @@ U_BOOT_DRIVER(mxs_video) = {
 	.name	= "mxs_video",
 	.id	= UCLASS_VIDEO,
 	.of_match = mxs_video_ids,
+	.ops	= &mxs_video_ops,
 	.bind	= mxs_video_bind,
 	.probe	= mxs_video_probe,
 	.remove = mxs_video_remove,
@@ -128,6 +128,21 @@ static int sandbox_sdl_bind(struct udevice *dev)
 	return ret;
 }
 
+static int sandbox_sdl_set_offset(struct udevice *dev, ulong offset)
+{
+	struct sandbox_sdl_plat *plat = dev_get_plat(dev);
+
+	/* The display is synced from the uclass's fb, so there is no more */
+	if (!plat->pan)
+		return -ENOSYS;
+
+	return 0;
+}
+
+static const struct video_ops sandbox_sdl_ops = {
+	.set_offset	= sandbox_sdl_set_offset,
+};
+
 static const struct udevice_id sandbox_sdl_ids[] = {
 	{ .compatible = "sandbox,lcd-sdl" },
 	{ }
@@ -137,6 +152,7 @@ U_BOOT_DRIVER(sandbox_lcd_sdl) = {
 	.name	= "sandbox_lcd_sdl",
 	.id	= UCLASS_VIDEO,
 	.of_match = sandbox_sdl_ids,
+	.ops	= &sandbox_sdl_ops,
 	.bind	= sandbox_sdl_bind,
 	.probe	= sandbox_sdl_probe,
 	.remove	= sandbox_sdl_remove,
@@ -656,7 +656,6 @@ UCLASS_DRIVER(vidconsole) = {
 	.per_device_auto	= sizeof(struct vidconsole_priv),
 };
 
-#ifdef CONFIG_VIDEO_COPY
 int vidconsole_sync_copy(struct udevice *dev, void *from, void *to)
 {
 	struct udevice *vid = dev_get_parent(dev);
@@ -667,10 +666,8 @@ int vidconsole_sync_copy(struct udevice *dev, void *from, void *to)
 int vidconsole_memmove(struct udevice *dev, void *dst, const void *src,
 		       int size)
 {
-	memmove(dst, src, size);
-	return vidconsole_sync_copy(dev, dst, dst + size);
+	return video_memmove(dev_get_parent(dev), dst, src, size);
 }
-#endif
 
 #if CONFIG_IS_ENABLED(CMD_VIDCONSOLE)
 void vidconsole_position_cursor(struct udevice *dev, unsigned col, unsigned row)
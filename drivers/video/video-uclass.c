@@ -9,6 +9,7 @@
 #include <console.h>
 #include <cpu_func.h>
 #include <dm.h>
+#include <dma.h>
 #include <log.h>
 #include <malloc.h>
 #include <mapmem.h>
@@ -21,6 +22,7 @@
 #include <dm/device_compat.h>
 #include <dm/device-internal.h>
 #include <dm/uclass-internal.h>
+#include <linux/sizes.h>
 #ifdef CONFIG_SANDBOX
 #include <asm/sdl.h>
 #endif
@@ -183,6 +185,7 @@ void video_set_default_colors(struct udevice *dev, bool invert)
 /* Flush video activity to the caches */
 int video_sync(struct udevice *vid, bool force)
 {
+	struct video_priv *priv = dev_get_uclass_priv(vid);
 	struct video_ops *ops = video_get_ops(vid);
 	int ret;
 
@@ -198,15 +201,22 @@ int video_sync(struct udevice *vid, bool force)
 	 * out whether it exists? For now, ARM is safe.
 	 */
 #if defined(CONFIG_ARM) && !CONFIG_IS_ENABLED(SYS_DCACHE_OFF)
-	struct video_priv *priv = dev_get_uclass_priv(vid);
-
 	if (priv->flush_dcache) {
-		flush_dcache_range((ulong)priv->fb,
-				   ALIGN((ulong)priv->fb + priv->fb_size,
-					 CONFIG_SYS_CACHELINE_SIZE));
+		ulong start = (ulong)priv->fb;
+		ulong end = start + priv->fb_size;
+
+		/* Only flush the lines changed since the last sync */
+		if (!force) {
+			end = start + priv->damage_end;
+			start += priv->damage_start;
+		}
+		if (end > start)
+			flush_dcache_range(ALIGN_DOWN(start,
+						      CONFIG_SYS_CACHELINE_SIZE),
+					   ALIGN(end,
+						 CONFIG_SYS_CACHELINE_SIZE));
 	}
 #elif defined(CONFIG_VIDEO_SANDBOX_SDL)
-	struct video_priv *priv = dev_get_uclass_priv(vid);
 	static ulong last_sync;
 
 	if (force || get_timer(last_sync) > 10) {
@@ -214,6 +224,9 @@ int video_sync(struct udevice *vid, bool force)
 		last_sync = get_timer(0);
 	}
 #endif
+	priv->damage_start = 0;
+	priv->damage_end = 0;
+
 	return 0;
 }
 
@@ -261,54 +274,79 @@ int video_get_ysize(struct udevice *dev)
 	return priv->ysize;
 }
 
-#ifdef CONFIG_VIDEO_COPY
+/**
+ * video_damage() - Record that part of the frame buffer has changed
+ *
+ * The region is widened to whole lines, since the consoles update a character
+ * cell at a time and the lines in between are usually touched as well.
+ *
+ * @priv: Video device private data
+ * @offset: Offset of the first changed byte
+ * @size: Number of bytes changed
+ */
+static void video_damage(struct video_priv *priv, long offset, long size)
+{
+	int start, end;
+
+	if (!priv->line_length || size <= 0)
+		return;
+	start = offset - offset % priv->line_length;
+	end = min((long)priv->fb_size, roundup(offset + size,
+					       priv->line_length));
+	if (priv->damage_end > priv->damage_start) {
+		start = min(start, priv->damage_start);
+		end = max(end, priv->damage_end);
+	}
+	priv->damage_start = start;
+	priv->damage_end = end;
+}
+
 int video_sync_copy(struct udevice *dev, void *from, void *to)
 {
 	struct video_priv *priv = dev_get_uclass_priv(dev);
+	long offset, size;
 
-	if (priv->copy_fb) {
-		long offset, size;
-
-		/* Find the offset of the first byte to copy */
-		if ((ulong)to > (ulong)from) {
-			size = to - from;
-			offset = from - priv->fb;
-		} else {
-			size = from - to;
-			offset = to - priv->fb;
-		}
+	/* Find the offset of the first byte to copy */
+	if ((ulong)to > (ulong)from) {
+		size = to - from;
+		offset = from - priv->fb;
+	} else {
+		size = from - to;
+		offset = to - priv->fb;
+	}
 
-		/*
-		 * Allow a bit of leeway for valid requests somewhere near the
-		 * frame buffer
-		 */
-		if (offset < -priv->fb_size || offset > 2 * priv->fb_size) {
+	/*
+	 * Allow a bit of leeway for valid requests somewhere near the frame
+	 * buffer
+	 */
+	if (offset < -priv->fb_size || offset > 2 * priv->fb_size) {
 #ifdef DEBUG
-			char str[120];
+		char str[120];
 
-			snprintf(str, sizeof(str),
-				 "[** FAULT sync_copy fb=%p, from=%p, to=%p, offset=%lx]",
-				 priv->fb, from, to, offset);
-			console_puts_select_stderr(true, str);
+		snprintf(str, sizeof(str),
+			 "[** FAULT sync_copy fb=%p, from=%p, to=%p, offset=%lx]",
+			 priv->fb, from, to, offset);
+		console_puts_select_stderr(true, str);
 #endif
-			return -EFAULT;
-		}
+		return -EFAULT;
+	}
 
-		/*
-		 * Silently crop the memcpy. This allows callers to avoid doing
-		 * this themselves. It is common for the end pointer to go a
-		 * few lines after the end of the frame buffer, since most of
-		 * the update algorithms terminate a line after their last write
-		 */
-		if (offset + size > priv->fb_size) {
-			size = priv->fb_size - offset;
-		} else if (offset < 0) {
-			size += offset;
-			offset = 0;
-		}
+	/*
+	 * Silently crop the region. This allows callers to avoid doing this
+	 * themselves. It is common for the end pointer to go a few lines after
+	 * the end of the frame buffer, since most of the update algorithms
+	 * terminate a line after their last write
+	 */
+	if (offset + size > priv->fb_size) {
+		size = priv->fb_size - offset;
+	} else if (offset < 0) {
+		size += offset;
+		offset = 0;
+	}
 
+	if (IS_ENABLED(CONFIG_VIDEO_COPY) && priv->copy_fb)
 		memcpy(priv->copy_fb + offset, priv->fb + offset, size);
-	}
+	video_damage(priv, offset, size);
 
 	return 0;
 }
@@ -322,7 +360,148 @@ int video_sync_copy_all(struct udevice *dev)
 	return 0;
 }
 
+/**
+ * video_move_mem() - Move part of the frame buffer
+ *
+ * With CONFIG_VIDEO_DMA this tries to use a DMA engine. Since the regions
+ * normally overlap, the transfer is split into pieces no larger than the
+ * distance moved, done in an order which does not overwrite data that is
+ * still to be read. memmove() is used for anything the DMA engine cannot do.
+ *
+ * @priv: Video device private data
+ * @dst: Destination address
+ * @src: Source address
+ * @size: Number of bytes to move
+ */
+static void video_move_mem(struct video_priv *priv, void *dst, const void *src,
+			   int size)
+{
+#if CONFIG_IS_ENABLED(VIDEO_DMA)
+	long gap = dst > src ? dst - src : src - dst;
+	int done = 0;
+
+	if (size >= SZ_4K && gap &&
+	    IS_ALIGNED((ulong)dst | gap, ARCH_DMA_MINALIGN)) {
+		/* Write back what the CPU drew, so the DMA engine sees it */
+		flush_dcache_range(ALIGN_DOWN((ulong)src, ARCH_DMA_MINALIGN),
+				   ALIGN((ulong)src + size, ARCH_DMA_MINALIGN));
+		while (done < size) {
+			int len = min_t(long, gap, size - done);
+			int pos = dst < src ? done : size - done - len;
+
+			if (dma_memcpy(dst + pos, (void *)src + pos, len) < 0)
+				break;
+			done += len;
+		}
+		if (done == size)
+			return;
+		if (dst < src) {
+			dst += done;
+			src += done;
+		}
+		size -= done;
+	}
 #endif
+	memmove(dst, src, size);
+}
+
+/**
+ * video_scroll_hw() - Scroll the display up by moving the displayed area
+ *
+ * @dev: Video device
+ * @delta: Number of bytes to scroll by (a multiple of the line length)
+ * Return: 0 if OK, -ve on error, in which case nothing is changed
+ */
+static int video_scroll_hw(struct udevice *dev, long delta)
+{
+	struct video_uc_plat *plat = dev_get_uclass_plat(dev);
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_ops *ops = video_get_ops(dev);
+	void *base = priv->fb - priv->pan_offset;
+	ulong offset = priv->pan_offset + delta;
+	ulong limit = plat->size;
+	int ret;
+
+	/* A copy frame buffer placed in the same memory limits the space */
+	if (priv->copy_fb && plat->copy_base > plat->base &&
+	    plat->copy_base - plat->base < limit)
+		limit = plat->copy_base - plat->base;
+
+	if (offset + priv->fb_size <= limit) {
+		ret = ops->set_offset(dev, offset);
+		if (ret)
+			return ret;
+		priv->fb += delta;
+		if (priv->copy_fb)
+			priv->copy_fb += delta;
+		priv->pan_offset = offset;
+
+		/* Anything still to flush has moved up the display */
+		priv->damage_start = max(priv->damage_start - delta, 0L);
+		priv->damage_end = max(priv->damage_end - delta, 0L);
+
+		return 0;
+	}
+
+	/* Without any space to move into, the display has to be copied */
+	if (!priv->pan_offset)
+		return -ENOSPC;
+
+	/*
+	 * We have reached the end of the memory, so move the display back to
+	 * the start. This only happens once for each screen-full of scrolling.
+	 */
+	video_move_mem(priv, base, priv->fb + delta, priv->fb_size - delta);
+	ret = ops->set_offset(dev, 0);
+	if (ret)
+		return ret;
+	if (priv->copy_fb)
+		priv->copy_fb -= priv->pan_offset;
+	priv->fb = base;
+	priv->pan_offset = 0;
+
+	return video_sync_copy(dev, base, base + priv->fb_size - delta);
+}
+
+int video_fix_offset(struct udevice *dev)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_ops *ops = video_get_ops(dev);
+	void *base = priv->fb - priv->pan_offset;
+	int ret;
+
+	priv->no_pan = true;
+	if (!priv->pan_offset)
+		return 0;
+
+	video_move_mem(priv, base, priv->fb, priv->fb_size);
+	ret = ops->set_offset(dev, 0);
+	if (ret)
+		return ret;
+	if (priv->copy_fb)
+		priv->copy_fb -= priv->pan_offset;
+	priv->fb = base;
+	priv->pan_offset = 0;
+
+	return video_sync_copy(dev, base, base + priv->fb_size);
+}
+
+int video_memmove(struct udevice *dev, void *dst, const void *src, int size)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_ops *ops = video_get_ops(dev);
+
+	/* Scrolling the whole display up can be done in hardware */
+	if (ops && ops->set_offset && !priv->no_pan && dst == priv->fb &&
+	    src > dst &&
+	    src + size == priv->fb + priv->fb_size &&
+	    !video_scroll_hw(dev, src - dst))
+		return 0;
+
+	video_move_mem(priv, dst, src, size);
+
+	return video_sync_copy(dev, dst, dst + size);
+}
 
 #define SPLASH_DECL(_name) \
 	extern u8 __splash_ ## _name ## _begin[]; \
@@ -419,6 +598,12 @@ static int video_post_probe(struct udevice *dev)
 	return 0;
 };
 
+/* Leave the display at the start of the frame buffer, for the OS */
+static int video_pre_remove(struct udevice *dev)
+{
+	return video_fix_offset(dev);
+}
+
 /* Post-relocation, allocate memory for the frame buffer */
 static int video_post_bind(struct udevice *dev)
 {
@@ -459,6 +644,7 @@ UCLASS_DRIVER(video) = {
 	.flags		= DM_UC_FLAG_SEQ_ALIAS,
 	.post_bind	= video_post_bind,
 	.post_probe	= video_post_probe,
+	.pre_remove	= video_pre_remove,
 	.priv_auto	= sizeof(struct video_uc_priv),
 	.per_device_auto	= sizeof(struct video_priv),
 	.per_device_plat_auto	= sizeof(struct video_uc_plat),
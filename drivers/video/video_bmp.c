@@ -7,11 +7,14 @@
 #include <bmp_layout.h>
 #include <dm.h>
 #include <log.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <splash.h>
 #include <video.h>
 #include <watchdog.h>
+#include <asm/byteorder.h>
 #include <asm/unaligned.h>
+#include <u-boot/lz4.h>
 
 #define BMP_RLE8_ESCAPE		0
 #define BMP_RLE8_EOL		0
@@ -229,6 +232,243 @@ static void video_splash_align_axis(int *axis, unsigned long panel_size,
 	*axis = max(0, (int)axis_alignment);
 }
 
+/**
+ * typedef bmp_row_func - Convert a line of a BMP image into frame-buffer pixels
+ *
+ * @dst: Place in frame buffer to write
+ * @src: Start of the line in the BMP image
+ * @width: Number of pixels to convert
+ * @lut: Palette converted to frame-buffer pixel values (8bpp images only)
+ */
+typedef void (*bmp_row_func)(void *dst, const u8 *src, int width,
+			     const u32 *lut);
+
+static void bmp_row_copy8(void *dst, const u8 *src, int width, const u32 *lut)
+{
+	memcpy(dst, src, width);
+}
+
+static void bmp_row_copy16(void *dst, const u8 *src, int width, const u32 *lut)
+{
+	memcpy(dst, src, width * 2);
+}
+
+static void bmp_row_copy32(void *dst, const u8 *src, int width, const u32 *lut)
+{
+	memcpy(dst, src, width * 4);
+}
+
+static void bmp_row_pal16(void *dst, const u8 *src, int width, const u32 *lut)
+{
+	u16 *out = dst;
+
+	while (width--)
+		*out++ = lut[*src++];
+}
+
+static void bmp_row_pal32(void *dst, const u8 *src, int width, const u32 *lut)
+{
+	u32 *out = dst;
+
+	while (width--)
+		*out++ = lut[*src++];
+}
+
+static void bmp_row_24_16(void *dst, const u8 *src, int width, const u32 *lut)
+{
+	u16 *out = dst;
+
+	for (; width--; src += 3)
+		*out++ = (src[2] >> 3) << 11 | (src[1] >> 2) << 5 | src[0] >> 3;
+}
+
+static void bmp_row_24_32(void *dst, const u8 *src, int width, const u32 *lut)
+{
+	u32 *out = dst;
+
+	for (; width--; src += 3)
+		*out++ = cpu_to_le32(src[0] | src[1] << 8 | src[2] << 16);
+}
+
+static void bmp_row_24_x2r10g10b10(void *dst, const u8 *src, int width,
+				   const u32 *lut)
+{
+	u32 *out = dst;
+
+	for (; width--; src += 3)
+		*out++ = cpu_to_le32(src[0] << 2 | src[1] << 12 | src[2] << 22);
+}
+
+static void bmp_row_32_x2r10g10b10(void *dst, const u8 *src, int width,
+				   const u32 *lut)
+{
+	u32 *out = dst;
+
+	for (; width--; src += 4)
+		*out++ = cpu_to_le32(src[0] << 2 | src[1] << 12 |
+				     src[2] << 22 | (src[3] >> 6) << 30);
+}
+
+/**
+ * bmp_get_row_func() - Find the line converter for a BMP image and display
+ *
+ * @bmp_bpix: Bits per pixel of the BMP image
+ * @bpix: Bits per pixel of the display
+ * @eformat: Pixel format of the display
+ * Return: function to use, or NULL to fall back to converting each pixel with
+ *	write_pix8()
+ */
+static bmp_row_func bmp_get_row_func(uint bmp_bpix, uint bpix,
+				     enum video_format eformat)
+{
+	switch (bmp_bpix) {
+	case 8:
+		if (bpix == 8)
+			return bmp_row_copy8;
+		if (bpix == 16)
+			return bmp_row_pal16;
+		if (bpix == 32)
+			return bmp_row_pal32;
+		break;
+	case 16:
+		return bmp_row_copy16;
+	case 24:
+		if (bpix == 16)
+			return bmp_row_24_16;
+		if (eformat == VIDEO_X2R10G10B10)
+			return bmp_row_24_x2r10g10b10;
+		return bmp_row_24_32;
+	case 32:
+		if (eformat == VIDEO_X2R10G10B10)
+			return bmp_row_32_x2r10g10b10;
+		return bmp_row_copy32;
+	}
+
+	return NULL;
+}
+
+/**
+ * bmp_build_lut() - Convert a BMP palette into frame-buffer pixel values
+ *
+ * This gives the same values as write_pix8() writes for each palette entry.
+ *
+ * @lut: Returns the 256 pixel values
+ * @bpix: Bits per pixel of the display (16 or 32)
+ * @eformat: Pixel format of the display
+ * @palette: BMP palette
+ * @count: Number of entries in @palette; the rest of @lut is set to 0
+ */
+static void bmp_build_lut(u32 *lut, uint bpix, enum video_format eformat,
+			  struct bmp_color_table_entry *palette, int count)
+{
+	int i;
+
+	for (i = 0; i < 256; i++) {
+		struct bmp_color_table_entry *cte = &palette[i];
+
+		if (i >= count)
+			lut[i] = 0;
+		else if (bpix == 16)
+			lut[i] = get_bmp_col_16bpp(*cte);
+		else if (eformat == VIDEO_X2R10G10B10)
+			lut[i] = get_bmp_col_x2r10g10b10(cte);
+		else
+			lut[i] = cpu_to_le32(cte->blue | cte->green << 8 |
+					     cte->red << 16);
+	}
+}
+
+int video_raw_display(struct udevice *dev, ulong addr, int x, int y,
+		      bool align)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_raw_header *hdr = map_sysmem(addr, 0);
+	uint bytes = VNBYTES(priv->bpix);
+	ulong width, height, stride, size, len;
+	enum video_format format, eformat;
+	void *data, *buf = NULL;
+	uchar *start, *fb;
+	int i, ret;
+
+	if (get_unaligned_le32(&hdr->magic) != VIDEO_RAW_MAGIC)
+		return -EINVAL;
+	width = get_unaligned_le16(&hdr->width);
+	height = get_unaligned_le16(&hdr->height);
+	size = get_unaligned_le32(&hdr->size);
+	stride = width * bytes;
+	data = hdr + 1;
+
+	/* Treat an unknown 32bpp format as the usual XRGB */
+	format = hdr->format == VIDEO_UNKNOWN ? VIDEO_X8R8G8B8 : hdr->format;
+	eformat = priv->format == VIDEO_UNKNOWN ? VIDEO_X8R8G8B8 : priv->format;
+	if (hdr->bpix != priv->bpix || (bytes == 4 && format != eformat)) {
+		printf("Error: raw image does not match the display format\n");
+		return -EPERM;
+	}
+
+	if (align) {
+		video_splash_align_axis(&x, priv->xsize, width);
+		video_splash_align_axis(&y, priv->ysize, height);
+	}
+	if (x < 0 || y < 0 || x >= priv->xsize || y >= priv->ysize)
+		return -EINVAL;
+	start = priv->fb + y * priv->line_length + x * bytes;
+
+	switch (hdr->comp) {
+	case VIDEO_RAW_COMP_NONE:
+		if (size < stride * height)
+			return -EINVAL;
+		break;
+	case VIDEO_RAW_COMP_LZ4:
+		if (!IS_ENABLED(CONFIG_LZ4))
+			return -EPROTONOSUPPORT;
+
+		/* If the lines match the display, decompress straight into it */
+		len = stride * height;
+		if (!x && stride == priv->line_length &&
+		    y + height <= priv->ysize) {
+			ret = ulz4fn(data, size, start, &len);
+			if (ret)
+				return log_ret(ret);
+			goto done;
+		}
+		buf = malloc(len);
+		if (!buf)
+			return -ENOMEM;
+		ret = ulz4fn(data, size, buf, &len);
+		if (!ret && len != stride * height)
+			ret = -EINVAL;
+		if (ret) {
+			free(buf);
+			return log_ret(ret);
+		}
+		data = buf;
+		break;
+	default:
+		return -EPROTONOSUPPORT;
+	}
+
+	if (y + height > priv->ysize)
+		height = priv->ysize - y;
+	if (!x && stride == priv->line_length) {
+		memcpy(start, data, stride * height);
+	} else {
+		len = min(width, (ulong)priv->xsize - x) * bytes;
+		for (i = 0, fb = start; i < height; i++) {
+			memcpy(fb, data, len);
+			data += stride;
+			fb += priv->line_length;
+		}
+	}
+	free(buf);
+done:
+	ret = video_sync_copy(dev, start, start + height * priv->line_length);
+	if (ret)
+		return log_ret(ret);
+
+	return video_sync(dev, false);
+}
+
 int video_bmp_display(struct udevice *dev, ulong bmp_image, int x, int y,
 		      bool align)
 {
@@ -243,9 +483,16 @@ int video_bmp_display(struct udevice *dev, ulong bmp_image, int x, int y,
 	unsigned colours, bpix, bmp_bpix;
 	enum video_format eformat;
 	struct bmp_color_table_entry *palette;
+	unsigned long bmp_width, stride;
+	bmp_row_func row_func = NULL;
+	u32 lut[256];
 	int hdr_size;
 	int ret;
 
+	if (IS_ENABLED(CONFIG_VIDEO_RAW_IMAGE) && bmp &&
+	    get_unaligned_le32(bmp) == VIDEO_RAW_MAGIC)
+		return video_raw_display(dev, bmp_image, x, y, align);
+
 	if (!bmp || !(bmp->header.signature[0] == 'B' &&
 	    bmp->header.signature[1] == 'M')) {
 		printf("Error: no valid bmp image at %lx\n", bmp_image);
@@ -254,6 +501,7 @@ int video_bmp_display(struct udevice *dev, ulong bmp_image, int x, int y,
 	}
 
 	width = get_unaligned_le32(&bmp->header.width);
+	bmp_width = width;
 	height = get_unaligned_le32(&bmp->header.height);
 	bmp_bpix = get_unaligned_le16(&bmp->header.bit_count);
 	hdr_size = get_unaligned_le16(&bmp->header.size);
@@ -324,6 +572,21 @@ int video_bmp_display(struct udevice *dev, ulong bmp_image, int x, int y,
 		}
 
 		/* Not compressed */
+		if (bmp_bpix == 8) {
+			row_func = bmp_get_row_func(bmp_bpix, bpix, eformat);
+			if (bpix == 16 || bpix == 32) {
+				int count;
+
+				count = get_unaligned_le32(
+						&bmp->header.data_offset) -
+					14 - hdr_size;
+				bmp_build_lut(lut, bpix, eformat, palette,
+					      count / 4);
+			}
+			if (row_func)
+				break;
+		}
+
 		byte_width = width * (bpix / 8);
 		if (!byte_width)
 			byte_width = width;
@@ -340,82 +603,32 @@ int video_bmp_display(struct udevice *dev, ulong bmp_image, int x, int y,
 		}
 		break;
 	case 16:
-		if (IS_ENABLED(CONFIG_BMP_16BPP)) {
-			for (i = 0; i < height; ++i) {
-				WATCHDOG_RESET();
-				for (j = 0; j < width; j++) {
-					*fb++ = *bmap++;
-					*fb++ = *bmap++;
-				}
-				bmap += (padded_width - width);
-				fb -= width * 2 + priv->line_length;
-			}
-		}
+		if (IS_ENABLED(CONFIG_BMP_16BPP))
+			row_func = bmp_get_row_func(bmp_bpix, bpix, eformat);
 		break;
 	case 24:
-		if (IS_ENABLED(CONFIG_BMP_24BPP)) {
-			for (i = 0; i < height; ++i) {
-				for (j = 0; j < width; j++) {
-					if (bpix == 16) {
-						/* 16bit 565RGB format */
-						*(u16 *)fb = ((bmap[2] >> 3)
-							<< 11) |
-							((bmap[1] >> 2) << 5) |
-							(bmap[0] >> 3);
-						bmap += 3;
-						fb += 2;
-					} else if (eformat == VIDEO_X2R10G10B10) {
-						u32 pix;
-
-						pix = *bmap++ << 2U;
-						pix |= *bmap++ << 12U;
-						pix |= *bmap++ << 22U;
-						*fb++ = pix & 0xff;
-						*fb++ = (pix >> 8) & 0xff;
-						*fb++ = (pix >> 16) & 0xff;
-						*fb++ = pix >> 24;
-					} else {
-						*fb++ = *bmap++;
-						*fb++ = *bmap++;
-						*fb++ = *bmap++;
-						*fb++ = 0;
-					}
-				}
-				fb -= priv->line_length + width * (bpix / 8);
-				bmap += (padded_width - width);
-			}
-		}
+		if (IS_ENABLED(CONFIG_BMP_24BPP))
+			row_func = bmp_get_row_func(bmp_bpix, bpix, eformat);
 		break;
 	case 32:
-		if (IS_ENABLED(CONFIG_BMP_32BPP)) {
-			for (i = 0; i < height; ++i) {
-				for (j = 0; j < width; j++) {
-					if (eformat == VIDEO_X2R10G10B10) {
-						u32 pix;
-
-						pix = *bmap++ << 2U;
-						pix |= *bmap++ << 12U;
-						pix |= *bmap++ << 22U;
-						pix |= (*bmap++ >> 6) << 30U;
-						*fb++ = pix & 0xff;
-						*fb++ = (pix >> 8) & 0xff;
-						*fb++ = (pix >> 16) & 0xff;
-						*fb++ = pix >> 24;
-					} else {
-						*fb++ = *bmap++;
-						*fb++ = *bmap++;
-						*fb++ = *bmap++;
-						*fb++ = *bmap++;
-					}
-				}
-				fb -= priv->line_length + width * (bpix / 8);
-			}
-		}
+		if (IS_ENABLED(CONFIG_BMP_32BPP))
+			row_func = bmp_get_row_func(bmp_bpix, bpix, eformat);
 		break;
 	default:
 		break;
 	};
 
+	/* Convert a line at a time, from the bottom up as stored in the file */
+	if (row_func) {
+		stride = ALIGN(bmp_width * bmp_bpix / 8, 4);
+		for (i = 0; i < height; ++i) {
+			WATCHDOG_RESET();
+			row_func(fb, bmap, width, lut);
+			bmap += stride;
+			fb -= priv->line_length;
+		}
+	}
+
 	/* Find the position of the top left of the image in the framebuffer */
 	fb = (uchar *)(priv->fb + y * priv->line_length + x * bpix / 8);
 	ret = video_sync_copy(dev, start, fb);
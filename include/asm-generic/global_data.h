@@ -22,6 +22,7 @@
 #ifndef __ASSEMBLY__
 #include <fdtdec.h>
 #include <membuff.h>
+#include <perf_counter.h>
 #include <linux/list.h>
 #include <linux/build_bug.h>
 #include <asm-offsets.h>
@@ -373,6 +374,15 @@ struct global_data {
 	 */
 	struct bootstage_data *new_bootstage;
 #endif
+#ifdef CONFIG_PERF_COUNTER
+	/**
+	 * @perf_info: hardware performance-counter state
+	 *
+	 * This is not kept in .bss since bootstage reads the counters before
+	 * relocation.
+	 */
+	struct perf_counter_info perf_info;
+#endif
 #ifdef CONFIG_LOG
 	/**
 	 * @log_drop_count: number of dropped log messages
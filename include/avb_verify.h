@@ -28,6 +28,9 @@ struct AvbOpsData {
 	struct AvbOps ops;
 	int mmc_dev;
 	enum avb_boot_state boot_state;
+#ifdef CONFIG_AVB_PRELOAD
+	ulong preload_top;
+#endif
 #ifdef CONFIG_OPTEE_TA_AVB
 	struct udevice *tee;
 	u32 session;
@@ -49,6 +52,17 @@ enum mmc_io_type {
 AvbOps *avb_ops_alloc(int boot_device);
 void avb_ops_free(AvbOps *ops);
 
+/**
+ * avb_ops_reset_preload() - reuse the preload area from its start
+ *
+ * Call this before each slot verification. Partitions preloaded for an
+ * earlier verification are dropped, so their slot data must no longer be in
+ * use.
+ *
+ * @ops: AVB ops from avb_ops_alloc()
+ */
+void avb_ops_reset_preload(AvbOps *ops);
+
 char *avb_set_state(AvbOps *ops, enum avb_boot_state boot_state);
 char *avb_set_enforce_verity(const char *cmdline);
 char *avb_set_ignore_corruption(const char *cmdline);
@@ -8,6 +8,7 @@
 #define BLK_H
 
 #include <efi.h>
+#include <io_stats.h>
 
 #ifdef CONFIG_SYS_64BIT_LBA
 typedef uint64_t lbaint_t;
@@ -99,6 +100,9 @@ struct blk_desc {
 	 * device. Once these functions are removed we can drop this field.
 	 */
 	struct udevice *bdev;
+#if CONFIG_IS_ENABLED(BLK_STATS)
+	struct io_stats	stats;		/* request statistics */
+#endif
 #else
 	unsigned long	(*block_read)(struct blk_desc *block_dev,
 				      lbaint_t start,
@@ -442,6 +446,19 @@ int blk_get_from_parent(struct udevice *parent, struct udevice **devp);
  */
 struct blk_desc *blk_get_by_device(struct udevice *dev);
 
+/**
+ * blk_stats_fdt_add() - add block-device statistics to a devicetree
+ *
+ * This creates a 'blk' subnode of @parent, containing a node for each block
+ * device which has been used, as described in io_stats_fdt_add(). It does
+ * nothing unless CONFIG_BLK_STATS is enabled.
+ *
+ * @blob:	Devicetree to update
+ * @parent:	Offset of parent node
+ * Return: 0 if OK, -ve FDT error on failure
+ */
+int blk_stats_fdt_add(void *blob, int parent);
+
 #else
 #include <errno.h>
 /*
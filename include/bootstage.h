@@ -17,6 +17,7 @@
 enum bootstage_flags {
 	BOOTSTAGEF_ERROR	= 1 << 0,	/* Error record */
 	BOOTSTAGEF_ALLOC	= 1 << 1,	/* Allocate an id */
+	BOOTSTAGEF_NAMED	= 1 << 2,	/* Found by name */
 };
 
 /* bootstate sub-IDs used for kernel and ramdisk ranges */
@@ -292,12 +293,30 @@ ulong bootstage_mark_code(const char *file, const char *func,
  * absolute mark in time. Accumulators record the total amount of time spent
  * in an activty during boot.
  *
+ * Activities can be nested. The first time an activity is started, the
+ * innermost activity which is currently started (if any) is recorded as its
+ * parent, so that the report can show the time taken within each activity.
+ * Starting an activity which is already started has no effect, other than
+ * requiring a matching bootstage_accum() call.
+ *
  * @param id	Bootstage id to record this timestamp against
  * @param name	Textual name to display for this id in the report (maybe NULL)
  * Return: start timestamp in microseconds
  */
 uint32_t bootstage_start(enum bootstage_id id, const char *name);
 
+/**
+ * bootstage_start_name() - Mark the start of an activity identified by name
+ *
+ * This is like bootstage_start() but allocates an id the first time it sees
+ * @name, which is useful when there are many activities, such as probing each
+ * driver. The name is not copied until relocation, so must remain valid.
+ *
+ * @name:	Name of the activity
+ * Return: id to pass to bootstage_accum(), or 0 if there is no space
+ */
+int bootstage_start_name(const char *name);
+
 /**
  * Mark the end of a bootstage activity
  *
@@ -305,7 +324,8 @@ uint32_t bootstage_start(enum bootstage_id id, const char *name);
  * call this function to mark the end. You can call these functions in pairs
  * as many times as you like.
  *
- * @param id	Bootstage id to record this timestamp against
+ * @param id	Bootstage id to record this timestamp against (0 to do
+ *		nothing)
  * Return: time spent in this iteration of the activity (i.e. the time now
  *		less the start time recorded in the last bootstage_start() call
  *		with this id.
@@ -406,6 +426,11 @@ static inline uint32_t bootstage_start(enum bootstage_id id, const char *name)
 	return 0;
 }
 
+static inline int bootstage_start_name(const char *name)
+{
+	return 0;
+}
+
 static inline uint32_t bootstage_accum(enum bootstage_id id)
 {
 	return 0;
@@ -61,6 +61,22 @@ void dcache_disable(void);
 void mmu_disable(void);
 int mmu_status(void);
 
+struct mm_region;
+
+/**
+ * mmu_setup_early() - Enable the MMU and data cache in SPL
+ *
+ * This builds the page tables in the memory set aside by
+ * CONFIG_SPL_MMU_EARLY_TABLE_ADDR and enables the MMU and data cache. It can be
+ * called again to change the memory map, e.g. to add the DRAM once it is set
+ * up.
+ *
+ * @map: Memory map to use, terminated by an empty entry, or NULL to use
+ *	mem_map. Before DRAM is set up this must not include the DRAM, since the
+ *	CPU may access any normal memory speculatively.
+ */
+void mmu_setup_early(struct mm_region *map);
+
 /* arch/$(ARCH)/lib/cache.c */
 void enable_caches(void);
 void flush_cache(unsigned long addr, unsigned long size);
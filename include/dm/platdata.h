@@ -23,6 +23,9 @@
  * @plat:	Driver-specific platform data
  * @plat_size: Size of platform data structure
  * @parent_idx:	Index of the parent driver_info structure
+ * @drv:	Driver to use, set by dtoc with OF_PLATDATA_DRIVER_REF so that it
+ *		does not need to be looked up by @name. If NULL, as in records
+ *		written by hand, the driver is looked up by @name
  */
 struct driver_info {
 	const char *name;
@@ -31,6 +34,9 @@ struct driver_info {
 	unsigned short plat_size;
 	short parent_idx;
 #endif
+#if CONFIG_IS_ENABLED(OF_PLATDATA_DRIVER_REF)
+	struct driver *drv;
+#endif
 };
 
 #if CONFIG_IS_ENABLED(OF_PLATDATA)
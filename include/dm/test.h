@@ -148,6 +148,8 @@ extern struct unit_test_state global_dm_test_state;
  *	2=upside down, 3=90 degree counterclockwise)
  * @vidconsole_drv_name: Name of video console driver (set by tests)
  * @font_size: Console font size to select (set by tests)
+ * @pan: Allow the display to be moved within the frame buffer with
+ *	set_offset() (set by tests)
  */
 struct sandbox_sdl_plat {
 	int xres;
@@ -156,6 +158,7 @@ struct sandbox_sdl_plat {
 	int rot;
 	const char *vidconsole_drv_name;
 	int font_size;
+	bool pan;
 };
 
 /**
@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Statistics for storage operations
+ *
+ * These are collected by the block and MTD uclasses for each device, so that
+ * the time spent in the device can be separated from the time spent in the
+ * filesystem above it.
+ */
+
+#ifndef __IO_STATS_H
+#define __IO_STATS_H
+
+#include <linux/types.h>
+
+/*
+ * Number of histogram buckets. Bucket 0 holds zero values and bucket n holds
+ * values from 2^(n-1) to 2^n - 1, with the last bucket holding everything
+ * larger.
+ */
+#define IO_STATS_BUCKETS	32
+
+/**
+ * enum io_stats_op - type of storage operation
+ *
+ * @IO_STATS_READ: Read
+ * @IO_STATS_WRITE: Write
+ * @IO_STATS_ERASE: Erase
+ * @IO_STATS_OP_COUNT: Number of operation types
+ */
+enum io_stats_op {
+	IO_STATS_READ,
+	IO_STATS_WRITE,
+	IO_STATS_ERASE,
+
+	IO_STATS_OP_COUNT,
+};
+
+/**
+ * struct io_op_stats - statistics for one type of operation
+ *
+ * @requests: Number of requests
+ * @errors: Number of requests which failed
+ * @bytes: Number of bytes transferred (or erased)
+ * @time_us: Total time taken by the device, in microseconds
+ * @max_us: Longest time taken by a request, in microseconds
+ * @size_hist: Histogram of request sizes in bytes
+ * @time_hist: Histogram of request latencies in microseconds
+ */
+struct io_op_stats {
+	u32 requests;
+	u32 errors;
+	u64 bytes;
+	u64 time_us;
+	u32 max_us;
+	u32 size_hist[IO_STATS_BUCKETS];
+	u32 time_hist[IO_STATS_BUCKETS];
+};
+
+/**
+ * struct io_stats - statistics for a storage device
+ *
+ * @op: Statistics for each operation, indexed by enum io_stats_op
+ * @cache_hits: Number of reads satisfied from a cache without accessing the
+ *	device. These are not included in @op
+ */
+struct io_stats {
+	struct io_op_stats op[IO_STATS_OP_COUNT];
+	u32 cache_hits;
+};
+
+/**
+ * io_stats_add() - record a completed request
+ *
+ * @stats: Statistics to update
+ * @op: Type of operation
+ * @bytes: Number of bytes transferred
+ * @start_us: Value of timer_get_us() when the request started
+ * @ok: true if the request succeeded, false if it failed
+ */
+void io_stats_add(struct io_stats *stats, enum io_stats_op op, u64 bytes,
+		  ulong start_us, bool ok);
+
+/**
+ * io_stats_clear() - clear all statistics
+ *
+ * @stats: Statistics to clear
+ */
+void io_stats_clear(struct io_stats *stats);
+
+/**
+ * io_stats_active() - check if any requests have been recorded
+ *
+ * @stats: Statistics to check
+ * Return: true if there is something to show, false if not
+ */
+bool io_stats_active(const struct io_stats *stats);
+
+/**
+ * io_stats_print() - print statistics
+ *
+ * This shows one line for each type of operation which has been used, with
+ * the number of requests, the amount of data, the time taken and the
+ * throughput.
+ *
+ * @stats: Statistics to print
+ * @verbose: true to show the size and latency histograms too
+ */
+void io_stats_print(const struct io_stats *stats, bool verbose);
+
+/**
+ * io_stats_fdt_add() - add statistics to a devicetree
+ *
+ * This creates a subnode of @parent called @name, with properties such as
+ * 'read-requests', 'read-bytes' and 'read-us' for each type of operation which
+ * has been used. The histograms are added as 'read-size-hist' and
+ * 'read-time-hist' cell arrays, in the bucket order used by struct
+ * io_op_stats.
+ *
+ * @blob: Devicetree to update
+ * @parent: Offset of parent node
+ * @name: Name of node to create
+ * @stats: Statistics to add
+ * Return: 0 if OK, -ve FDT error on failure
+ */
+int io_stats_fdt_add(void *blob, int parent, const char *name,
+		     const struct io_stats *stats);
+
+#endif
@@ -7,9 +7,58 @@
 #include <linux/types.h>
 #include <asm/dma-mapping.h>
 #include <cpu_func.h>
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+#include <asm/system.h>
+#endif
 
 #define dma_mapping_error(x, y)	0
 
+/* Number of separate address ranges held in a struct dma_sync_batch */
+#define DMA_SYNC_BATCH_RANGES	8
+
+/**
+ * struct dma_sync_batch - Cache maintenance for several DMA buffers at once
+ *
+ * Buffers are added with dma_sync_batch_add() and the cache operations are
+ * carried out by dma_sync_batch_run(). Adjacent and overlapping buffers are
+ * merged, so a transfer split into consecutive chunks needs a single range
+ * operation. Buffers in the non-cached region are skipped.
+ *
+ * @dir: Direction of the DMA
+ * @for_cpu: true to hand the buffers back to the CPU after the DMA, false to
+ *	hand them to the device before it
+ * @count: Number of ranges in use
+ * @total: Total size of the ranges in bytes
+ * @start: Start address of each range, aligned to ARCH_DMA_MINALIGN
+ * @end: End address of each range, aligned to ARCH_DMA_MINALIGN
+ */
+struct dma_sync_batch {
+	enum dma_data_direction dir;
+	bool for_cpu;
+	int count;
+	ulong total;
+	ulong start[DMA_SYNC_BATCH_RANGES];
+	ulong end[DMA_SYNC_BATCH_RANGES];
+};
+
+/**
+ * dma_is_uncached() - Check if a buffer is in the non-cached region
+ *
+ * Such buffers never need cache maintenance.
+ *
+ * @vaddr: address of the buffer
+ * Return: true if the buffer was allocated by dma_alloc_uncached() from the
+ *	non-cached region
+ */
+static inline bool dma_is_uncached(const void *vaddr)
+{
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	return noncached_contains((ulong)vaddr);
+#else
+	return false;
+#endif
+}
+
 /**
  * Map a buffer to make it available to the DMA device
  *
@@ -31,6 +80,9 @@ static inline dma_addr_t dma_map_single(void *vaddr, size_t len,
 {
 	unsigned long addr = (unsigned long)vaddr;
 
+	if (dma_is_uncached(vaddr))
+		return addr;
+
 	len = ALIGN(len, ARCH_DMA_MINALIGN);
 
 	if (dir == DMA_FROM_DEVICE)
@@ -55,10 +107,78 @@ static inline dma_addr_t dma_map_single(void *vaddr, size_t len,
 static inline void dma_unmap_single(dma_addr_t addr, size_t len,
 				    enum dma_data_direction dir)
 {
+	if (dma_is_uncached((void *)(uintptr_t)addr))
+		return;
+
 	len = ALIGN(len, ARCH_DMA_MINALIGN);
 
 	if (dir != DMA_TO_DEVICE)
 		invalidate_dcache_range(addr, addr + len);
 }
 
+/**
+ * dma_alloc_uncached() - Allocate memory for DMA descriptors
+ *
+ * The memory is taken from the non-cached region (CONFIG_SYS_NONCACHED_MEMORY)
+ * when there is one, so that the CPU and the device can share it without any
+ * cache maintenance. Otherwise, or if that region is full, it comes from
+ * the heap and the caller must flush and invalidate it as usual.
+ * dma_map_single() and dma_unmap_single() do nothing for non-cached memory.
+ *
+ * The memory is zeroed and aligned to ARCH_DMA_MINALIGN. Note that the
+ * non-cached region is never reused once allocated, so this is best suited
+ * to rings and descriptors which are set up once per device.
+ *
+ * @len: number of bytes to allocate
+ * @handle: returns the DMA address of the memory
+ * Return: pointer to the memory, or NULL if out of memory
+ */
+void *dma_alloc_uncached(size_t len, dma_addr_t *handle);
+
+/**
+ * dma_free_uncached() - Free memory from dma_alloc_uncached()
+ *
+ * Memory from the non-cached region is not reclaimed.
+ *
+ * @vaddr: pointer to the memory, or NULL to do nothing
+ */
+void dma_free_uncached(void *vaddr);
+
+/**
+ * dma_sync_batch_init() - Set up a batch of cache operations
+ *
+ * @batch: batch to set up
+ * @dir: direction of the DMA
+ * @for_cpu: true if the DMA is complete and the buffers are being handed back
+ *	to the CPU, false if they are being handed to the device
+ */
+void dma_sync_batch_init(struct dma_sync_batch *batch,
+			 enum dma_data_direction dir, bool for_cpu);
+
+/**
+ * dma_sync_batch_add() - Add a buffer to a batch
+ *
+ * If the batch is full, the operations already collected are carried out
+ * first, so this must only be called at a point where the cache operation is
+ * valid for the buffer.
+ *
+ * @batch: batch to update
+ * @vaddr: address of the buffer
+ * @len: length of the buffer in bytes
+ */
+void dma_sync_batch_add(struct dma_sync_batch *batch, void *vaddr, size_t len);
+
+/**
+ * dma_sync_batch_run() - Carry out the cache operations for a batch
+ *
+ * This does the same as dma_map_single() (for the device) or
+ * dma_unmap_single() (for the CPU) on each buffer in the batch, then empties
+ * the batch. If the total size is at least CONFIG_DMA_SYNC_ALL_THRESHOLD, the
+ * whole data cache is flushed instead, which is faster for large amounts of
+ * data.
+ *
+ * @batch: batch to run
+ */
+void dma_sync_batch_run(struct dma_sync_batch *batch);
+
 #endif
@@ -22,6 +22,7 @@
 #include <linux/errno.h>
 #include <linux/list.h>
 #include <div64.h>
+#include <io_stats.h>
 #if IS_ENABLED(CONFIG_DM)
 #include <dm/device.h>
 #endif
@@ -295,6 +296,10 @@ struct mtd_info {
 
 	/* ECC status information */
 	struct mtd_ecc_stats ecc_stats;
+#if defined(__UBOOT__) && CONFIG_IS_ENABLED(MTD_STATS)
+	/* Request statistics, updated by the mtd_*() wrappers */
+	struct io_stats stats;
+#endif
 	/* Subpage shift (NAND) */
 	int subpage_sft;
 
@@ -592,6 +597,19 @@ void mtd_get_len_incl_bad(struct mtd_info *mtd, uint64_t offset,
 			  int *truncated);
 bool mtd_dev_list_updated(void);
 
+/**
+ * mtd_stats_fdt_add() - add MTD statistics to a devicetree
+ *
+ * This creates an 'mtd' subnode of @parent, containing a node for each MTD
+ * device or partition which has been used, as described in
+ * io_stats_fdt_add(). It does nothing unless CONFIG_MTD_STATS is enabled.
+ *
+ * @blob: Devicetree to update
+ * @parent: Offset of parent node
+ * Return: 0 if OK, -ve FDT error on failure
+ */
+int mtd_stats_fdt_add(void *blob, int parent);
+
 /* drivers/mtd/mtd_uboot.c */
 int mtd_search_alternate_name(const char *mtdname, char *altname,
 			      unsigned int max_len);
@@ -471,6 +471,51 @@ int os_setup_signal_handlers(void);
  */
 void os_signal_action(int sig, unsigned long pc);
 
+/**
+ * os_profile_timer() - start or stop the profiling timer
+ *
+ * While the timer runs, os_profile_action() is called from a SIGPROF handler
+ * each time the process has used @period_us microseconds of CPU time.
+ *
+ * @period_us:	sampling period in microseconds, or 0 to stop the timer
+ * Return:	0 for success, -1 on error
+ */
+int os_profile_timer(unsigned int period_us);
+
+/**
+ * os_profile_action() - record a profiling sample
+ *
+ * @pc:		program counter
+ * @fp:		frame pointer, or 0 if not known
+ * @sp:		stack pointer
+ */
+void os_profile_action(unsigned long pc, unsigned long fp, unsigned long sp);
+
+/**
+ * os_perf_counter_open() - open the host's performance counters
+ *
+ * This opens a counter for each entry in enum perf_counter_id, using
+ * perf_event_open(). Counters which the host does not allow or support are
+ * left closed.
+ *
+ * Return:	bitmask of the counters which were opened, BIT(id) for each
+ */
+unsigned int os_perf_counter_open(void);
+
+/**
+ * os_perf_counter_read() - read the host's performance counters
+ *
+ * @val:	returns the value of each open counter, indexed by enum
+ *		perf_counter_id
+ * @count:	number of entries in @val
+ */
+void os_perf_counter_read(unsigned long long *val, int count);
+
+/**
+ * os_perf_counter_close() - close the host's performance counters
+ */
+void os_perf_counter_close(void);
+
 /**
  * os_get_time_offset() - get time offset
  *
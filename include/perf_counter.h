@@ -0,0 +1,159 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Hardware performance counters
+ *
+ * These count CPU events such as cycles, instructions and cache misses, so
+ * that a slow piece of code can be identified as compute bound or memory
+ * bound.
+ */
+
+#ifndef __PERF_COUNTER_H
+#define __PERF_COUNTER_H
+
+#include <linux/errno.h>
+#include <linux/types.h>
+
+/**
+ * enum perf_counter_id - events which can be counted
+ *
+ * @PERF_COUNTER_CYCLES: CPU cycles
+ * @PERF_COUNTER_INSTRUCTIONS: Instructions retired
+ * @PERF_COUNTER_L1D_MISSES: Level-1 data-cache refills
+ * @PERF_COUNTER_L2D_MISSES: Level-2 (or last-level) data-cache refills
+ * @PERF_COUNTER_BRANCH_MISSES: Mispredicted branches
+ * @PERF_COUNTER_COUNT: Number of counters
+ */
+enum perf_counter_id {
+	PERF_COUNTER_CYCLES,
+	PERF_COUNTER_INSTRUCTIONS,
+	PERF_COUNTER_L1D_MISSES,
+	PERF_COUNTER_L2D_MISSES,
+	PERF_COUNTER_BRANCH_MISSES,
+
+	PERF_COUNTER_COUNT,
+};
+
+/**
+ * struct perf_counter_values - values of the counters
+ *
+ * This holds either a snapshot of the counters or the difference between two
+ * snapshots.
+ *
+ * @val: Value of each counter, indexed by enum perf_counter_id
+ * @valid: Bitmask of counters which are available, BIT(id) for each
+ */
+struct perf_counter_values {
+	u64 val[PERF_COUNTER_COUNT];
+	uint valid;
+};
+
+/**
+ * struct perf_counter_info - information about the available counters
+ *
+ * @started: true once the counters have been started
+ * @valid: Bitmask of counters which are available, BIT(id) for each
+ * @mask: Mask for the width of each counter, used to handle wrapping
+ */
+struct perf_counter_info {
+	bool started;
+	uint valid;
+	u64 mask[PERF_COUNTER_COUNT];
+};
+
+#if IS_ENABLED(CONFIG_PERF_COUNTER)
+
+/**
+ * perf_counter_read() - read the counters
+ *
+ * The counters are started on first use and then keep running.
+ *
+ * @vals: Returns the current value of each counter
+ * Return: 0 if OK, -ENOSYS if no counters are available
+ */
+int perf_counter_read(struct perf_counter_values *vals);
+
+/**
+ * perf_counter_delta() - work out the change in the counters
+ *
+ * Counters which wrap between @start and @end are handled, as long as they
+ * do not wrap more than once.
+ *
+ * @start: Counters at the start of the region
+ * @end: Counters at the end of the region
+ * @delta: Returns the change in each counter
+ */
+void perf_counter_delta(const struct perf_counter_values *start,
+			const struct perf_counter_values *end,
+			struct perf_counter_values *delta);
+
+/**
+ * perf_counter_add() - add the change in the counters to a total
+ *
+ * @total: Total to update
+ * @start: Counters at the start of the region
+ * @end: Counters at the end of the region
+ */
+void perf_counter_add(struct perf_counter_values *total,
+		      const struct perf_counter_values *start,
+		      const struct perf_counter_values *end);
+
+/**
+ * perf_counter_name() - get the name of a counter
+ *
+ * @id: Counter to check
+ * Return: name of the counter, e.g. "cycles"
+ */
+const char *perf_counter_name(enum perf_counter_id id);
+
+/**
+ * perf_counter_print() - print a set of counter values on one line
+ *
+ * This shows each available counter, followed by the instructions per cycle
+ * and the misses per thousand instructions where these can be worked out.
+ *
+ * @vals: Values to print, typically from perf_counter_delta()
+ */
+void perf_counter_print(const struct perf_counter_values *vals);
+
+/**
+ * perf_counter_stop() - stop the counters
+ *
+ * They are started again by the next call to perf_counter_read()
+ */
+void perf_counter_stop(void);
+
+#else
+
+static inline int perf_counter_read(struct perf_counter_values *vals)
+{
+	return -ENOSYS;
+}
+
+static inline void perf_counter_add(struct perf_counter_values *total,
+				    const struct perf_counter_values *start,
+				    const struct perf_counter_values *end)
+{
+}
+
+#endif
+
+/**
+ * arch_perf_counter_start() - start the architecture's counters
+ *
+ * @info: Returns information about the counters that were started
+ * Return: 0 if OK, -ve on error
+ */
+int arch_perf_counter_start(struct perf_counter_info *info);
+
+/** arch_perf_counter_stop() - stop the architecture's counters */
+void arch_perf_counter_stop(void);
+
+/**
+ * arch_perf_counter_read() - read the raw value of each counter
+ *
+ * @val: Returns the value of each counter, indexed by enum perf_counter_id.
+ *	Counters which are not available are left unchanged.
+ */
+void arch_perf_counter_read(u64 val[PERF_COUNTER_COUNT]);
+
+#endif
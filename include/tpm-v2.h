@@ -483,6 +483,30 @@ u32 tpm2_nv_define_space(struct udevice *dev, u32 space_index,
 u32 tpm2_pcr_extend(struct udevice *dev, u32 index, u32 algorithm,
 		    const u8 *digest, u32 digest_len);
 
+/**
+ * tpm2_algorithm_to_len() - Get the digest size of a hash algorithm
+ *
+ * @algorithm	Algorithm, defined in 'enum tpm2_algorithms'
+ *
+ * Return: size of the digest in bytes, or 0 if the algorithm is unknown
+ */
+u32 tpm2_algorithm_to_len(u16 algorithm);
+
+/**
+ * Issue a TPM2_PCR_Extend command for several PCR banks at once
+ *
+ * This extends the PCR in each bank listed in @digest_list with a single
+ * command, instead of one command per bank.
+ *
+ * @dev		TPM device
+ * @index	Index of the PCR
+ * @digest_list	Digests to extend with, at most one per bank
+ *
+ * Return: code of the operation
+ */
+u32 tpm2_pcr_extend_digests(struct udevice *dev, u32 index,
+			    const struct tpml_digest_values *digest_list);
+
 /**
  * Read data from the secure storage
  *
@@ -28,6 +28,7 @@ enum {
 enum trace_chunk_type {
 	TRACE_CHUNK_FUNCS,
 	TRACE_CHUNK_CALLS,
+	TRACE_CHUNK_SAMPLES,
 };
 
 /* A trace record for a function, as written to the profile output file */
@@ -101,4 +102,71 @@ int trace_early_init(void);
  */
 int trace_init(void *buff, size_t buff_size);
 
+/*
+ * Sampling profiler
+ *
+ * A TRACE_CHUNK_SAMPLES chunk holds rec_count 32-bit words. Each sample is a
+ * word giving the number of frames N, followed by N code offsets from the
+ * start of the text section. The first offset is the sampled PC and the
+ * others are return addresses, innermost first.
+ */
+
+/**
+ * profile_sample() - Record a sample
+ *
+ * This is called from the profiling timer interrupt. If a call chain is
+ * wanted, the frame pointer is followed as long as it stays within a sane
+ * distance above the stack pointer.
+ *
+ * @pc:		Program counter of the interrupted code
+ * @fp:		Frame pointer of the interrupted code, or 0 if not known
+ * @sp:		Stack pointer of the interrupted code
+ */
+void profile_sample(ulong pc, ulong fp, ulong sp);
+
+/**
+ * profile_start() - Start taking samples
+ *
+ * Samples are added to any already recorded, until the buffer is full.
+ *
+ * @period_us:	Sampling period in microseconds
+ * Return: 0 if OK, -ENOMEM if the buffer could not be allocated, other -ve on
+ * error from the timer
+ */
+int profile_start(uint period_us);
+
+/** profile_stop() - Stop taking samples */
+void profile_stop(void);
+
+/** profile_clear() - Drop all recorded samples */
+void profile_clear(void);
+
+/** profile_print_stats() - Print information about the samples taken */
+void profile_print_stats(void);
+
+/**
+ * profile_list_samples() - Dump the samples into a buffer
+ *
+ * This writes a struct trace_output_hdr followed by the sample words.
+ *
+ * @buff:	Buffer in which to place data
+ * @buff_size:	Size of buffer
+ * @needed:	Returns number of bytes used / needed
+ * Return: 0 if OK, -ENOSPC if the buffer is too small
+ */
+int profile_list_samples(void *buff, size_t buff_size, size_t *needed);
+
+/**
+ * arch_profile_start() - Start the periodic profiling timer
+ *
+ * The architecture must call profile_sample() on each tick.
+ *
+ * @period_us:	Sampling period in microseconds
+ * Return: 0 if OK, -ve on error
+ */
+int arch_profile_start(uint period_us);
+
+/** arch_profile_stop() - Stop the periodic profiling timer */
+void arch_profile_stop(void);
+
 #endif
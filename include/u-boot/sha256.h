@@ -15,6 +15,17 @@ typedef struct {
 	uint8_t buffer[64];
 } sha256_context;
 
+/**
+ * sha256_arch_blocks() - Hash whole blocks with an arch-specific transform
+ *
+ * @state:	Hash state to update
+ * @src:	Input data, @blocks * 64 bytes
+ * @blocks:	Number of blocks to hash
+ * Return: 0 if OK, -ENOSYS if the CPU does not support the transform, in
+ *	which case the generic code must be used
+ */
+int sha256_arch_blocks(uint32_t *state, const uint8_t *src, int blocks);
+
 void sha256_starts(sha256_context * ctx);
 void sha256_update(sha256_context *ctx, const uint8_t *input, uint32_t length);
 void sha256_finish(sha256_context * ctx, uint8_t digest[SHA256_SUM_LEN]);
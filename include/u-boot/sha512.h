@@ -18,6 +18,19 @@ typedef struct {
 
 extern const uint8_t sha512_der_prefix[];
 
+/**
+ * sha512_arch_blocks() - Hash whole blocks with an arch-specific transform
+ *
+ * This is used for SHA-384 too, since the two share the same block function.
+ *
+ * @state:	Hash state to update
+ * @src:	Input data, @blocks * SHA512_BLOCK_SIZE bytes
+ * @blocks:	Number of blocks to hash
+ * Return: 0 if OK, -ENOSYS if the CPU does not support the transform, in
+ *	which case the generic code must be used
+ */
+int sha512_arch_blocks(uint64_t *state, const uint8_t *src, int blocks);
+
 void sha512_starts(sha512_context * ctx);
 void sha512_update(sha512_context *ctx, const uint8_t *input, uint32_t length);
 void sha512_finish(sha512_context * ctx, uint8_t digest[SHA512_SUM_LEN]);
@@ -107,4 +107,46 @@ void aes_cbc_encrypt_blocks(u32 key_size, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
 void aes_cbc_decrypt_blocks(u32 key_size, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
 			    u32 num_aes_blocks);
 
+/**
+ * aes_ctr_crypt() - Encrypt or decrypt data with AES CTR.
+ *
+ * The counter is updated, so that a long buffer can be processed in
+ * several calls as long as all but the last one are a multiple of
+ * AES_BLOCK_LENGTH.
+ *
+ * @key_size		Size of the aes key (in bits)
+ * @key_exp		Expanded key to use
+ * @ctr			Initial counter block (128-bit big-endian), updated
+ * @src			Source data
+ * @dst			Destination buffer, which may be the same as @src
+ * @len			Number of bytes to process
+ */
+void aes_ctr_crypt(u32 key_size, u8 *key_exp, u8 *ctr, u8 *src, u8 *dst,
+		   u32 len);
+
+/**
+ * aes_arch_cbc_decrypt_blocks() - Decrypt AES CBC with an arch-specific
+ * implementation
+ *
+ * The arguments are those of aes_cbc_decrypt_blocks().
+ *
+ * Return: 0 if OK, -ENOSYS if the CPU does not support it, in which case
+ *	the generic code must be used
+ */
+int aes_arch_cbc_decrypt_blocks(u32 key_size, u8 *key_exp, u8 *iv, u8 *src,
+				u8 *dst, u32 num_aes_blocks);
+
+/**
+ * aes_arch_ctr_crypt_blocks() - Process whole AES CTR blocks with an
+ * arch-specific implementation
+ *
+ * The arguments are those of aes_ctr_crypt(), with the length given in
+ * blocks.
+ *
+ * Return: 0 if OK, -ENOSYS if the CPU does not support it, in which case
+ *	the generic code must be used
+ */
+int aes_arch_ctr_crypt_blocks(u32 key_size, u8 *key_exp, u8 *ctr, u8 *src,
+			      u8 *dst, u32 num_aes_blocks);
+
 #endif /* _AES_REF_H_ */
@@ -156,6 +156,44 @@ struct usb_device {
 
 struct int_queue;
 
+/**
+ * struct usb_bulk_req - One bulk transfer within a queued batch
+ *
+ * A batch of these is handed to usb_bulk_msg_queue() so that the host
+ * controller can have several transfer descriptors outstanding at once
+ * instead of waiting for each one to complete before queueing the next.
+ *
+ * @pipe:	Bulk pipe to use for this transfer
+ * @buffer:	Data buffer; this should be DMA-aligned
+ * @length:	Number of bytes to transfer
+ * @stream_id:	Stream to use on a SuperSpeed endpoint which has streams
+ *		allocated (see usb_alloc_streams()), else 0
+ * @act_len:	Number of bytes actually transferred, set on completion
+ * @status:	USB_ST_... status of the transfer, set on completion. This is
+ *		USB_ST_NOT_PROC if the transfer was never completed, e.g.
+ *		because an earlier transfer in the batch failed
+ * @flags:	USB_BULK_REQ_... flags
+ * @hcpriv:	Private data for use by the host controller driver
+ */
+struct usb_bulk_req {
+	unsigned long pipe;
+	void *buffer;
+	int length;
+	unsigned int stream_id;
+	int act_len;
+	unsigned long status;
+	unsigned int flags;
+	void *hcpriv;
+};
+
+/*
+ * Once this request completes, any request on the same (non-zero) stream
+ * which is still pending on another endpoint is cancelled and left with
+ * status USB_ST_NOT_PROC. This is used for UAS, where a status IU without
+ * the data phase means that the device has given up on the command.
+ */
+#define USB_BULK_REQ_END_STREAM	(1 << 0)
+
 /*
  * You can initialize platform's USB host or device
  * ports by passing this enum as an argument to
@@ -186,6 +224,10 @@ int submit_control_msg(struct usb_device *dev, unsigned long pipe, void *buffer,
 			int transfer_len, struct devrequest *setup);
 int submit_int_msg(struct usb_device *dev, unsigned long pipe, void *buffer,
 			int transfer_len, int interval, bool nonblock);
+#if CONFIG_IS_ENABLED(DM_USB)
+int submit_bulk_queue(struct usb_device *dev, struct usb_bulk_req *reqs,
+		      int count);
+#endif
 
 #if defined CONFIG_USB_EHCI_HCD || defined CONFIG_USB_MUSB_HOST \
 	|| CONFIG_IS_ENABLED(DM_USB)
@@ -268,6 +310,8 @@ int usb_control_msg(struct usb_device *dev, unsigned int pipe,
 			void *data, unsigned short size, int timeout);
 int usb_bulk_msg(struct usb_device *dev, unsigned int pipe,
 			void *data, int len, int *actual_length, int timeout);
+int usb_bulk_msg_queue(struct usb_device *dev, struct usb_bulk_req *reqs,
+		       int count, int timeout);
 int usb_int_msg(struct usb_device *dev, unsigned long pipe,
 		void *buffer, int transfer_len, int interval, bool nonblock);
 int usb_lock_async(struct usb_device *dev, int lock);
@@ -707,6 +751,23 @@ struct dm_usb_ops {
 	 */
 	int (*bulk)(struct udevice *bus, struct usb_device *udev,
 		    unsigned long pipe, void *buffer, int length);
+	/**
+	 * bulk_queue() - Queue several bulk messages and wait for them all
+	 *
+	 * All transfers are queued to the controller before waiting, so that
+	 * consecutive transfers (possibly on different endpoints) are not
+	 * separated by idle gaps. Transfers on the same endpoint complete in
+	 * the order given. Once a transfer fails, all transfers which have not
+	 * completed yet are cancelled and left with status USB_ST_NOT_PROC.
+	 *
+	 * This is optional; if NULL, bulk() is called for each transfer.
+	 *
+	 * @reqs: Transfers to perform; act_len and status are updated
+	 * @count: Number of transfers in @reqs
+	 * @return 0 if all transfers succeeded, -ve on error
+	 */
+	int (*bulk_queue)(struct udevice *bus, struct usb_device *udev,
+			  struct usb_bulk_req *reqs, int count);
 	/**
 	 * interrupt() - Send an interrupt message
 	 *
@@ -794,6 +855,22 @@ struct dm_usb_ops {
 	 */
 	int (*get_max_xfer_size)(struct udevice *bus, size_t *size);
 
+	/**
+	 * alloc_streams() - Allocate streams for SuperSpeed bulk endpoints
+	 *
+	 * After this, transfers on the endpoints must give a stream ID
+	 * between 1 and the number of streams allocated.
+	 *
+	 * @pipes: Pipes of the bulk endpoints to set up
+	 * @num_pipes: Number of entries in @pipes
+	 * @num_streams: Number of streams wanted (not counting stream 0)
+	 * @return number of streams allocated (which may be more or less than
+	 * requested), or -ve on error
+	 */
+	int (*alloc_streams)(struct udevice *bus, struct usb_device *udev,
+			     unsigned long *pipes, int num_pipes,
+			     unsigned int num_streams);
+
 	/**
 	 * lock_async() - Keep async schedule after a transfer
 	 *
@@ -1007,6 +1084,22 @@ int usb_update_hub_device(struct usb_device *dev);
  */
 int usb_get_max_xfer_size(struct usb_device *dev, size_t *size);
 
+/**
+ * usb_alloc_streams() - Allocate streams for SuperSpeed bulk endpoints
+ *
+ * This is used by class drivers such as UAS which keep several transfers
+ * in flight on an endpoint, each on its own stream.
+ *
+ * @dev:		USB device
+ * @pipes:		Pipes of the bulk endpoints to set up
+ * @num_pipes:		Number of entries in @pipes
+ * @num_streams:	Number of streams wanted (not counting stream 0)
+ * Return: number of streams allocated, -ENOSYS if the controller does not
+ * support streams, other -ve on error
+ */
+int usb_alloc_streams(struct usb_device *dev, unsigned long *pipes,
+		      int num_pipes, unsigned int num_streams);
+
 /**
  * usb_emul_setup_device() - Set up a new USB device emulation
  *
@@ -625,6 +625,26 @@ struct xhci_ep_ctx {
 /* Endpoint is set up with a Linear Stream Array (vs. Secondary Stream Array) */
 #define	EP_HAS_LSA			(1 << 15)
 
+/**
+ * struct xhci_stream_ctx
+ * @stream_ring:	64-bit stream ring address, cycle state, and stream type
+ *
+ * Stream Context - section 6.2.4.1. When an endpoint uses streams, its
+ * dequeue pointer points to an array of these, one per stream ID.
+ */
+struct xhci_stream_ctx {
+	__le64	stream_ring;
+	/* offset 0x8 - 0xf reserved for HC internal use */
+	__le32	reserved[2];
+};
+
+/* Stream Context Type - bits 3:1 of the stream ring address */
+#define SCT_FOR_CTX(p)		(((p) & 0x7) << 1)
+/* Secondary stream array type, dequeue pointer is to a transfer ring */
+#define SCT_SEC_TR		0
+/* Primary stream array type, dequeue pointer is to a transfer ring */
+#define SCT_PRI_TR		1
+
 /* ep_info2 bitmasks */
 /*
  * Force Event - generate transfer events for all TRBs for this endpoint
@@ -1051,6 +1071,10 @@ struct xhci_scratchpad {
 
 struct xhci_virt_ep {
 	struct xhci_ring		*ring;
+	/* Stream context array and rings, if the endpoint uses streams */
+	struct xhci_stream_ctx		*stream_ctx;
+	struct xhci_ring		**stream_rings;
+	unsigned int			num_streams;
 	unsigned int			ep_state;
 #define SET_DEQ_PENDING		(1 << 0)
 #define EP_HALTED		(1 << 1)	/* For stall handling */
@@ -1082,6 +1106,24 @@ struct xhci_virt_device {
 	struct xhci_virt_ep		eps[31];
 };
 
+/**
+ * xhci_ep_ring() - Get the transfer ring of an endpoint stream
+ *
+ * @ep:		Endpoint to check
+ * @stream_id:	Stream ID, ignored if the endpoint does not use streams
+ * Return: transfer ring, or NULL if @stream_id is not valid
+ */
+static inline struct xhci_ring *xhci_ep_ring(struct xhci_virt_ep *ep,
+					     unsigned int stream_id)
+{
+	if (!ep->num_streams)
+		return ep->ring;
+	if (!stream_id || stream_id >= ep->num_streams)
+		return NULL;
+
+	return ep->stream_rings[stream_id];
+}
+
 /* TODO: copied from ehci.h - can be refactored? */
 /* xHCI spec says all registers are little endian */
 static inline unsigned int xhci_readl(uint32_t volatile *regs)
@@ -1249,6 +1291,8 @@ void xhci_acknowledge_event(struct xhci_ctrl *ctrl);
 union xhci_trb *xhci_wait_for_event(struct xhci_ctrl *ctrl, trb_type expected);
 int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 		 int length, void *buffer);
+int xhci_bulk_tx_queue(struct usb_device *udev, struct usb_bulk_req *reqs,
+		       int count);
 int xhci_ctrl_tx(struct usb_device *udev, unsigned long pipe,
 		 struct devrequest *req, int length, void *buffer);
 int xhci_check_maxpacket(struct usb_device *udev);
@@ -1257,6 +1301,9 @@ void xhci_inval_cache(uintptr_t addr, u32 type_len);
 void xhci_cleanup(struct xhci_ctrl *ctrl);
 struct xhci_ring *xhci_ring_alloc(struct xhci_ctrl *ctrl, unsigned int num_segs,
 				  bool link_trbs);
+int xhci_alloc_stream_rings(struct xhci_ctrl *ctrl, struct xhci_virt_ep *ep,
+			    unsigned int num_streams);
+void xhci_free_stream_rings(struct xhci_virt_ep *ep);
 int xhci_alloc_virt_device(struct xhci_ctrl *ctrl, unsigned int slot_id);
 int xhci_mem_init(struct xhci_ctrl *ctrl, struct xhci_hccr *hccr,
 		  struct xhci_hcor *hcor);
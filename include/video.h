@@ -26,7 +26,9 @@ struct udevice;
  *
  * @align: Frame-buffer alignment, indicating the memory boundary the frame
  *	buffer should start on. If 0, 1MB is assumed
- * @size: Frame-buffer size, in bytes
+ * @size: Frame-buffer size, in bytes. If the driver supports the
+ *	set_offset() operation, any space after the visible display is used
+ *	to scroll the display in hardware
  * @base: Base address of frame buffer, 0 if not yet known
  * @copy_base: Base address of a hardware copy of the frame buffer. See
  *	CONFIG_VIDEO_COPY.
@@ -73,6 +75,41 @@ enum video_format {
 	VIDEO_X2R10G10B10,
 };
 
+/* Magic number at the start of a raw frame-buffer image ("UBRW") */
+#define VIDEO_RAW_MAGIC		0x57524255
+
+/* Compression used for the data in a raw frame-buffer image */
+enum video_raw_comp {
+	VIDEO_RAW_COMP_NONE,
+	VIDEO_RAW_COMP_LZ4,
+};
+
+/**
+ * struct video_raw_header - Header of a raw frame-buffer image
+ *
+ * This is followed by the pixel data, top line first, with each line holding
+ * @width pixels and no padding. All fields are little-endian.
+ *
+ * @magic:	VIDEO_RAW_MAGIC
+ * @width:	Width of the image in pixels
+ * @height:	Height of the image in pixels
+ * @bpix:	Encoded bits per pixel (enum video_log2_bpp)
+ * @format:	Pixel format (enum video_format)
+ * @comp:	Compression of the pixel data (enum video_raw_comp)
+ * @reserved:	Must be 0
+ * @size:	Number of bytes of pixel data after the header, as stored
+ */
+struct __packed video_raw_header {
+	u32 magic;
+	u16 width;
+	u16 height;
+	u8 bpix;
+	u8 format;
+	u8 comp;
+	u8 reserved;
+	u32 size;
+};
+
 /**
  * struct video_priv - Device information used by the video uclass
  *
@@ -97,6 +134,14 @@ enum video_format {
  *		the LCD is updated
  * @fg_col_idx:	Foreground color code (bit 3 = bold, bit 0-2 = color)
  * @bg_col_idx:	Background color code (bit 3 = bold, bit 0-2 = color)
+ * @damage_start:	Offset of the first frame buffer line changed since the
+ *		last sync
+ * @damage_end:	Offset just past the last changed line; equal to
+ *		@damage_start if nothing has changed
+ * @pan_offset:	Offset of @fb (and @copy_fb) from the start of the frame
+ *		buffer memory, when the display has been scrolled in hardware
+ * @no_pan:	true to keep the display at the start of the frame buffer
+ *		memory, since its address has been passed on
  */
 struct video_priv {
 	/* Things set up by the driver: */
@@ -121,6 +166,10 @@ struct video_priv {
 	bool flush_dcache;
 	u8 fg_col_idx;
 	u8 bg_col_idx;
+	int damage_start;
+	int damage_end;
+	ulong pan_offset;
+	bool no_pan;
 };
 
 /**
@@ -130,9 +179,16 @@ struct video_priv {
  *		For these devices implement video_sync hook to call a sync
  *		function. vid is pointer to video device udevice. Function
  *		should return 0 on success video_sync and error code otherwise
+ * @set_offset: Set the position of the displayed image within the frame
+ *		buffer memory. The display starts @offset bytes after the base
+ *		address (the copy base with CONFIG_VIDEO_COPY). This allows
+ *		the uclass to scroll by moving the display rather than copying
+ *		the frame buffer. Optional. Returns 0 on success, or an error
+ *		code if the offset cannot be used
  */
 struct video_ops {
 	int (*video_sync)(struct udevice *vid);
+	int (*set_offset)(struct udevice *vid, ulong offset);
 };
 
 #define video_get_ops(dev)        ((struct video_ops *)(dev)->driver->ops)
@@ -207,6 +263,27 @@ void video_sync_all(void);
 int video_bmp_display(struct udevice *dev, ulong bmp_image, int x, int y,
 		      bool align);
 
+/**
+ * video_raw_display() - Display a raw frame-buffer image
+ *
+ * The image must have the same pixel format as the display. It is copied (or
+ * decompressed) into the frame buffer a line at a time, or all at once if it
+ * is the full width of the display. video_bmp_display() calls this for images
+ * starting with VIDEO_RAW_MAGIC.
+ *
+ * @dev:	Device to display the image on
+ * @addr:	Address of image, starting with struct video_raw_header
+ * @x:		X position in pixels from the left
+ * @y:		Y position in pixels from the top
+ * @align:	true to adjust the coordinates to centre the image, as with
+ *		video_bmp_display()
+ * Return: 0 if OK, -EINVAL if the image is not valid, -EPERM if its format
+ *	does not match the display, -EPROTONOSUPPORT if the compression is not
+ *	supported, other -ve value on other error
+ */
+int video_raw_display(struct udevice *dev, ulong addr, int x, int y,
+		      bool align);
+
 /**
  * video_get_xsize() - Get the width of the display in pixels
  *
@@ -239,13 +316,15 @@ void video_set_flush_dcache(struct udevice *dev, bool flush);
  */
 void video_set_default_colors(struct udevice *dev, bool invert);
 
-#ifdef CONFIG_VIDEO_COPY
 /**
- * vidconsole_sync_copy() - Sync back to the copy framebuffer
+ * video_sync_copy() - Sync back to the copy framebuffer
  *
  * This ensures that the copy framebuffer has the same data as the framebuffer
  * for a particular region. It should be called after the framebuffer is updated
  *
+ * The region is also recorded as changed, so that the next video_sync() only
+ * needs to flush the lines which were touched.
+ *
  * @from and @to can be in either order. The region between them is synced.
  *
  * @dev: Vidconsole device being updated
@@ -263,18 +342,38 @@ int video_sync_copy(struct udevice *dev, void *from, void *to);
  * Return: 0 (always)
  */
 int video_sync_copy_all(struct udevice *dev);
-#else
-static inline int video_sync_copy(struct udevice *dev, void *from, void *to)
-{
-	return 0;
-}
 
-static inline int video_sync_copy_all(struct udevice *dev)
-{
-	return 0;
-}
+/**
+ * video_memmove() - Perform a memmove() within the frame buffer
+ *
+ * This handles a move, then calls video_sync_copy() on the moved area.
+ *
+ * Where the driver supports it, scrolling the whole display up is done by
+ * moving the displayed area forward in memory, in which case @fb changes. Once
+ * the end of the frame buffer memory is reached, the display is copied back to
+ * the start. With CONFIG_VIDEO_DMA other moves use a DMA engine if available.
+ *
+ * @dev: Video device being updated
+ * @dst: Destination address within the framebuffer (->fb)
+ * @src: Source address within the framebuffer (->fb)
+ * @size: Number of bytes to transfer
+ * Return: 0 if OK, -EFAULT if the start address is before the start of the
+ *	frame buffer start
+ */
+int video_memmove(struct udevice *dev, void *dst, const void *src, int size);
 
-#endif
+/**
+ * video_fix_offset() - Keep the display at the start of the frame buffer
+ *
+ * If the display has been scrolled in hardware, this copies it back to the
+ * start of the frame buffer memory and points the hardware there. Scrolling
+ * is done by copying from then on. Use this before handing the frame-buffer
+ * address to something else, such as the OS or an EFI application.
+ *
+ * @dev: Video device
+ * Return: 0 if OK, -ve on error
+ */
+int video_fix_offset(struct udevice *dev);
 
 /**
  * video_is_active() - Test if one video device it active
@@ -666,6 +666,11 @@ void aes_cbc_decrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
 	u8 cbc_chain_data[AES_BLOCK_LENGTH];
 	u32 i;
 
+#if !defined(USE_HOSTCC) && defined(CONFIG_CRYPTO_AES_ARM64_CE)
+	if (!aes_arch_cbc_decrypt_blocks(key_len, key_exp, iv, src, dst,
+					 num_aes_blocks))
+		return;
+#endif
 	memcpy(cbc_chain_data, iv, AES_BLOCK_LENGTH);
 	for (i = 0; i < num_aes_blocks; i++) {
 		debug("encrypt_object: block %d of %d\n", i, num_aes_blocks);
@@ -687,3 +692,42 @@ void aes_cbc_decrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
 		dst += AES_BLOCK_LENGTH;
 	}
 }
+
+/* increment a 128-bit big-endian counter block */
+static void aes_ctr_inc(u8 *ctr)
+{
+	int i;
+
+	for (i = AES_BLOCK_LENGTH - 1; i >= 0; i--)
+		if (++ctr[i])
+			break;
+}
+
+void aes_ctr_crypt(u32 key_len, u8 *key_exp, u8 *ctr, u8 *src, u8 *dst,
+		   u32 len)
+{
+	u8 key_stream[AES_BLOCK_LENGTH];
+	u32 i, count;
+
+#if !defined(USE_HOSTCC) && defined(CONFIG_CRYPTO_AES_ARM64_CE)
+	count = len / AES_BLOCK_LENGTH;
+	if (count && !aes_arch_ctr_crypt_blocks(key_len, key_exp, ctr, src,
+						dst, count)) {
+		src += count * AES_BLOCK_LENGTH;
+		dst += count * AES_BLOCK_LENGTH;
+		len -= count * AES_BLOCK_LENGTH;
+	}
+#endif
+	while (len) {
+		aes_encrypt(key_len, ctr, key_exp, key_stream);
+		aes_ctr_inc(ctr);
+
+		count = len < AES_BLOCK_LENGTH ? len : AES_BLOCK_LENGTH;
+		for (i = 0; i < count; i++)
+			dst[i] = src[i] ^ key_stream[i];
+
+		src += count;
+		dst += count;
+		len -= count;
+	}
+}
@@ -6,10 +6,15 @@
 #ifndef USE_HOSTCC
 #include <common.h>
 #include <malloc.h>
+#include <watchdog.h>
+#include <linux/sizes.h>
 #endif
 #include <image.h>
 #include <uboot_aes.h>
 
+/* Decrypt this much at a time, so that the watchdog is kept alive */
+#define IMAGE_AES_CHUNK_BLOCKS	(SZ_1M / AES_BLOCK_LENGTH)
+
 int image_aes_decrypt(struct image_cipher_info *info,
 		      const void *cipher, size_t cipher_len,
 		      void **data, size_t *size)
@@ -17,6 +22,8 @@ int image_aes_decrypt(struct image_cipher_info *info,
 #ifndef USE_HOSTCC
 	unsigned char key_exp[AES256_EXPAND_KEY_LENGTH];
 	unsigned int aes_blocks, key_len = info->cipher->key_len;
+	unsigned int count;
+	u8 *src = (u8 *)cipher, *dst, *iv = (u8 *)info->iv;
 
 	*data = malloc(cipher_len);
 	if (!*data) {
@@ -33,8 +40,57 @@ int image_aes_decrypt(struct image_cipher_info *info,
 	/* Calculate the number of AES blocks to encrypt. */
 	aes_blocks = DIV_ROUND_UP(cipher_len, AES_BLOCK_LENGTH);
 
-	aes_cbc_decrypt_blocks(key_len, key_exp, (u8 *)info->iv,
-			       (u8 *)cipher, *data, aes_blocks);
+	/* The ciphertext is left alone, so it provides the chain data */
+	for (dst = *data; aes_blocks; aes_blocks -= count) {
+		count = min_t(unsigned int, aes_blocks, IMAGE_AES_CHUNK_BLOCKS);
+		aes_cbc_decrypt_blocks(key_len, key_exp, iv, src, dst, count);
+		iv = src + (count - 1) * AES_BLOCK_LENGTH;
+		src += count * AES_BLOCK_LENGTH;
+		dst += count * AES_BLOCK_LENGTH;
+		WATCHDOG_RESET();
+	}
+#endif
+
+	return 0;
+}
+
+int image_aes_ctr_decrypt(struct image_cipher_info *info,
+			  const void *cipher, size_t cipher_len,
+			  void **data, size_t *size)
+{
+#ifndef USE_HOSTCC
+	unsigned char key_exp[AES256_EXPAND_KEY_LENGTH];
+	unsigned int key_len = info->cipher->key_len;
+	u8 ctr[AES_BLOCK_LENGTH];
+	u8 *src = (u8 *)cipher, *dst;
+	size_t count;
+
+	/* CTR mode needs no padding, so nothing past the data is needed */
+	if (info->size_unciphered > cipher_len) {
+		printf("Ciphered data is too short\n");
+		return -EINVAL;
+	}
+	cipher_len = info->size_unciphered;
+
+	*data = malloc(cipher_len);
+	if (!*data) {
+		printf("Can't allocate memory to decrypt\n");
+		return -ENOMEM;
+	}
+	*size = cipher_len;
+
+	aes_expand_key((u8 *)info->key, key_len, key_exp);
+	memcpy(ctr, info->iv, AES_BLOCK_LENGTH);
+
+	/* The counter carries over, since each chunk is whole blocks */
+	for (dst = *data; cipher_len; cipher_len -= count) {
+		count = min_t(size_t, cipher_len,
+			      IMAGE_AES_CHUNK_BLOCKS * AES_BLOCK_LENGTH);
+		aes_ctr_crypt(key_len, key_exp, ctr, src, dst, count);
+		src += count;
+		dst += count;
+		WATCHDOG_RESET();
+	}
 #endif
 
 	return 0;
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * DMA buffer allocation and batched cache maintenance
+ */
+
+#include <common.h>
+#include <cpu_func.h>
+#include <log.h>
+#include <malloc.h>
+#include <asm/cache.h>
+#include <linux/dma-mapping.h>
+
+void *dma_alloc_uncached(size_t len, dma_addr_t *handle)
+{
+	void *ptr;
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	ulong addr;
+#endif
+
+	len = ALIGN(len, ARCH_DMA_MINALIGN);
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	addr = noncached_alloc(len, ARCH_DMA_MINALIGN);
+	if (addr) {
+		ptr = (void *)addr;
+		memset(ptr, '\0', len);
+		*handle = addr;
+
+		return ptr;
+	}
+	debug("Non-cached region full, using cached memory\n");
+#endif
+	ptr = memalign(ARCH_DMA_MINALIGN, len);
+	if (!ptr)
+		return NULL;
+	memset(ptr, '\0', len);
+	flush_dcache_range((ulong)ptr, (ulong)ptr + len);
+	*handle = (ulong)ptr;
+
+	return ptr;
+}
+
+void dma_free_uncached(void *vaddr)
+{
+	if (!dma_is_uncached(vaddr))
+		free(vaddr);
+}
+
+void dma_sync_batch_init(struct dma_sync_batch *batch,
+			 enum dma_data_direction dir, bool for_cpu)
+{
+	batch->dir = dir;
+	batch->for_cpu = for_cpu;
+	batch->count = 0;
+	batch->total = 0;
+}
+
+void dma_sync_batch_add(struct dma_sync_batch *batch, void *vaddr, size_t len)
+{
+	ulong start = (ulong)vaddr & ~(ulong)(ARCH_DMA_MINALIGN - 1);
+	ulong end = ALIGN((ulong)vaddr + len, ARCH_DMA_MINALIGN);
+	int i;
+
+	if (!len || dma_is_uncached(vaddr))
+		return;
+	if (batch->for_cpu && batch->dir == DMA_TO_DEVICE)
+		return;
+
+	/* Merge with an existing range if they touch */
+	for (i = 0; i < batch->count; i++) {
+		if (start > batch->end[i] || end < batch->start[i])
+			continue;
+		batch->total -= batch->end[i] - batch->start[i];
+		batch->start[i] = min(batch->start[i], start);
+		batch->end[i] = max(batch->end[i], end);
+		batch->total += batch->end[i] - batch->start[i];
+		return;
+	}
+
+	if (batch->count == DMA_SYNC_BATCH_RANGES)
+		dma_sync_batch_run(batch);
+	batch->start[batch->count] = start;
+	batch->end[batch->count] = end;
+	batch->count++;
+	batch->total += end - start;
+}
+
+void dma_sync_batch_run(struct dma_sync_batch *batch)
+{
+	bool inval;
+	int i;
+
+	if (!batch->count)
+		return;
+
+#ifdef CONFIG_DMA_SYNC_ALL
+	/*
+	 * Clean-and-invalidate is safe in both directions, since the CPU does
+	 * not write to the buffers while the device owns them
+	 */
+	if (batch->total >= CONFIG_DMA_SYNC_ALL_THRESHOLD) {
+		flush_dcache_all();
+		batch->count = 0;
+		batch->total = 0;
+		return;
+	}
+#endif
+	inval = batch->for_cpu || batch->dir == DMA_FROM_DEVICE;
+	for (i = 0; i < batch->count; i++) {
+		if (inval)
+			invalidate_dcache_range(batch->start[i], batch->end[i]);
+		else
+			flush_dcache_range(batch->start[i], batch->end[i]);
+	}
+	batch->count = 0;
+	batch->total = 0;
+}
@@ -0,0 +1,647 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Software ECDSA signature verification for NIST P-256 and P-384
+ *
+ * This is a generic ECDSA uclass driver, for boards without a hardware
+ * verifier and for curves the hardware does not support.
+ *
+ * Field elements and scalars are kept in Montgomery form on 32-bit words,
+ * so the same arithmetic serves both curves, both for the field and for the
+ * group order. u1 * G + u2 * Q is computed in one pass with Shamir's trick
+ * on 2-bit windows of both scalars, using a table of i * G + j * Q. Points
+ * are in Jacobian coordinates and the result is compared with r without
+ * going back to affine coordinates.
+ *
+ * For a given curve the sequence of field operations is fixed, apart from
+ * the special cases of point addition. All the inputs are public, so this
+ * does not attempt to run in constant time.
+ */
+
+#include <dm.h>
+#include <log.h>
+#include <asm/unaligned.h>
+#include <crypto/ecdsa-uclass.h>
+#include <linux/errno.h>
+#include <linux/string.h>
+#include <linux/types.h>
+#include <u-boot/ecdsa.h>
+
+#define ECC_MAX_WORDS	(384 / 32)
+
+/* Window size in bits for the double scalar multiplication */
+#define ECC_WINDOW	2
+
+/**
+ * struct ecc_mod - modulus for Montgomery arithmetic
+ *
+ * @m:		Modulus, least significant word first
+ * @rr:		R^2 mod m, with R = 2^(32 * words)
+ * @m0inv:	-1 / m mod 2^32
+ */
+struct ecc_mod {
+	const u32 *m;
+	const u32 *rr;
+	u32 m0inv;
+};
+
+/**
+ * struct ecc_curve - short Weierstrass curve y^2 = x^3 - 3x + b
+ *
+ * @name:	Curve name as written by mkimage in the "ecdsa,curve" property
+ * @words:	Size of field elements and scalars in 32-bit words
+ * @p:		Field prime
+ * @n:		Group order
+ * @b:		Curve parameter b, in Montgomery form
+ * @gx:		x coordinate of the generator, in Montgomery form
+ * @gy:		y coordinate of the generator, in Montgomery form
+ */
+struct ecc_curve {
+	const char *name;
+	unsigned int words;
+	struct ecc_mod p;
+	struct ecc_mod n;
+	const u32 *b;
+	const u32 *gx;
+	const u32 *gy;
+};
+
+/* Point in Jacobian coordinates (X / Z^2, Y / Z^3), Z = 0 is infinity */
+struct ecc_point {
+	u32 x[ECC_MAX_WORDS];
+	u32 y[ECC_MAX_WORDS];
+	u32 z[ECC_MAX_WORDS];
+};
+
+static const u32 p256_p[] = {
+	0xffffffff, 0xffffffff, 0xffffffff, 0x00000000,
+	0x00000000, 0x00000000, 0x00000001, 0xffffffff,
+};
+
+static const u32 p256_p_rr[] = {
+	0x00000003, 0x00000000, 0xffffffff, 0xfffffffb,
+	0xfffffffe, 0xffffffff, 0xfffffffd, 0x00000004,
+};
+
+static const u32 p256_n[] = {
+	0xfc632551, 0xf3b9cac2, 0xa7179e84, 0xbce6faad,
+	0xffffffff, 0xffffffff, 0x00000000, 0xffffffff,
+};
+
+static const u32 p256_n_rr[] = {
+	0xbe79eea2, 0x83244c95, 0x49bd6fa6, 0x4699799c,
+	0x2b6bec59, 0x2845b239, 0xf3d95620, 0x66e12d94,
+};
+
+static const u32 p256_b[] = {
+	0x29c4bddf, 0xd89cdf62, 0x78843090, 0xacf005cd,
+	0xf7212ed6, 0xe5a220ab, 0x04874834, 0xdc30061d,
+};
+
+static const u32 p256_gx[] = {
+	0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc,
+	0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76,
+};
+
+static const u32 p256_gy[] = {
+	0xce95560a, 0xddf25357, 0xba19e45c, 0x8b4ab8e4,
+	0xdd21f325, 0xd2e88688, 0x25885d85, 0x8571ff18,
+};
+
+static const u32 p384_p[] = {
+	0xffffffff, 0x00000000, 0x00000000, 0xffffffff,
+	0xfffffffe, 0xffffffff, 0xffffffff, 0xffffffff,
+	0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+};
+
+static const u32 p384_p_rr[] = {
+	0x00000001, 0xfffffffe, 0x00000000, 0x00000002,
+	0x00000000, 0xfffffffe, 0x00000000, 0x00000002,
+	0x00000001, 0x00000000, 0x00000000, 0x00000000,
+};
+
+static const u32 p384_n[] = {
+	0xccc52973, 0xecec196a, 0x48b0a77a, 0x581a0db2,
+	0xf4372ddf, 0xc7634d81, 0xffffffff, 0xffffffff,
+	0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+};
+
+static const u32 p384_n_rr[] = {
+	0x19b409a9, 0x2d319b24, 0xdf1aa419, 0xff3d81e5,
+	0xfcb82947, 0xbc3e483a, 0x4aab1cc5, 0xd40d4917,
+	0x28266895, 0x3fb05b7a, 0x2b39bf21, 0x0c84ee01,
+};
+
+static const u32 p384_b[] = {
+	0x9d412dcc, 0x08118871, 0x7a4c32ec, 0xf729add8,
+	0x1920022e, 0x77f2209b, 0x94938ae2, 0xe3374bee,
+	0x1f022094, 0xb62b21f4, 0x604fbff9, 0xcd08114b,
+};
+
+static const u32 p384_gx[] = {
+	0x49c0b528, 0x3dd07566, 0xa0d6ce38, 0x20e378e2,
+	0x541b4d6e, 0x879c3afc, 0x59a30eff, 0x64548684,
+	0x614ede2b, 0x812ff723, 0x299e1513, 0x4d3aadc2,
+};
+
+static const u32 p384_gy[] = {
+	0x4b03a4fe, 0x23043dad, 0x7bb4a9ac, 0xa1bfa8bf,
+	0x2e83b050, 0x8bade756, 0x68f4ffd9, 0xc6c35219,
+	0x3969a840, 0xdd800226, 0x5a15c5e9, 0x2b78abc2,
+};
+
+static const struct ecc_curve ecc_curves[] = {
+	{
+		.name = "prime256v1",
+		.words = 256 / 32,
+		.p = { p256_p, p256_p_rr, 0x00000001 },
+		.n = { p256_n, p256_n_rr, 0xee00bc4f },
+		.b = p256_b,
+		.gx = p256_gx,
+		.gy = p256_gy,
+	},
+	{
+		.name = "secp384r1",
+		.words = 384 / 32,
+		.p = { p384_p, p384_p_rr, 0x00000001 },
+		.n = { p384_n, p384_n_rr, 0xe88fdc45 },
+		.b = p384_b,
+		.gx = p384_gx,
+		.gy = p384_gy,
+	},
+};
+
+static const struct ecc_curve *ecc_find_curve(const char *name)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ecc_curves); i++) {
+		if (!strcmp(ecc_curves[i].name, name))
+			return &ecc_curves[i];
+	}
+
+	return NULL;
+}
+
+/* Load a big-endian number of @words words */
+static void ecc_from_bytes(u32 *r, const u8 *buf, uint words)
+{
+	uint i;
+
+	for (i = 0; i < words; i++)
+		r[i] = get_unaligned_be32(buf + 4 * (words - 1 - i));
+}
+
+static bool ecc_is_zero(const u32 *a, uint words)
+{
+	u32 acc = 0;
+	uint i;
+
+	for (i = 0; i < words; i++)
+		acc |= a[i];
+
+	return !acc;
+}
+
+static bool ecc_equal(const u32 *a, const u32 *b, uint words)
+{
+	u32 acc = 0;
+	uint i;
+
+	for (i = 0; i < words; i++)
+		acc |= a[i] ^ b[i];
+
+	return !acc;
+}
+
+/* Return true if a < b */
+static bool ecc_less(const u32 *a, const u32 *b, uint words)
+{
+	uint i;
+
+	for (i = words; i--;) {
+		if (a[i] != b[i])
+			return a[i] < b[i];
+	}
+
+	return false;
+}
+
+/* r = a + b, returns the carry */
+static u32 ecc_add_raw(u32 *r, const u32 *a, const u32 *b, uint words)
+{
+	u64 c = 0;
+	uint i;
+
+	for (i = 0; i < words; i++) {
+		c += (u64)a[i] + b[i];
+		r[i] = (u32)c;
+		c >>= 32;
+	}
+
+	return c;
+}
+
+/* r = a - b, returns the borrow */
+static u32 ecc_sub_raw(u32 *r, const u32 *a, const u32 *b, uint words)
+{
+	u32 borrow = 0;
+	u64 d;
+	uint i;
+
+	for (i = 0; i < words; i++) {
+		d = (u64)a[i] - b[i] - borrow;
+		r[i] = (u32)d;
+		borrow = (d >> 32) & 1;
+	}
+
+	return borrow;
+}
+
+/* r = mask ? a : r, where mask is either 0 or ~0 */
+static void ecc_select(u32 *r, const u32 *a, u32 mask, uint words)
+{
+	uint i;
+
+	for (i = 0; i < words; i++)
+		r[i] = (r[i] & ~mask) | (a[i] & mask);
+}
+
+/* r = a + b mod m, for a, b < m */
+static void ecc_mod_add(u32 *r, const u32 *a, const u32 *b,
+			const struct ecc_mod *mod, uint words)
+{
+	u32 t[ECC_MAX_WORDS];
+	u32 carry, borrow;
+
+	carry = ecc_add_raw(r, a, b, words);
+	borrow = ecc_sub_raw(t, r, mod->m, words);
+	ecc_select(r, t, -(carry | (borrow ^ 1)), words);
+}
+
+/* r = a - b mod m, for a, b < m */
+static void ecc_mod_sub(u32 *r, const u32 *a, const u32 *b,
+			const struct ecc_mod *mod, uint words)
+{
+	u32 t[ECC_MAX_WORDS];
+	u32 borrow;
+
+	borrow = ecc_sub_raw(r, a, b, words);
+	ecc_add_raw(t, r, mod->m, words);
+	ecc_select(r, t, -borrow, words);
+}
+
+/*
+ * r = a * b / R mod m, for a < R and b < m (CIOS Montgomery multiplication)
+ *
+ * The result is fully reduced. r may be the same as a or b.
+ */
+static void ecc_mont_mul(u32 *r, const u32 *a, const u32 *b,
+			 const struct ecc_mod *mod, uint words)
+{
+	u32 t[ECC_MAX_WORDS + 2];
+	u32 d[ECC_MAX_WORDS];
+	u32 m, borrow;
+	uint i, j;
+	u64 c;
+
+	memset(t, 0, sizeof(t));
+	for (i = 0; i < words; i++) {
+		c = 0;
+		for (j = 0; j < words; j++) {
+			c += (u64)a[j] * b[i] + t[j];
+			t[j] = (u32)c;
+			c >>= 32;
+		}
+		c += t[words];
+		t[words] = (u32)c;
+		t[words + 1] = c >> 32;
+
+		m = t[0] * mod->m0inv;
+		c = ((u64)m * mod->m[0] + t[0]) >> 32;
+		for (j = 1; j < words; j++) {
+			c += (u64)m * mod->m[j] + t[j];
+			t[j - 1] = (u32)c;
+			c >>= 32;
+		}
+		c += t[words];
+		t[words - 1] = (u32)c;
+		t[words] = t[words + 1] + (u32)(c >> 32);
+	}
+
+	borrow = ecc_sub_raw(d, t, mod->m, words);
+	memcpy(r, t, words * sizeof(u32));
+	ecc_select(r, d, -(t[words] | (borrow ^ 1)), words);
+}
+
+/* r = 1 in Montgomery form, i.e. R mod m */
+static void ecc_mont_one(u32 *r, const struct ecc_mod *mod, uint words)
+{
+	u32 one[ECC_MAX_WORDS] = { 1 };
+
+	ecc_mont_mul(r, one, mod->rr, mod, words);
+}
+
+/* r = 1 / a mod m for prime m, with a and r in Montgomery form */
+static void ecc_mont_inv(u32 *r, const u32 *a, const struct ecc_mod *mod,
+			 uint words)
+{
+	u32 two[ECC_MAX_WORDS] = { 2 };
+	u32 exp[ECC_MAX_WORDS];
+	u32 x[ECC_MAX_WORDS];
+	uint i;
+
+	/* Fermat: a^(m - 2) */
+	ecc_sub_raw(exp, mod->m, two, words);
+	ecc_mont_one(x, mod, words);
+	for (i = words * 32; i--;) {
+		ecc_mont_mul(x, x, x, mod, words);
+		if ((exp[i / 32] >> (i % 32)) & 1)
+			ecc_mont_mul(x, x, a, mod, words);
+	}
+	memcpy(r, x, words * sizeof(u32));
+}
+
+static void fe_mul(const struct ecc_curve *c, u32 *r, const u32 *a,
+		   const u32 *b)
+{
+	ecc_mont_mul(r, a, b, &c->p, c->words);
+}
+
+static void fe_add(const struct ecc_curve *c, u32 *r, const u32 *a,
+		   const u32 *b)
+{
+	ecc_mod_add(r, a, b, &c->p, c->words);
+}
+
+static void fe_sub(const struct ecc_curve *c, u32 *r, const u32 *a,
+		   const u32 *b)
+{
+	ecc_mod_sub(r, a, b, &c->p, c->words);
+}
+
+/* r = 2 * p ("dbl-2001-b" for a = -3). r may be the same as p. */
+static void ecc_point_double(const struct ecc_curve *c, struct ecc_point *r,
+			     const struct ecc_point *p)
+{
+	u32 delta[ECC_MAX_WORDS], gamma[ECC_MAX_WORDS];
+	u32 beta[ECC_MAX_WORDS], alpha[ECC_MAX_WORDS];
+	u32 t[ECC_MAX_WORDS];
+
+	fe_mul(c, delta, p->z, p->z);
+	fe_mul(c, gamma, p->y, p->y);
+	fe_mul(c, beta, p->x, gamma);
+
+	/* alpha = 3 * (x - delta) * (x + delta) */
+	fe_sub(c, t, p->x, delta);
+	fe_add(c, alpha, p->x, delta);
+	fe_mul(c, alpha, alpha, t);
+	fe_add(c, t, alpha, alpha);
+	fe_add(c, alpha, t, alpha);
+
+	/* z3 = (y + z)^2 - gamma - delta */
+	fe_add(c, t, p->y, p->z);
+	fe_mul(c, r->z, t, t);
+	fe_sub(c, r->z, r->z, gamma);
+	fe_sub(c, r->z, r->z, delta);
+
+	/* x3 = alpha^2 - 8 * beta */
+	fe_add(c, beta, beta, beta);
+	fe_add(c, beta, beta, beta);
+	fe_add(c, t, beta, beta);
+	fe_mul(c, r->x, alpha, alpha);
+	fe_sub(c, r->x, r->x, t);
+
+	/* y3 = alpha * (4 * beta - x3) - 8 * gamma^2 */
+	fe_sub(c, beta, beta, r->x);
+	fe_mul(c, r->y, alpha, beta);
+	fe_mul(c, gamma, gamma, gamma);
+	fe_add(c, gamma, gamma, gamma);
+	fe_add(c, gamma, gamma, gamma);
+	fe_add(c, gamma, gamma, gamma);
+	fe_sub(c, r->y, r->y, gamma);
+}
+
+/* r = p + q ("add-1998-cmo-2"). r may be the same as p or q. */
+static void ecc_point_add(const struct ecc_curve *c, struct ecc_point *r,
+			  const struct ecc_point *p, const struct ecc_point *q)
+{
+	u32 z1z1[ECC_MAX_WORDS], z2z2[ECC_MAX_WORDS];
+	u32 u1[ECC_MAX_WORDS], u2[ECC_MAX_WORDS];
+	u32 s1[ECC_MAX_WORDS], s2[ECC_MAX_WORDS];
+	u32 h[ECC_MAX_WORDS];
+	uint words = c->words;
+
+	if (ecc_is_zero(p->z, words)) {
+		*r = *q;
+		return;
+	}
+	if (ecc_is_zero(q->z, words)) {
+		*r = *p;
+		return;
+	}
+
+	fe_mul(c, z1z1, p->z, p->z);
+	fe_mul(c, z2z2, q->z, q->z);
+	fe_mul(c, u1, p->x, z2z2);
+	fe_mul(c, u2, q->x, z1z1);
+	fe_mul(c, s1, p->y, q->z);
+	fe_mul(c, s1, s1, z2z2);
+	fe_mul(c, s2, q->y, p->z);
+	fe_mul(c, s2, s2, z1z1);
+
+	/* h = u2 - u1, s2 = s2 - s1 */
+	fe_sub(c, h, u2, u1);
+	fe_sub(c, s2, s2, s1);
+	if (ecc_is_zero(h, words)) {
+		if (ecc_is_zero(s2, words))
+			ecc_point_double(c, r, p);
+		else
+			memset(r, '\0', sizeof(*r));
+		return;
+	}
+
+	/* z3 = z1 * z2 * h */
+	fe_mul(c, z1z1, p->z, q->z);
+	fe_mul(c, r->z, z1z1, h);
+
+	/* z2z2 = h^2, h = h^3, u1 = u1 * h^2 */
+	fe_mul(c, z2z2, h, h);
+	fe_mul(c, h, h, z2z2);
+	fe_mul(c, u1, u1, z2z2);
+
+	/* x3 = s2^2 - h^3 - 2 * u1 * h^2 */
+	fe_mul(c, r->x, s2, s2);
+	fe_sub(c, r->x, r->x, h);
+	fe_sub(c, r->x, r->x, u1);
+	fe_sub(c, r->x, r->x, u1);
+
+	/* y3 = s2 * (u1 * h^2 - x3) - s1 * h^3 */
+	fe_sub(c, u1, u1, r->x);
+	fe_mul(c, r->y, s2, u1);
+	fe_mul(c, s1, s1, h);
+	fe_sub(c, r->y, r->y, s1);
+}
+
+/* Load the public key into @q, checking that it is a point on the curve */
+static int ecc_load_pubkey(const struct ecc_curve *c, struct ecc_point *q,
+			   const struct ecdsa_public_key *pubkey)
+{
+	u32 lhs[ECC_MAX_WORDS], rhs[ECC_MAX_WORDS];
+	uint words = c->words;
+
+	ecc_from_bytes(q->x, pubkey->x, words);
+	ecc_from_bytes(q->y, pubkey->y, words);
+	if (!ecc_less(q->x, c->p.m, words) || !ecc_less(q->y, c->p.m, words))
+		return -EINVAL;
+
+	fe_mul(c, q->x, q->x, c->p.rr);
+	fe_mul(c, q->y, q->y, c->p.rr);
+	ecc_mont_one(q->z, &c->p, words);
+
+	/* y^2 = x^3 - 3 * x + b */
+	fe_mul(c, lhs, q->y, q->y);
+	fe_mul(c, rhs, q->x, q->x);
+	fe_mul(c, rhs, rhs, q->x);
+	fe_sub(c, rhs, rhs, q->x);
+	fe_sub(c, rhs, rhs, q->x);
+	fe_sub(c, rhs, rhs, q->x);
+	fe_add(c, rhs, rhs, c->b);
+	if (!ecc_equal(lhs, rhs, words))
+		return -EINVAL;
+
+	return 0;
+}
+
+/* Fill in table[i + 4 * j] = i * G + j * Q, with table[4] = Q on entry */
+static void ecc_build_table(const struct ecc_curve *c,
+			    struct ecc_point table[1 << (2 * ECC_WINDOW)])
+{
+	const uint n = 1 << ECC_WINDOW;
+	uint i, j;
+
+	memset(&table[0], '\0', sizeof(table[0]));
+	memcpy(table[1].x, c->gx, c->words * sizeof(u32));
+	memcpy(table[1].y, c->gy, c->words * sizeof(u32));
+	ecc_mont_one(table[1].z, &c->p, c->words);
+
+	for (i = 2; i < n; i++) {
+		ecc_point_add(c, &table[i], &table[i - 1], &table[1]);
+		ecc_point_add(c, &table[i * n], &table[(i - 1) * n], &table[n]);
+	}
+
+	for (j = n; j < n * n; j += n) {
+		for (i = 1; i < n; i++)
+			ecc_point_add(c, &table[i + j], &table[i], &table[j]);
+	}
+}
+
+static uint ecc_window(const u32 *k, uint bit)
+{
+	return (k[bit / 32] >> (bit % 32)) & ((1 << ECC_WINDOW) - 1);
+}
+
+static int ecdsa_sw_verify(struct udevice *dev,
+			   const struct ecdsa_public_key *pubkey,
+			   const void *hash, size_t hash_len,
+			   const void *signature, size_t sig_len)
+{
+	struct ecc_point table[1 << (2 * ECC_WINDOW)];
+	u32 r[ECC_MAX_WORDS], s[ECC_MAX_WORDS], e[ECC_MAX_WORDS];
+	u32 u1[ECC_MAX_WORDS], u2[ECC_MAX_WORDS];
+	u8 buf[ECC_MAX_WORDS * 4];
+	const struct ecc_curve *c;
+	struct ecc_point acc;
+	uint words, nbytes, bit, idx;
+	int ret;
+
+	c = ecc_find_curve(pubkey->curve_name);
+	if (!c) {
+		debug("%s: Unsupported curve '%s'\n", __func__,
+		      pubkey->curve_name);
+		return -ENOPROTOOPT;
+	}
+
+	words = c->words;
+	nbytes = words * 4;
+	if (pubkey->size_bits != nbytes * 8 || sig_len != 2 * nbytes)
+		return -EINVAL;
+
+	ret = ecc_load_pubkey(c, &table[1 << ECC_WINDOW], pubkey);
+	if (ret) {
+		debug("%s: Public key is not on the curve\n", __func__);
+		return ret;
+	}
+
+	/* 0 < r, s < n */
+	ecc_from_bytes(r, signature, words);
+	ecc_from_bytes(s, signature + nbytes, words);
+	if (ecc_is_zero(r, words) || !ecc_less(r, c->n.m, words) ||
+	    ecc_is_zero(s, words) || !ecc_less(s, c->n.m, words))
+		return -EPERM;
+
+	/* e is the leftmost bits of the hash, reduced mod n */
+	memset(buf, '\0', sizeof(buf));
+	if (hash_len >= nbytes)
+		memcpy(buf, hash, nbytes);
+	else
+		memcpy(buf + nbytes - hash_len, hash, hash_len);
+	ecc_from_bytes(e, buf, words);
+	if (!ecc_less(e, c->n.m, words))
+		ecc_sub_raw(e, e, c->n.m, words);
+
+	/* u1 = e / s, u2 = r / s mod n, out of Montgomery form */
+	ecc_mont_mul(s, s, c->n.rr, &c->n, words);
+	ecc_mont_inv(s, s, &c->n, words);
+	ecc_mont_mul(u1, e, s, &c->n, words);
+	ecc_mont_mul(u2, r, s, &c->n, words);
+
+	/* acc = u1 * G + u2 * Q */
+	ecc_build_table(c, table);
+	memset(&acc, '\0', sizeof(acc));
+	for (bit = words * 32; bit;) {
+		bit -= ECC_WINDOW;
+		for (idx = 0; idx < ECC_WINDOW; idx++)
+			ecc_point_double(c, &acc, &acc);
+		idx = ecc_window(u1, bit) | ecc_window(u2, bit) << ECC_WINDOW;
+		ecc_point_add(c, &acc, &acc, &table[idx]);
+	}
+	if (ecc_is_zero(acc.z, words))
+		return -EPERM;
+
+	/*
+	 * The signature is good if x(acc) mod n == r. Since x(acc) = X / Z^2,
+	 * check X == r * Z^2 and, if r + n < p, X == (r + n) * Z^2.
+	 */
+	fe_mul(c, acc.z, acc.z, acc.z);
+	fe_mul(c, e, r, c->p.rr);
+	fe_mul(c, e, e, acc.z);
+	if (ecc_equal(e, acc.x, words))
+		return 0;
+
+	if (ecc_add_raw(r, r, c->n.m, words) || !ecc_less(r, c->p.m, words))
+		return -EPERM;
+	fe_mul(c, e, r, c->p.rr);
+	fe_mul(c, e, e, acc.z);
+
+	return ecc_equal(e, acc.x, words) ? 0 : -EPERM;
+}
+
+static const struct ecdsa_ops ecdsa_sw_ops = {
+	.verify = ecdsa_sw_verify,
+};
+
+U_BOOT_DRIVER(ecdsa_sw) = {
+	.name	= "ecdsa_sw",
+	.id	= UCLASS_ECDSA,
+	.ops	= &ecdsa_sw_ops,
+	.flags	= DM_FLAG_PRE_RELOC,
+};
+
+/*
+ * Devices are bound in the order of their names here. Keep this one after
+ * the hardware verifiers, so that ecdsa_verify() only falls back to software
+ * when they cannot handle a key.
+ */
+U_BOOT_DRVINFO(sw_ecdsa) = {
+	.name = "ecdsa_sw",
+};
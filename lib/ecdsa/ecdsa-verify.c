@@ -22,6 +22,8 @@ static int ecdsa_key_size(const char *curve_name)
 {
 	if (!strcmp(curve_name, "prime256v1"))
 		return 256;
+	else if (!strcmp(curve_name, "secp384r1"))
+		return 384;
 	else
 		return 0;
 }
@@ -101,7 +103,7 @@ int ecdsa_verify(struct image_sign_info *info,
 	const struct checksum_algo *algo = info->checksum;
 	uint8_t hash[algo->checksum_len];
 	struct udevice *dev;
-	int ret;
+	int ret, err;
 
 	ret = uclass_first_device_err(UCLASS_ECDSA, &dev);
 	if (ret) {
@@ -113,7 +115,23 @@ int ecdsa_verify(struct image_sign_info *info,
 	if (ret < 0)
 		return -EINVAL;
 
-	return ecdsa_verify_hash(dev, info, hash, sig, sig_len);
+	/*
+	 * Use the first device that accepts the signature, so that software
+	 * takes over for keys which an accelerator cannot handle
+	 */
+	ret = -ENODEV;
+	for (err = uclass_first_device_check(UCLASS_ECDSA, &dev);
+	     dev;
+	     err = uclass_next_device_check(&dev)) {
+		if (err)
+			continue;
+		ret = ecdsa_verify_hash(dev, info, hash, sig, sig_len);
+		if (!ret)
+			break;
+		debug("ECDSA: %s failed (err=%d)\n", dev->name, ret);
+	}
+
+	return ret;
 }
 
 U_BOOT_CRYPTO_ALGO(ecdsa) = {
@@ -122,6 +140,12 @@ U_BOOT_CRYPTO_ALGO(ecdsa) = {
 	.verify = ecdsa_verify,
 };
 
+U_BOOT_CRYPTO_ALGO(ecdsa384) = {
+	.name = "ecdsa384",
+	.key_len = ECDSA384_BYTES,
+	.verify = ecdsa_verify,
+};
+
 /*
  * uclass definition for ECDSA API
  *
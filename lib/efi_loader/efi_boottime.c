@@ -15,7 +15,9 @@
 #include <log.h>
 #include <malloc.h>
 #include <pe.h>
+#include <serial.h>
 #include <time.h>
+#include <trace.h>
 #include <u-boot/crc.h>
 #include <usb.h>
 #include <watchdog.h>
@@ -2166,7 +2168,12 @@ static efi_status_t EFIAPI efi_exit_boot_services(efi_handle_t image_handle,
 			list_del(&evt->link);
 	}
 
+	/* The OS owns the console from now on */
+	serial_flush();
+
 	if (!efi_st_keep_devices) {
+		if (IS_ENABLED(CONFIG_PROFILE))
+			profile_stop();
 		bootm_disable_interrupts();
 		if (IS_ENABLED(CONFIG_USB_DEVICE))
 			udc_disconnect();
@@ -3058,6 +3065,7 @@ efi_status_t EFIAPI efi_start_image(efi_handle_t image_handle,
 	current_image = image_handle;
 	image_obj->header.type = EFI_OBJECT_TYPE_STARTED_IMAGE;
 	EFI_PRINT("Jumping into 0x%p\n", image_obj->entry);
+	serial_flush();
 	ret = EFI_CALL(image_obj->entry(image_handle, &systab));
 
 	/*
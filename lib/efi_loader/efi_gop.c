@@ -492,6 +492,9 @@ efi_status_t efi_gop_register(void)
 		return EFI_SUCCESS;
 	}
 
+	/* The frame buffer must stay where the application is told it is */
+	if (video_fix_offset(vdev))
+		return EFI_DEVICE_ERROR;
 	priv = dev_get_uclass_priv(vdev);
 	bpix = priv->bpix;
 	format = priv->format;
@@ -13,6 +13,7 @@
 #include <efi_loader.h>
 #include <efi_variable.h>
 #include <efi_tcg2.h>
+#include <hash.h>
 #include <log.h>
 #include <malloc.h>
 #include <smbios.h>
@@ -20,9 +21,6 @@
 #include <tpm-v2.h>
 #include <tpm_api.h>
 #include <u-boot/hash-checksum.h>
-#include <u-boot/sha1.h>
-#include <u-boot/sha256.h>
-#include <u-boot/sha512.h>
 #include <linux/unaligned/be_byteshift.h>
 #include <linux/unaligned/le_byteshift.h>
 #include <linux/unaligned/generic.h>
@@ -70,6 +68,7 @@ struct digest_info {
 	u16 hash_alg;
 	u32 hash_mask;
 	u16 hash_len;
+	const char *hash_name;
 };
 
 static const struct digest_info hash_algo_list[] = {
@@ -77,24 +76,35 @@ static const struct digest_info hash_algo_list[] = {
 		TPM2_ALG_SHA1,
 		EFI_TCG2_BOOT_HASH_ALG_SHA1,
 		TPM2_SHA1_DIGEST_SIZE,
+		"sha1",
 	},
 	{
 		TPM2_ALG_SHA256,
 		EFI_TCG2_BOOT_HASH_ALG_SHA256,
 		TPM2_SHA256_DIGEST_SIZE,
+		"sha256",
 	},
 	{
 		TPM2_ALG_SHA384,
 		EFI_TCG2_BOOT_HASH_ALG_SHA384,
 		TPM2_SHA384_DIGEST_SIZE,
+		"sha384",
 	},
 	{
 		TPM2_ALG_SHA512,
 		EFI_TCG2_BOOT_HASH_ALG_SHA512,
 		TPM2_SHA512_DIGEST_SIZE,
+		"sha512",
 	},
 };
 
+/*
+ * Bitmap of the active PCR banks, 0 until read from the TPM. The banks can
+ * only change with TPM2_PCR_Allocate and a TPM reset, which do not happen
+ * here, so there is no need to ask the TPM for every measurement.
+ */
+static u32 active_pcr_banks_cache;
+
 struct variable_info {
 	const u16	*name;
 	bool		accept_empty;
@@ -134,25 +144,6 @@ static u32 alg_to_mask(u16 hash_alg)
 	return 0;
 }
 
-/**
- * alg_to_len - Get a TCG hash len for algorithms
- *
- * @hash_alg: TCG defined algorithm
- *
- * @Return: len of chosen algorithm, 0 if the algorithm is not supported
- */
-static u16 alg_to_len(u16 hash_alg)
-{
-	size_t i;
-
-	for (i = 0; i < MAX_HASH_COUNT; i++) {
-		if (hash_algo_list[i].hash_alg == hash_alg)
-			return hash_algo_list[i].hash_len;
-	}
-
-	return 0;
-}
-
 static bool is_tcg2_protocol_installed(void)
 {
 	struct efi_handler *handler;
@@ -173,7 +164,7 @@ static u32 tcg_event_final_size(struct tpml_digest_values *digest_list)
 		u16 hash_alg = digest_list->digests[i].hash_alg;
 
 		len += offsetof(struct tpmt_ha, digest);
-		len += alg_to_len(hash_alg);
+		len += tpm2_algorithm_to_len(hash_alg);
 	}
 	len += sizeof(u32); /* tcg_pcr_event2 event_size*/
 
@@ -191,18 +182,15 @@ static efi_status_t tcg2_pcr_extend(struct udevice *dev, u32 pcr_index,
 				    struct tpml_digest_values *digest_list)
 {
 	u32 rc;
-	size_t i;
 
-	for (i = 0; i < digest_list->count; i++) {
-		u32 alg = digest_list->digests[i].hash_alg;
+	if (!digest_list->count)
+		return EFI_SUCCESS;
 
-		rc = tpm2_pcr_extend(dev, pcr_index, alg,
-				     (u8 *)&digest_list->digests[i].digest,
-				     alg_to_len(alg));
-		if (rc) {
-			EFI_PRINT("Failed to extend PCR\n");
-			return EFI_DEVICE_ERROR;
-		}
+	/* All the banks are extended by a single command */
+	rc = tpm2_pcr_extend_digests(dev, pcr_index, digest_list);
+	if (rc) {
+		EFI_PRINT("Failed to extend PCR\n");
+		return EFI_DEVICE_ERROR;
 	}
 
 	return EFI_SUCCESS;
@@ -235,8 +223,8 @@ static efi_status_t tcg2_pcr_read(struct udevice *dev, u32 pcr_index,
 		u8 *digest = (u8 *)&digest_list->digests[i].digest;
 
 		rc = tpm2_pcr_read(dev, pcr_index, pcr_select_min,
-				   hash_alg, digest, alg_to_len(hash_alg),
-				   &updates);
+				   hash_alg, digest,
+				   tpm2_algorithm_to_len(hash_alg), &updates);
 		if (rc) {
 			EFI_PRINT("Failed to read PCR\n");
 			return EFI_DEVICE_ERROR;
@@ -283,8 +271,9 @@ static void put_event(u32 pcr_index, u32 event_type,
 
 		put_unaligned_le16(hash_alg, (void *)((uintptr_t)log + pos));
 		pos += offsetof(struct tpmt_ha, digest);
-		memcpy((void *)((uintptr_t)log + pos), digest, alg_to_len(hash_alg));
-		pos += alg_to_len(hash_alg);
+		memcpy((void *)((uintptr_t)log + pos), digest,
+		       tpm2_algorithm_to_len(hash_alg));
+		pos += tpm2_algorithm_to_len(hash_alg);
 	}
 
 	put_unaligned_le32(size, (void *)((uintptr_t)log + pos));
@@ -638,6 +627,11 @@ static efi_status_t __get_active_pcr_banks(u32 *active_pcr_banks)
 	efi_status_t ret;
 	int err;
 
+	if (active_pcr_banks_cache) {
+		*active_pcr_banks = active_pcr_banks_cache;
+		return EFI_SUCCESS;
+	}
+
 	ret = platform_get_tpm2_device(&dev);
 	if (ret != EFI_SUCCESS)
 		goto out;
@@ -649,6 +643,7 @@ static efi_status_t __get_active_pcr_banks(u32 *active_pcr_banks)
 	}
 
 	*active_pcr_banks = active;
+	active_pcr_banks_cache = active;
 
 out:
 	return ret;
@@ -666,10 +661,8 @@ out:
 static efi_status_t tcg2_create_digest(const u8 *input, u32 length,
 				       struct tpml_digest_values *digest_list)
 {
-	sha1_context ctx;
-	sha256_context ctx_256;
-	sha512_context ctx_512;
 	u8 final[TPM2_SHA512_DIGEST_SIZE];
+	struct hash_algo *algo;
 	efi_status_t ret;
 	u32 active;
 	size_t i;
@@ -684,34 +677,15 @@ static efi_status_t tcg2_create_digest(const u8 *input, u32 length,
 
 		if (!(active & alg_to_mask(hash_alg)))
 			continue;
-		switch (hash_alg) {
-		case TPM2_ALG_SHA1:
-			sha1_starts(&ctx);
-			sha1_update(&ctx, input, length);
-			sha1_finish(&ctx, final);
-			break;
-		case TPM2_ALG_SHA256:
-			sha256_starts(&ctx_256);
-			sha256_update(&ctx_256, input, length);
-			sha256_finish(&ctx_256, final);
-			break;
-		case TPM2_ALG_SHA384:
-			sha384_starts(&ctx_512);
-			sha384_update(&ctx_512, input, length);
-			sha384_finish(&ctx_512, final);
-			break;
-		case TPM2_ALG_SHA512:
-			sha512_starts(&ctx_512);
-			sha512_update(&ctx_512, input, length);
-			sha512_finish(&ctx_512, final);
-			break;
-		default:
+		/* The hash layer picks a hardware implementation if there is one */
+		if (hash_lookup_algo(hash_algo_list[i].hash_name, &algo)) {
 			EFI_PRINT("Unsupported algorithm %x\n", hash_alg);
 			return EFI_INVALID_PARAMETER;
 		}
+		algo->hash_func_ws(input, length, final, algo->chunk_size);
 		digest_list->digests[digest_list->count].hash_alg = hash_alg;
 		memcpy(&digest_list->digests[digest_list->count].digest, final,
-		       (u32)alg_to_len(hash_alg));
+		       tpm2_algorithm_to_len(hash_alg));
 		digest_list->count++;
 	}
 
@@ -935,7 +909,7 @@ static efi_status_t tcg2_hash_pe_image(void *efi, u64 efi_size,
 		}
 		digest_list->digests[digest_list->count].hash_alg = hash_alg;
 		memcpy(&digest_list->digests[digest_list->count].digest, hash,
-		       (u32)alg_to_len(hash_alg));
+		       tpm2_algorithm_to_len(hash_alg));
 		digest_list->count++;
 	}
 
@@ -1466,8 +1440,9 @@ static efi_status_t tcg2_parse_event(struct udevice *dev, void *buffer,
 			return EFI_COMPROMISED_DATA;
 
 		pos += offsetof(struct tpmt_ha, digest);
-		memcpy(digest, (void *)((uintptr_t)event + pos), alg_to_len(hash_alg));
-		pos += alg_to_len(hash_alg);
+		memcpy(digest, (void *)((uintptr_t)event + pos),
+		       tpm2_algorithm_to_len(hash_alg));
+		pos += tpm2_algorithm_to_len(hash_alg);
 	}
 
 	size = get_unaligned_le32((void *)((uintptr_t)event + pos));
@@ -1547,7 +1522,7 @@ static efi_status_t tcg2_get_fw_eventlog(struct udevice *dev, void *log_buffer,
 		u16 hash_alg = digest_list.digests[i].hash_alg;
 
 		if (!memcmp((u8 *)&digest_list.digests[i].digest, hash_buf,
-			    alg_to_len(hash_alg)))
+			    tpm2_algorithm_to_len(hash_alg)))
 			extend_pcr = true;
 	}
 
@@ -1571,7 +1546,7 @@ static efi_status_t tcg2_get_fw_eventlog(struct udevice *dev, void *log_buffer,
 				u8 *digest =
 				   (u8 *)&digest_list.digests[i].digest;
 
-				memset(digest, 0, alg_to_len(hash_alg));
+				memset(digest, 0, tpm2_algorithm_to_len(hash_alg));
 			}
 		}
 	}
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Statistics for storage operations
+ */
+
+#include <common.h>
+#include <display_options.h>
+#include <div64.h>
+#include <io_stats.h>
+#include <time.h>
+#include <linux/libfdt.h>
+#include <linux/log2.h>
+
+static const char *const io_stats_op_name[IO_STATS_OP_COUNT] = {
+	[IO_STATS_READ]		= "read",
+	[IO_STATS_WRITE]	= "write",
+	[IO_STATS_ERASE]	= "erase",
+};
+
+static uint io_stats_bucket(u64 val)
+{
+	if (!val)
+		return 0;
+
+	return min(ilog2(val) + 1, IO_STATS_BUCKETS - 1);
+}
+
+void io_stats_add(struct io_stats *stats, enum io_stats_op op, u64 bytes,
+		  ulong start_us, bool ok)
+{
+	struct io_op_stats *ops = &stats->op[op];
+	ulong time_us = timer_get_us() - start_us;
+
+	ops->requests++;
+	if (!ok)
+		ops->errors++;
+	ops->bytes += bytes;
+	ops->time_us += time_us;
+	ops->max_us = max(ops->max_us, (u32)time_us);
+	ops->size_hist[io_stats_bucket(bytes)]++;
+	ops->time_hist[io_stats_bucket(time_us)]++;
+}
+
+void io_stats_clear(struct io_stats *stats)
+{
+	memset(stats, '\0', sizeof(*stats));
+}
+
+bool io_stats_active(const struct io_stats *stats)
+{
+	int op;
+
+	for (op = 0; op < IO_STATS_OP_COUNT; op++) {
+		if (stats->op[op].requests)
+			return true;
+	}
+
+	return stats->cache_hits;
+}
+
+static void print_hist(const char *name, const u32 hist[])
+{
+	int i;
+
+	printf("    %s\n", name);
+	for (i = 0; i < IO_STATS_BUCKETS; i++) {
+		u64 low = i ? 1ULL << (i - 1) : 0;
+
+		if (!hist[i])
+			continue;
+		if (i == IO_STATS_BUCKETS - 1)
+			printf("%14llu-%-12s%10u\n", low, "", hist[i]);
+		else
+			printf("%14llu-%-12llu%10u\n", low,
+			       i ? (1ULL << i) - 1 : 0, hist[i]);
+	}
+}
+
+void io_stats_print(const struct io_stats *stats, bool verbose)
+{
+	int op;
+
+	for (op = 0; op < IO_STATS_OP_COUNT; op++) {
+		const struct io_op_stats *ops = &stats->op[op];
+
+		if (!ops->requests)
+			continue;
+		printf("  %-6s%8u requests, ", io_stats_op_name[op],
+		       ops->requests);
+		print_size(ops->bytes, "");
+		printf(" in %llu us", ops->time_us);
+		if (ops->time_us) {
+			printf(" (");
+			print_size(lldiv(ops->bytes * 1000, ops->time_us) *
+				   1000, "/s");
+			printf(")");
+		}
+		printf(", max %u us", ops->max_us);
+		if (ops->errors)
+			printf(", %u errors", ops->errors);
+		printf("\n");
+		if (verbose) {
+			print_hist("size (bytes)", ops->size_hist);
+			print_hist("latency (us)", ops->time_hist);
+		}
+	}
+	if (stats->cache_hits)
+		printf("  cache %8u hits\n", stats->cache_hits);
+}
+
+static int fdt_add_hist(void *blob, int node, const char *name,
+			const u32 hist[])
+{
+	fdt32_t cells[IO_STATS_BUCKETS];
+	int count = 0;
+	int i;
+
+	/* Drop empty buckets from the end */
+	for (i = 0; i < IO_STATS_BUCKETS; i++) {
+		cells[i] = cpu_to_fdt32(hist[i]);
+		if (hist[i])
+			count = i + 1;
+	}
+
+	return fdt_setprop(blob, node, name, cells, count * sizeof(fdt32_t));
+}
+
+int io_stats_fdt_add(void *blob, int parent, const char *name,
+		     const struct io_stats *stats)
+{
+	char prop[30];
+	int node;
+	int ret;
+	int op;
+
+	node = fdt_add_subnode(blob, parent, name);
+	if (node < 0)
+		return node;
+
+	for (op = 0; op < IO_STATS_OP_COUNT; op++) {
+		const struct io_op_stats *ops = &stats->op[op];
+		const char *opname = io_stats_op_name[op];
+
+		if (!ops->requests)
+			continue;
+		snprintf(prop, sizeof(prop), "%s-requests", opname);
+		ret = fdt_setprop_u32(blob, node, prop, ops->requests);
+		if (!ret && ops->errors) {
+			snprintf(prop, sizeof(prop), "%s-errors", opname);
+			ret = fdt_setprop_u32(blob, node, prop, ops->errors);
+		}
+		if (!ret) {
+			snprintf(prop, sizeof(prop), "%s-bytes", opname);
+			ret = fdt_setprop_u64(blob, node, prop, ops->bytes);
+		}
+		if (!ret) {
+			snprintf(prop, sizeof(prop), "%s-us", opname);
+			ret = fdt_setprop_u64(blob, node, prop, ops->time_us);
+		}
+		if (!ret) {
+			snprintf(prop, sizeof(prop), "%s-max-us", opname);
+			ret = fdt_setprop_u32(blob, node, prop, ops->max_us);
+		}
+		if (!ret) {
+			snprintf(prop, sizeof(prop), "%s-size-hist", opname);
+			ret = fdt_add_hist(blob, node, prop, ops->size_hist);
+		}
+		if (!ret) {
+			snprintf(prop, sizeof(prop), "%s-time-hist", opname);
+			ret = fdt_add_hist(blob, node, prop, ops->time_hist);
+		}
+		if (ret)
+			return ret;
+	}
+	if (stats->cache_hits) {
+		ret = fdt_setprop_u32(blob, node, "cache-hits",
+				      stats->cache_hits);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
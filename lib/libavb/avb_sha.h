@@ -28,21 +28,36 @@ extern "C" {
 /* Block size in bytes of a SHA-512 digest. */
 #define AVB_SHA512_BLOCK_SIZE 128
 
+#ifdef CONFIG_LIBAVB_UBOOT_HASH
+/* Hashing goes through the U-Boot hash layer, see avb_sha_uboot.c */
+struct hash_algo;
+#endif
+
 /* Data structure used for SHA-256. */
 typedef struct {
+#ifdef CONFIG_LIBAVB_UBOOT_HASH
+  struct hash_algo* algo;
+  void* hash_ctx;
+#else
   uint32_t h[8];
   uint64_t tot_len;
   size_t len;
   uint8_t block[2 * AVB_SHA256_BLOCK_SIZE];
+#endif
   uint8_t buf[AVB_SHA256_DIGEST_SIZE]; /* Used for storing the final digest. */
 } AvbSHA256Ctx;
 
 /* Data structure used for SHA-512. */
 typedef struct {
+#ifdef CONFIG_LIBAVB_UBOOT_HASH
+  struct hash_algo* algo;
+  void* hash_ctx;
+#else
   uint64_t h[8];
   uint64_t tot_len;
   size_t len;
   uint8_t block[2 * AVB_SHA512_BLOCK_SIZE];
+#endif
   uint8_t buf[AVB_SHA512_DIGEST_SIZE]; /* Used for storing the final digest. */
 } AvbSHA512Ctx;
 
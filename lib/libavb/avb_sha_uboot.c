@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * SHA-256/SHA-512 for libavb on top of the U-Boot hash layer, so that
+ * verified boot uses the same (possibly hardware accelerated) hashing as
+ * the rest of U-Boot instead of its own software implementation.
+ */
+
+#include <common.h>
+#include <hash.h>
+#include <watchdog.h>
+
+#include "avb_sha.h"
+#include "avb_util.h"
+
+/*
+ * Largest single update. Engines such as CAAM queue each update as one
+ * scatter-gather entry and only have a few of them, so partitions are
+ * passed in as few pieces as possible.
+ */
+#define AVB_SHA_CHUNK_SIZE (256 * 1024 * 1024)
+
+static void avb_sha_init(struct hash_algo** algop,
+                         void** ctxp,
+                         const char* algo_name) {
+  if (hash_progressive_lookup_algo(algo_name, algop) ||
+      (*algop)->hash_init(*algop, ctxp)) {
+    avb_fatalv("Cannot start ", algo_name, " hash\n", NULL);
+  }
+}
+
+static void avb_sha_update(struct hash_algo* algo,
+                           void* ctx,
+                           const uint8_t* data,
+                           size_t len) {
+  size_t chunk;
+
+  while (len) {
+    chunk = len > AVB_SHA_CHUNK_SIZE ? AVB_SHA_CHUNK_SIZE : len;
+    /* The hash layer frees the context on error, so this is fatal. */
+    if (algo->hash_update(algo, ctx, data, chunk, 0)) {
+      avb_fatalv("Cannot update ", algo->name, " hash\n", NULL);
+    }
+    data += chunk;
+    len -= chunk;
+    WATCHDOG_RESET();
+  }
+}
+
+static void avb_sha_final(struct hash_algo* algo,
+                          void* ctx,
+                          uint8_t* buf,
+                          size_t size) {
+  if (algo->hash_finish(algo, ctx, buf, size)) {
+    avb_fatalv("Cannot finish ", algo->name, " hash\n", NULL);
+  }
+}
+
+void avb_sha256_init(AvbSHA256Ctx* ctx) {
+  avb_sha_init(&ctx->algo, &ctx->hash_ctx, "sha256");
+}
+
+void avb_sha256_update(AvbSHA256Ctx* ctx, const uint8_t* data, size_t len) {
+  avb_sha_update(ctx->algo, ctx->hash_ctx, data, len);
+}
+
+uint8_t* avb_sha256_final(AvbSHA256Ctx* ctx) {
+  avb_sha_final(ctx->algo, ctx->hash_ctx, ctx->buf, sizeof(ctx->buf));
+  return ctx->buf;
+}
+
+void avb_sha512_init(AvbSHA512Ctx* ctx) {
+  avb_sha_init(&ctx->algo, &ctx->hash_ctx, "sha512");
+}
+
+void avb_sha512_update(AvbSHA512Ctx* ctx, const uint8_t* data, size_t len) {
+  avb_sha_update(ctx->algo, ctx->hash_ctx, data, len);
+}
+
+uint8_t* avb_sha512_final(AvbSHA512Ctx* ctx) {
+  avb_sha_final(ctx->algo, ctx->hash_ctx, ctx->buf, sizeof(ctx->buf));
+  return ctx->buf;
+}
@@ -19,6 +19,10 @@
 #include <memalign.h>
 #if defined(CONFIG_IMX_TRUSTY_OS) && !defined(CONFIG_AVB_ATX)
 #include "trusty/hwcrypto.h"
+/* The U-Boot hash layer hashes in place, without the copy for CAAM below. */
+#ifndef CONFIG_LIBAVB_UBOOT_HASH
+#define AVB_TRUSTY_HWCRYPTO_HASH
+#endif
 #endif
 
 /* Maximum number of partitions that can be loaded with avb_slot_verify(). */
@@ -300,7 +304,7 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
   size_t expected_digest_len = 0;
   uint8_t expected_digest_buf[AVB_SHA512_DIGEST_SIZE];
   const uint8_t* expected_digest = NULL;
-#if defined(CONFIG_IMX_TRUSTY_OS) && !defined(CONFIG_AVB_ATX)
+#ifdef AVB_TRUSTY_HWCRYPTO_HASH
   uint8_t* hash_out = NULL;
   uint8_t* hash_buf = NULL;
 #endif
@@ -395,7 +399,7 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
   // Although only one of the type might be used, we have to defined the
   // structure here so that they would live outside the 'if/else' scope to be
   // used later.
-#if !defined(CONFIG_IMX_TRUSTY_OS) || defined(CONFIG_AVB_ATX) ||  defined(CONFIG_XEN)
+#if !defined(AVB_TRUSTY_HWCRYPTO_HASH) || defined(CONFIG_XEN)
   AvbSHA256Ctx sha256_ctx;
 #endif
   AvbSHA512Ctx sha512_ctx;
@@ -406,7 +410,7 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     image_size_to_hash = image_size;
   }
   if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha256") == 0) {
-#if defined(CONFIG_IMX_TRUSTY_OS) && !defined(CONFIG_AVB_ATX)
+#ifdef AVB_TRUSTY_HWCRYPTO_HASH
     /* DMA requires cache aligned input/output buffer */
     hash_out = memalign(ARCH_DMA_MINALIGN, AVB_SHA256_DIGEST_SIZE);
     if (hash_out == NULL) {
@@ -489,7 +493,7 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
 
 out:
 
-#if defined(CONFIG_IMX_TRUSTY_OS) && !defined(CONFIG_AVB_ATX)
+#ifdef AVB_TRUSTY_HWCRYPTO_HASH
   if (hash_out != NULL) {
     free(hash_out);
     hash_out = NULL;
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Hardware performance counters
+ */
+
+#include <common.h>
+#include <perf_counter.h>
+#include <asm/global_data.h>
+#include <linux/bitops.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static const char *const perf_counter_names[PERF_COUNTER_COUNT] = {
+	[PERF_COUNTER_CYCLES]		= "cycles",
+	[PERF_COUNTER_INSTRUCTIONS]	= "instructions",
+	[PERF_COUNTER_L1D_MISSES]	= "l1d-misses",
+	[PERF_COUNTER_L2D_MISSES]	= "l2d-misses",
+	[PERF_COUNTER_BRANCH_MISSES]	= "branch-misses",
+};
+
+const char *perf_counter_name(enum perf_counter_id id)
+{
+	if (id >= PERF_COUNTER_COUNT)
+		return "unknown";
+
+	return perf_counter_names[id];
+}
+
+int perf_counter_read(struct perf_counter_values *vals)
+{
+	struct perf_counter_info *info = &gd->perf_info;
+	int ret;
+
+	if (!info->started) {
+		memset(info, '\0', sizeof(*info));
+		ret = arch_perf_counter_start(info);
+		if (ret)
+			return ret;
+		info->started = true;
+	}
+	memset(vals, '\0', sizeof(*vals));
+	arch_perf_counter_read(vals->val);
+	vals->valid = info->valid;
+
+	return vals->valid ? 0 : -ENOSYS;
+}
+
+void perf_counter_delta(const struct perf_counter_values *start,
+			const struct perf_counter_values *end,
+			struct perf_counter_values *delta)
+{
+	int i;
+
+	delta->valid = start->valid & end->valid;
+	for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+		if (delta->valid & BIT(i))
+			delta->val[i] = (end->val[i] - start->val[i]) &
+				gd->perf_info.mask[i];
+		else
+			delta->val[i] = 0;
+	}
+}
+
+void perf_counter_add(struct perf_counter_values *total,
+		      const struct perf_counter_values *start,
+		      const struct perf_counter_values *end)
+{
+	struct perf_counter_values delta;
+	int i;
+
+	perf_counter_delta(start, end, &delta);
+	total->valid = delta.valid;
+	for (i = 0; i < PERF_COUNTER_COUNT; i++)
+		total->val[i] += delta.val[i];
+}
+
+/* Print @num / @den with two decimal places, as integer arithmetic */
+static void print_ratio(const char *name, u64 num, u64 den, uint scale)
+{
+	u64 val = den ? num * scale * 100 / den : 0;
+
+	printf(", %s %llu.%02llu", name, val / 100, val % 100);
+}
+
+void perf_counter_print(const struct perf_counter_values *vals)
+{
+	const u64 *val = vals->val;
+	const char *sep = "";
+	int i;
+
+	for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+		if (vals->valid & BIT(i)) {
+			printf("%s%s %llu", sep, perf_counter_name(i), val[i]);
+			sep = ", ";
+		}
+	}
+	if (vals->valid & BIT(PERF_COUNTER_INSTRUCTIONS)) {
+		if (vals->valid & BIT(PERF_COUNTER_CYCLES))
+			print_ratio("IPC", val[PERF_COUNTER_INSTRUCTIONS],
+				    val[PERF_COUNTER_CYCLES], 1);
+		if (vals->valid & BIT(PERF_COUNTER_L1D_MISSES))
+			print_ratio("L1D MPKI", val[PERF_COUNTER_L1D_MISSES],
+				    val[PERF_COUNTER_INSTRUCTIONS], 1000);
+		if (vals->valid & BIT(PERF_COUNTER_L2D_MISSES))
+			print_ratio("L2D MPKI", val[PERF_COUNTER_L2D_MISSES],
+				    val[PERF_COUNTER_INSTRUCTIONS], 1000);
+	}
+	printf("\n");
+}
+
+void perf_counter_stop(void)
+{
+	if (!gd->perf_info.started)
+		return;
+	arch_perf_counter_stop();
+	gd->perf_info.started = false;
+}
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Sampling profiler
+ *
+ * A periodic timer interrupt records where U-Boot is executing. Unlike
+ * function tracing this needs no instrumentation, so it can be used with
+ * normal builds and does not distort the timing of tight loops.
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <malloc.h>
+#include <trace.h>
+#include <asm/global_data.h>
+#include <asm/sections.h>
+#include <linux/compiler.h>
+#include <linux/sizes.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Furthest distance a frame can be above the stack pointer of the sample */
+#define PROFILE_STACK_RANGE	SZ_1M
+
+/**
+ * struct profile_info - state of the sampling profiler
+ *
+ * @buf:	Sample buffer, see include/trace.h for the format
+ * @size:	Size of buffer in words
+ * @used:	Number of words used
+ * @samples:	Number of samples recorded
+ * @dropped:	Number of samples dropped because the buffer was full
+ * @period_us:	Sampling period in microseconds
+ * @running:	true if samples are being taken
+ */
+struct profile_info {
+	u32 *buf;
+	ulong size;
+	ulong used;
+	ulong samples;
+	ulong dropped;
+	uint period_us;
+	bool running;
+};
+
+static struct profile_info prof;
+
+static u32 profile_offset(ulong addr)
+{
+#ifdef CONFIG_SANDBOX
+	return addr - (ulong)&_init;
+#else
+	if (gd->flags & GD_FLG_RELOC)
+		return addr - gd->relocaddr;
+	return addr - CONFIG_SYS_TEXT_BASE;
+#endif
+}
+
+void profile_sample(ulong pc, ulong fp, ulong sp)
+{
+	ulong limit = sp + PROFILE_STACK_RANGE;
+	u32 *rec;
+	int depth;
+
+	if (!prof.running)
+		return;
+	if (prof.used + 1 + CONFIG_PROFILE_DEPTH > prof.size) {
+		prof.dropped++;
+		return;
+	}
+	rec = prof.buf + prof.used;
+	rec[1] = profile_offset(pc);
+
+	/*
+	 * Each frame starts with the caller's frame pointer followed by the
+	 * return address. Frames move up the stack, so stop as soon as the
+	 * chain goes backwards or out of range, which happens when the code
+	 * was built without frame pointers.
+	 */
+	for (depth = 1; depth < CONFIG_PROFILE_DEPTH; depth++) {
+		ulong *frame = (ulong *)fp;
+
+		if (fp < sp || fp >= limit || (fp & (sizeof(ulong) - 1)))
+			break;
+		if (!frame[1])
+			break;
+		rec[1 + depth] = profile_offset(frame[1]);
+		sp = fp + 2 * sizeof(ulong);
+		fp = frame[0];
+	}
+	rec[0] = depth;
+
+	/* The record must be complete before it is visible to readers */
+	barrier();
+	prof.used += 1 + depth;
+	prof.samples++;
+}
+
+int profile_start(uint period_us)
+{
+	int ret;
+
+	if (prof.running)
+		return 0;
+	if (!prof.buf) {
+		prof.buf = malloc(CONFIG_PROFILE_BUFFER_SIZE);
+		if (!prof.buf)
+			return -ENOMEM;
+		prof.size = CONFIG_PROFILE_BUFFER_SIZE / sizeof(u32);
+	}
+	prof.period_us = period_us;
+	prof.running = true;
+	ret = arch_profile_start(period_us);
+	if (ret) {
+		prof.running = false;
+		return ret;
+	}
+
+	return 0;
+}
+
+void profile_stop(void)
+{
+	if (!prof.running)
+		return;
+	arch_profile_stop();
+	prof.running = false;
+}
+
+void profile_clear(void)
+{
+	bool running = prof.running;
+
+	profile_stop();
+	prof.used = 0;
+	prof.samples = 0;
+	prof.dropped = 0;
+	if (running)
+		profile_start(prof.period_us);
+}
+
+void profile_print_stats(void)
+{
+	printf("Profiling %s", prof.running ? "running" : "stopped");
+	if (prof.period_us)
+		printf(", period %u us", prof.period_us);
+	printf("\n");
+	print_grouped_ull(prof.samples, 10);
+	puts(" samples\n");
+	print_grouped_ull(prof.dropped, 10);
+	puts(" samples dropped due to overflow\n");
+	print_grouped_ull(prof.used * sizeof(u32), 10);
+	printf(" of %#x bytes used\n", CONFIG_PROFILE_BUFFER_SIZE);
+}
+
+int profile_list_samples(void *buff, size_t buff_size, size_t *needed)
+{
+	struct trace_output_hdr *output_hdr = buff;
+	ulong used = prof.used;
+
+	*needed = sizeof(*output_hdr) + used * sizeof(u32);
+	if (*needed > buff_size)
+		return -ENOSPC;
+	output_hdr->type = TRACE_CHUNK_SAMPLES;
+	output_hdr->rec_count = used;
+	if (used)
+		memcpy(output_hdr + 1, prof.buf, used * sizeof(u32));
+
+	return 0;
+}
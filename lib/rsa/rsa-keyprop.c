@@ -14,8 +14,11 @@
 #include <malloc.h>
 #include <crypto/internal/rsa.h>
 #include <u-boot/rsa-mod-exp.h>
+#include <asm/global_data.h>
 #include <asm/unaligned.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
 /**
  * br_dec16be() - Convert 16-bit big-endian integer to native
  * @src:	Pointer to data
@@ -619,6 +622,91 @@ static void br_i32_reduce(uint32_t *x, const uint32_t *a, const uint32_t *m)
 	}
 }
 
+/*
+ * Working out R^2 mod n takes about as long as verifying a signature, and
+ * UEFI secure boot and capsule updates check many signatures against the
+ * same few keys. Keep the values for the last few keys seen, once BSS is
+ * available.
+ */
+#define RSA_KEYPROP_CACHE_SIZE	4
+
+struct rsa_keyprop_cache {
+	void *modulus;		/* big-endian, without leading zeroes */
+	void *rr;		/* R^2 mod n, big-endian */
+	uint32_t n0inv;
+	int num_bits;
+};
+
+static struct rsa_keyprop_cache rsa_keyprop_cache[RSA_KEYPROP_CACHE_SIZE];
+static int rsa_keyprop_cache_next;
+
+/**
+ * rsa_keyprop_cache_get() - Fill in R^2 and n0inv for a key seen before
+ *
+ * @prop:	Key properties, with the modulus and num_bits filled in
+ * Return:	0 if found, -ENOENT if not, -ENOMEM if out of memory
+ */
+static int rsa_keyprop_cache_get(struct key_prop *prop)
+{
+	int nbytes = prop->num_bits / 8;
+	struct rsa_keyprop_cache *ent;
+	int i;
+
+	if (!(gd->flags & GD_FLG_RELOC))
+		return -ENOENT;
+	for (i = 0, ent = rsa_keyprop_cache; i < RSA_KEYPROP_CACHE_SIZE;
+	     i++, ent++) {
+		if (ent->num_bits != prop->num_bits ||
+		    memcmp(ent->modulus, prop->modulus, nbytes))
+			continue;
+		prop->rr = malloc(nbytes);
+		if (!prop->rr)
+			return -ENOMEM;
+		memcpy((void *)prop->rr, ent->rr, nbytes);
+		prop->n0inv = ent->n0inv;
+
+		return 0;
+	}
+
+	return -ENOENT;
+}
+
+/**
+ * rsa_keyprop_cache_add() - Remember R^2 and n0inv for a key
+ *
+ * This replaces the oldest entry. Nothing is done if out of memory.
+ *
+ * @prop:	Key properties to remember
+ */
+static void rsa_keyprop_cache_add(const struct key_prop *prop)
+{
+	struct rsa_keyprop_cache *ent;
+	int nbytes = prop->num_bits / 8;
+	void *modulus, *rr;
+
+	if (!(gd->flags & GD_FLG_RELOC))
+		return;
+	modulus = malloc(nbytes);
+	rr = malloc(nbytes);
+	if (!modulus || !rr) {
+		free(modulus);
+		free(rr);
+		return;
+	}
+	memcpy(modulus, prop->modulus, nbytes);
+	memcpy(rr, prop->rr, nbytes);
+
+	ent = &rsa_keyprop_cache[rsa_keyprop_cache_next];
+	rsa_keyprop_cache_next = (rsa_keyprop_cache_next + 1) %
+		RSA_KEYPROP_CACHE_SIZE;
+	free(ent->modulus);
+	free(ent->rr);
+	ent->modulus = modulus;
+	ent->rr = rr;
+	ent->n0inv = prop->n0inv;
+	ent->num_bits = prop->num_bits;
+}
+
 /**
  * rsa_free_key_prop() - Free key properties
  * @prop:	Pointer to struct key_prop
@@ -678,14 +766,6 @@ int rsa_gen_key_prop(const void *key, uint32_t keylen, struct key_prop **prop)
 	}
 	memcpy((void *)(*prop)->modulus, &rsa_key.n[i], rsa_key.n_sz - i);
 
-	n = calloc(sizeof(uint32_t), 1 + ((*prop)->num_bits >> 5));
-	rr = calloc(sizeof(uint32_t), 1 + (((*prop)->num_bits * 2) >> 5));
-	rrtmp = calloc(sizeof(uint32_t), 2 + (((*prop)->num_bits * 2) >> 5));
-	if (!n || !rr || !rrtmp) {
-		ret = -ENOMEM;
-		goto out;
-	}
-
 	/* exponent */
 	(*prop)->public_exponent = calloc(1, sizeof(uint64_t));
 	if (!(*prop)->public_exponent) {
@@ -697,6 +777,19 @@ int rsa_gen_key_prop(const void *key, uint32_t keylen, struct key_prop **prop)
 	       rsa_key.e, rsa_key.e_sz);
 	(*prop)->exp_len = sizeof(uint64_t);
 
+	ret = rsa_keyprop_cache_get(*prop);
+	if (ret != -ENOENT)
+		goto out;
+	ret = 0;
+
+	n = calloc(sizeof(uint32_t), 1 + ((*prop)->num_bits >> 5));
+	rr = calloc(sizeof(uint32_t), 1 + (((*prop)->num_bits * 2) >> 5));
+	rrtmp = calloc(sizeof(uint32_t), 2 + (((*prop)->num_bits * 2) >> 5));
+	if (!n || !rr || !rrtmp) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
 	/* n0 inverse */
 	br_i32_decode(n, &rsa_key.n[i], rsa_key.n_sz - i);
 	(*prop)->n0inv = br_i32_ninv32(n[1]);
@@ -717,6 +810,7 @@ int rsa_gen_key_prop(const void *key, uint32_t keylen, struct key_prop **prop)
 		goto out;
 	}
 	br_i32_encode((void *)(*prop)->rr, rlen, rr);
+	rsa_keyprop_cache_add(*prop);
 
 out:
 	free(n);
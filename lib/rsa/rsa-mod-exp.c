@@ -255,6 +255,208 @@ static void rsa_convert_big_endian(uint32_t *dst, const uint32_t *src, int len)
 		dst[i] = fdt32_to_cpu(src[len - 1 - i]);
 }
 
+#ifdef __SIZEOF_INT128__
+/*
+ * Where the compiler has a 64x64->128-bit multiply (MUL/UMULH on arm64), use
+ * 64-bit words: each Montgomery multiply then needs a quarter of the
+ * multiply-add steps needed with 32-bit words.
+ */
+typedef unsigned __int128 uint128_t;
+
+/**
+ * struct rsa_public_key64 - RSA public key using 64-bit words
+ *
+ * @len:	Length of modulus[] and rr[] in number of uint64_t
+ * @n0inv:	-1 / modulus[0] mod 2^64
+ * @modulus:	Modulus as little endian array
+ * @rr:		R^2 as little endian array
+ * @exponent:	Public exponent
+ */
+struct rsa_public_key64 {
+	uint len;
+	uint64_t n0inv;
+	uint64_t *modulus;
+	uint64_t *rr;
+	uint64_t exponent;
+};
+
+/**
+ * ninv64() - Calculate -1 / n mod 2^64
+ *
+ * @n:	Odd number to invert
+ * Return: -1 / n mod 2^64
+ */
+static uint64_t ninv64(uint64_t n)
+{
+	uint64_t x = n;	/* correct to 3 bits, since n * n = 1 mod 8 */
+	int i;
+
+	/* Each Newton step doubles the number of correct bits */
+	for (i = 0; i < 5; i++)
+		x *= 2 - n * x;
+
+	return -x;
+}
+
+static void subtract_modulus64(const struct rsa_public_key64 *key,
+			       uint64_t num[])
+{
+	uint64_t borrow = 0;
+	uint128_t acc;
+	uint i;
+
+	for (i = 0; i < key->len; i++) {
+		acc = (uint128_t)num[i] - key->modulus[i] - borrow;
+		num[i] = (uint64_t)acc;
+		borrow = (uint64_t)(acc >> 64) & 1;
+	}
+}
+
+static int greater_equal_modulus64(const struct rsa_public_key64 *key,
+				   uint64_t num[])
+{
+	int i;
+
+	for (i = (int)key->len - 1; i >= 0; i--) {
+		if (num[i] < key->modulus[i])
+			return 0;
+		if (num[i] > key->modulus[i])
+			return 1;
+	}
+
+	return 1;  /* equal */
+}
+
+/* As montgomery_mul_add_step(), with 64-bit words */
+static void montgomery_mul_add_step64(const struct rsa_public_key64 *key,
+		uint64_t result[], const uint64_t a, const uint64_t b[])
+{
+	uint128_t acc_a, acc_b;
+	uint64_t d0;
+	uint i;
+
+	acc_a = (uint128_t)a * b[0] + result[0];
+	d0 = (uint64_t)acc_a * key->n0inv;
+	acc_b = (uint128_t)d0 * key->modulus[0] + (uint64_t)acc_a;
+	for (i = 1; i < key->len; i++) {
+		acc_a = (acc_a >> 64) + (uint128_t)a * b[i] + result[i];
+		acc_b = (acc_b >> 64) + (uint128_t)d0 * key->modulus[i] +
+				(uint64_t)acc_a;
+		result[i - 1] = (uint64_t)acc_b;
+	}
+
+	acc_a = (acc_a >> 64) + (acc_b >> 64);
+
+	result[i - 1] = (uint64_t)acc_a;
+
+	if (acc_a >> 64)
+		subtract_modulus64(key, result);
+}
+
+static void montgomery_mul64(const struct rsa_public_key64 *key,
+		uint64_t result[], uint64_t a[], const uint64_t b[])
+{
+	uint i;
+
+	for (i = 0; i < key->len; ++i)
+		result[i] = 0;
+	for (i = 0; i < key->len; ++i)
+		montgomery_mul_add_step64(key, result, a[i], b);
+}
+
+/**
+ * pow_mod64() - in-place public exponentiation with 64-bit words
+ *
+ * This is the same algorithm as pow_mod()
+ *
+ * @key:	RSA key
+ * @inout:	Big-endian byte array containing value and result
+ * @k:		Number of bits in the public exponent
+ */
+static void pow_mod64(const struct rsa_public_key64 *key, uint8_t *inout,
+		      int k)
+{
+	uint64_t val[key->len], acc[key->len], tmp[key->len];
+	uint64_t a_scaled[key->len];
+	uint i;
+	int j;
+
+	for (i = 0; i < key->len; i++)
+		val[i] = fdt64_to_cpup(inout + (key->len - 1 - i) * 8);
+
+	montgomery_mul64(key, acc, val, key->rr);
+	memcpy(a_scaled, acc, key->len * sizeof(a_scaled[0]));
+
+	for (j = k - 2; j > 0; --j) {
+		montgomery_mul64(key, tmp, acc, acc);
+		if (key->exponent & (1ULL << j))
+			montgomery_mul64(key, acc, tmp, a_scaled);
+		else
+			memcpy(acc, tmp, key->len * sizeof(acc[0]));
+	}
+
+	montgomery_mul64(key, tmp, acc, acc);
+	montgomery_mul64(key, acc, tmp, val);
+
+	if (greater_equal_modulus64(key, acc))
+		subtract_modulus64(key, acc);
+
+	for (i = 0; i < key->len; i++) {
+		fdt64_t w = cpu_to_fdt64(acc[key->len - 1 - i]);
+
+		memcpy(inout + i * 8, &w, sizeof(w));
+	}
+}
+
+/**
+ * rsa_mod_exp_sw64() - Perform RSA Modular Exponentiation with 64-bit words
+ *
+ * @sig:	Signature
+ * @sig_len:	Length of signature in bytes
+ * @prop:	Key, which must have a multiple of 64 bits
+ * @exponent:	Public exponent
+ * @out:	Result, @sig_len bytes
+ * Return: 0 if OK, -ve on error
+ */
+static int rsa_mod_exp_sw64(const uint8_t *sig, uint32_t sig_len,
+			    struct key_prop *prop, uint64_t exponent,
+			    uint8_t *out)
+{
+	struct rsa_public_key64 key;
+	uint i;
+	int k;
+
+	key.len = prop->num_bits / 64;
+	key.exponent = exponent;
+	if (sig_len != key.len * 8)
+		return -EINVAL;
+
+	uint64_t modulus[key.len], rr[key.len];
+
+	for (i = 0; i < key.len; i++) {
+		modulus[i] = fdt64_to_cpup(prop->modulus +
+					   (key.len - 1 - i) * 8);
+		rr[i] = fdt64_to_cpup(prop->rr + (key.len - 1 - i) * 8);
+	}
+	key.modulus = modulus;
+	key.rr = rr;
+	key.n0inv = ninv64(modulus[0]);
+
+	for (k = 0; k < 64 && exponent >> k; k++)
+		;
+	if (k < 2 || !(exponent & 1)) {
+		debug("Public exponent %llx is invalid\n",
+		      (unsigned long long)exponent);
+		return -EINVAL;
+	}
+
+	memcpy(out, sig, sig_len);
+	pow_mod64(&key, out, k);
+
+	return 0;
+}
+#endif
+
 int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 		struct key_prop *prop, uint8_t *out)
 {
@@ -284,6 +486,10 @@ int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 		      key.len, RSA_MIN_KEY_BITS, RSA_MAX_KEY_BITS);
 		return -EFAULT;
 	}
+#ifdef __SIZEOF_INT128__
+	if (!(key.len % 64))
+		return rsa_mod_exp_sw64(sig, sig_len, prop, key.exponent, out);
+#endif
 	key.len /= sizeof(uint32_t) * 8;
 	uint32_t key1[key.len], key2[key.len];
 
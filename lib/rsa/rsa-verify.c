@@ -335,6 +335,7 @@ static int rsa_verify_key(struct image_sign_info *info,
 	int ret;
 #if !defined(USE_HOSTCC)
 	struct udevice *mod_exp_dev;
+	int err;
 #endif
 	struct checksum_algo *checksum = info->checksum;
 	struct padding_algo *padding = info->padding;
@@ -361,13 +362,25 @@ static int rsa_verify_key(struct image_sign_info *info,
 	hash_len = checksum->checksum_len;
 
 #if !defined(USE_HOSTCC)
-	ret = uclass_get_device(UCLASS_MOD_EXP, 0, &mod_exp_dev);
-	if (ret) {
+	/*
+	 * Use the first device that works, so that an accelerator is
+	 * preferred but software takes over if it is missing or fails
+	 */
+	ret = -ENODEV;
+	for (err = uclass_first_device_check(UCLASS_MOD_EXP, &mod_exp_dev);
+	     mod_exp_dev;
+	     err = uclass_next_device_check(&mod_exp_dev)) {
+		if (err)
+			continue;
+		ret = rsa_mod_exp(mod_exp_dev, sig, sig_len, prop, buf);
+		if (!ret)
+			break;
+		debug("RSA: %s failed (err=%d)\n", mod_exp_dev->name, ret);
+	}
+	if (ret == -ENODEV) {
 		printf("RSA: Can't find Modular Exp implementation\n");
 		return -EINVAL;
 	}
-
-	ret = rsa_mod_exp(mod_exp_dev, sig, sig_len, prop, buf);
 #else
 	ret = rsa_mod_exp_sw(sig, sig_len, prop, buf);
 #endif
@@ -194,6 +194,10 @@ sha512_transform(uint64_t *state, const uint8_t *input)
 static void sha512_block_fn(sha512_context *sst, const uint8_t *src,
 				    int blocks)
 {
+#if !defined(USE_HOSTCC) && defined(CONFIG_CRYPTO_SHA512_ARM64_CE)
+	if (!sha512_arch_blocks(sst->state, src, blocks))
+		return;
+#endif
 	while (blocks--) {
 		sha512_transform(sst->state, src);
 		src += SHA512_BLOCK_SIZE;
@@ -169,6 +169,77 @@ u32 tpm2_pcr_extend(struct udevice *dev, u32 index, u32 algorithm,
 	return tpm_sendrecv_command(dev, command_v2, NULL, NULL);
 }
 
+u32 tpm2_algorithm_to_len(u16 algorithm)
+{
+	switch (algorithm) {
+	case TPM2_ALG_SHA1:
+		return TPM2_SHA1_DIGEST_SIZE;
+	case TPM2_ALG_SHA256:
+		return TPM2_SHA256_DIGEST_SIZE;
+	case TPM2_ALG_SM3_256:
+		return TPM2_SM3_256_DIGEST_SIZE;
+	case TPM2_ALG_SHA384:
+		return TPM2_SHA384_DIGEST_SIZE;
+	case TPM2_ALG_SHA512:
+		return TPM2_SHA512_DIGEST_SIZE;
+	default:
+		return 0;
+	}
+}
+
+u32 tpm2_pcr_extend_digests(struct udevice *dev, u32 index,
+			    const struct tpml_digest_values *digest_list)
+{
+	/* Length of the message header, up to the first digest */
+	uint offset = 31;
+	u8 command_v2[COMMAND_BUFFER_SIZE] = {
+		tpm_u16(TPM2_ST_SESSIONS),	/* TAG */
+		tpm_u32(0),			/* Length, filled in below */
+		tpm_u32(TPM2_CC_PCR_EXTEND),	/* Command code */
+
+		/* HANDLE */
+		tpm_u32(index),			/* Handle (PCR Index) */
+
+		/* AUTH_SESSION */
+		tpm_u32(9),			/* Authorization size */
+		tpm_u32(TPM2_RS_PW),		/* Session handle */
+		tpm_u16(0),			/* Size of <nonce> */
+						/* <nonce> (if any) */
+		0,				/* Attributes: Cont/Excl/Rst */
+		tpm_u16(0),			/* Size of <hmac/password> */
+						/* <hmac/password> (if any) */
+
+		/* hashes */
+		tpm_u32(digest_list->count),	/* Count (number of hashes) */
+		/* (Algorithm, STRING(digest)) for each hash */
+	};
+	u32 i, digest_len;
+	int ret;
+
+	for (i = 0; i < digest_list->count; i++) {
+		u16 algorithm = digest_list->digests[i].hash_alg;
+
+		digest_len = tpm2_algorithm_to_len(algorithm);
+		if (!digest_len)
+			return TPM_LIB_ERROR;
+
+		ret = pack_byte_string(command_v2, sizeof(command_v2), "ws",
+				       offset, algorithm,
+				       offset + sizeof(algorithm),
+				       (u8 *)&digest_list->digests[i].digest,
+				       digest_len);
+		if (ret)
+			return TPM_LIB_ERROR;
+		offset += sizeof(algorithm) + digest_len;
+	}
+
+	ret = pack_byte_string(command_v2, sizeof(command_v2), "d", 2, offset);
+	if (ret)
+		return TPM_LIB_ERROR;
+
+	return tpm_sendrecv_command(dev, command_v2, NULL, NULL);
+}
+
 u32 tpm2_nv_read_value(struct udevice *dev, u32 index, void *data, u32 count)
 {
 	u8 command_v2[COMMAND_BUFFER_SIZE] = {
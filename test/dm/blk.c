@@ -5,6 +5,7 @@
 
 #include <common.h>
 #include <dm.h>
+#include <io_stats.h>
 #include <part.h>
 #include <usb.h>
 #include <asm/global_data.h>
@@ -217,3 +218,41 @@ static int dm_test_blk_iter(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_blk_iter, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+#if CONFIG_IS_ENABLED(BLK_STATS)
+/* Test that block-device requests are counted */
+static int dm_test_blk_stats(struct unit_test_state *uts)
+{
+	const struct io_op_stats *ops;
+	struct blk_desc *desc;
+	struct udevice *dev;
+	u8 buf[4 << 9];
+
+	ut_assertok(blk_get_device(IF_TYPE_MMC, 2, &dev));
+	desc = dev_get_uclass_plat(dev);
+	io_stats_clear(&desc->stats);
+	ut_asserteq(false, io_stats_active(&desc->stats));
+
+	ut_asserteq(4, blk_dread(desc, 0, 4, buf));
+	ut_asserteq(4, blk_dread(desc, 8, 4, buf));
+	ut_asserteq(1, blk_dwrite(desc, 0, 1, buf));
+	ut_asserteq(true, io_stats_active(&desc->stats));
+
+	/* Bucket 12 holds requests of 2048..4095 bytes */
+	ops = &desc->stats.op[IO_STATS_READ];
+	ut_asserteq(2, ops->requests);
+	ut_asserteq(0, ops->errors);
+	ut_asserteq(8 << 9, ops->bytes);
+	ut_asserteq(2, ops->size_hist[12]);
+
+	ops = &desc->stats.op[IO_STATS_WRITE];
+	ut_asserteq(1, ops->requests);
+	ut_asserteq(1 << 9, ops->bytes);
+	ut_asserteq(1, ops->size_hist[10]);
+
+	ut_asserteq(0, desc->stats.op[IO_STATS_ERASE].requests);
+
+	return 0;
+}
+DM_TEST(dm_test_blk_stats, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+#endif
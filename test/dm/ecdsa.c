@@ -9,9 +9,8 @@
 /*
  * Basic test of the ECDSA uclass and ecdsa_verify()
  *
- * ECDSA implementations in u-boot are hardware-dependent. Until we have a
- * software implementation that can be compiled into the sandbox, all we can
- * test is the uclass support.
+ * ECDSA implementations in u-boot are mostly hardware-dependent. Without the
+ * software implementation, all we can test is the uclass support.
  *
  * The uclass_get() test is redundant since ecdsa_verify() would also fail. We
  * run both functions in order to isolate the cause more clearly. i.e. is
@@ -31,8 +30,152 @@ static int dm_test_ecdsa_verify(struct unit_test_state *uts)
 
 	ut_assertok(uclass_get(UCLASS_ECDSA, &ucp));
 	ut_assertnonnull(ucp);
-	ut_asserteq(-ENODEV, ecdsa_verify(&info, NULL, 0, NULL, 0));
+	if (!IS_ENABLED(CONFIG_ECDSA_SOFTWARE))
+		ut_asserteq(-ENODEV, ecdsa_verify(&info, NULL, 0, NULL, 0));
 
 	return 0;
 }
 DM_TEST(dm_test_ecdsa_verify, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+#if CONFIG_IS_ENABLED(ECDSA_SOFTWARE)
+/* Signatures of "U-Boot" made with openssl dgst -sha256 / -sha384 -sign */
+static const u8 p256_x[] = {
+	0xe2, 0xab, 0x1c, 0xfd, 0x57, 0x3d, 0xd8, 0x9f,
+	0x7e, 0x59, 0x3a, 0x58, 0x35, 0x9e, 0x0b, 0x82,
+	0x36, 0x9c, 0xc0, 0x99, 0x15, 0x99, 0xdb, 0x81,
+	0xf2, 0x0f, 0x09, 0x64, 0xd3, 0x31, 0x0f, 0x3d,
+};
+
+static const u8 p256_y[] = {
+	0xbd, 0x9b, 0x71, 0xd2, 0xbf, 0x56, 0x55, 0x60,
+	0x3d, 0x90, 0x29, 0xec, 0x5c, 0x5f, 0x56, 0x9d,
+	0x6c, 0x35, 0xe5, 0xa7, 0xac, 0x3d, 0x99, 0x8e,
+	0x81, 0xfa, 0xc6, 0x3e, 0xf7, 0x4c, 0xa5, 0xe9,
+};
+
+static const u8 p256_hash[] = {
+	0x8a, 0x48, 0xe0, 0xd6, 0x94, 0xfc, 0x44, 0xb8,
+	0x28, 0xb4, 0x7f, 0xf5, 0x13, 0x43, 0x5a, 0x25,
+	0x87, 0x8b, 0xaf, 0xbe, 0x53, 0xb4, 0xfb, 0x93,
+	0xeb, 0xc8, 0x28, 0x93, 0x9f, 0xb5, 0xa1, 0x07,
+};
+
+static const u8 p256_sig[] = {
+	0xb5, 0xbb, 0xcc, 0x42, 0xc0, 0x54, 0x21, 0x2d,
+	0x65, 0x37, 0x5a, 0x41, 0xe4, 0xb2, 0x3e, 0xbd,
+	0x98, 0x46, 0x86, 0x26, 0x31, 0xf5, 0xb1, 0x43,
+	0x7a, 0xa0, 0x38, 0x24, 0x63, 0xe9, 0xde, 0x5b,
+	0xfa, 0x26, 0xfb, 0x94, 0x6d, 0x1b, 0x83, 0x25,
+	0xed, 0xa0, 0x04, 0x70, 0xb8, 0xd5, 0x3b, 0xc9,
+	0x7d, 0xfb, 0xe0, 0xe0, 0xb1, 0x94, 0xd3, 0x4c,
+	0xc5, 0x20, 0x4d, 0x51, 0x38, 0x04, 0x1d, 0xf8,
+};
+
+static const u8 p384_x[] = {
+	0x3a, 0xa5, 0x82, 0x7c, 0xef, 0x55, 0xc0, 0xd2,
+	0x9d, 0xaf, 0x41, 0x27, 0x36, 0xb2, 0xde, 0x76,
+	0x65, 0x22, 0xab, 0xe7, 0x5e, 0xb7, 0xcf, 0xd2,
+	0x0b, 0xb5, 0xa4, 0x53, 0x8b, 0x6c, 0x5e, 0x9e,
+	0x24, 0xce, 0x10, 0x95, 0x6f, 0xd1, 0xe1, 0xa7,
+	0x8b, 0x4d, 0x25, 0xc6, 0xa2, 0x9b, 0x44, 0x28,
+};
+
+static const u8 p384_y[] = {
+	0xd4, 0xe4, 0x02, 0xf2, 0xc8, 0x18, 0xd5, 0x8c,
+	0xc0, 0xcd, 0x89, 0x00, 0xc0, 0xe5, 0xf1, 0x84,
+	0xaf, 0x38, 0xce, 0xe9, 0xb0, 0x7c, 0x3e, 0x1a,
+	0x9e, 0x21, 0x68, 0x13, 0xf8, 0x19, 0x97, 0x98,
+	0x1a, 0x70, 0x64, 0xb3, 0x3c, 0x99, 0xaf, 0x53,
+	0xe6, 0x37, 0x6f, 0xe5, 0xb9, 0xd0, 0xc3, 0xe3,
+};
+
+static const u8 p384_hash[] = {
+	0xf3, 0x33, 0x7f, 0xdb, 0x32, 0x02, 0x8b, 0xa3,
+	0x5b, 0x1f, 0x41, 0xe4, 0xed, 0xac, 0xb9, 0xc0,
+	0x71, 0x74, 0x2c, 0x6a, 0x4b, 0x1e, 0x6a, 0x94,
+	0x0e, 0x92, 0x3a, 0x54, 0x08, 0x19, 0x89, 0x29,
+	0x19, 0x4f, 0x76, 0xa4, 0x5a, 0x62, 0xad, 0x70,
+	0xe3, 0xdf, 0x57, 0x0a, 0xef, 0x87, 0xa8, 0xcc,
+};
+
+static const u8 p384_sig[] = {
+	0x5b, 0xce, 0xdb, 0xb0, 0x49, 0xdf, 0xb4, 0x7a,
+	0x08, 0xa4, 0x70, 0x33, 0x4a, 0x15, 0x7e, 0x91,
+	0xf6, 0xfc, 0xd5, 0x5f, 0x65, 0x39, 0xa3, 0x16,
+	0xd6, 0x8e, 0x10, 0x69, 0x7a, 0xf3, 0x61, 0x35,
+	0xf1, 0xc0, 0x65, 0xab, 0x05, 0x0a, 0xa3, 0x7e,
+	0xfc, 0xec, 0xcf, 0x30, 0xb5, 0x81, 0xb4, 0xef,
+	0x3a, 0xc4, 0x9d, 0x49, 0x1b, 0xde, 0xc2, 0x78,
+	0xe3, 0xfe, 0xae, 0x39, 0x3f, 0x35, 0xbe, 0xfa,
+	0x32, 0x0e, 0x54, 0x2d, 0xde, 0x5b, 0x01, 0xbc,
+	0x83, 0xc0, 0x14, 0xfd, 0x23, 0x3f, 0x19, 0x06,
+	0x55, 0xc8, 0xe1, 0xe2, 0xef, 0xc3, 0x62, 0x12,
+	0x7a, 0x24, 0x3b, 0x05, 0x0c, 0xe0, 0xb5, 0xda,
+};
+
+static int ecdsa_sw_check(struct unit_test_state *uts, struct udevice *dev,
+			  const char *curve, uint bits, const u8 *x,
+			  const u8 *y, const u8 *hash, const u8 *sig)
+{
+	const struct ecdsa_ops *ops = device_get_ops(dev);
+	struct ecdsa_public_key key = {
+		.curve_name = curve,
+		.x = x,
+		.y = y,
+		.size_bits = bits,
+	};
+	uint len = bits / 8;
+	u8 buf[2 * ECDSA384_BYTES];
+
+	ut_assertok(ops->verify(dev, &key, hash, len, sig, 2 * len));
+
+	/* Wrong hash */
+	memcpy(buf, hash, len);
+	buf[0] ^= 1;
+	ut_asserteq(-EPERM, ops->verify(dev, &key, buf, len, sig, 2 * len));
+
+	/* Wrong s */
+	memcpy(buf, sig, 2 * len);
+	buf[2 * len - 1] ^= 1;
+	ut_asserteq(-EPERM, ops->verify(dev, &key, hash, len, buf, 2 * len));
+
+	/* r out of range */
+	memset(buf, '\xff', len);
+	ut_asserteq(-EPERM, ops->verify(dev, &key, hash, len, buf, 2 * len));
+
+	/* Public key not on the curve */
+	memcpy(buf, y, len);
+	buf[len - 1] ^= 1;
+	key.y = buf;
+	ut_asserteq(-EINVAL, ops->verify(dev, &key, hash, len, sig, 2 * len));
+
+	return 0;
+}
+
+/* Test the software ECDSA driver against known-good signatures */
+static int dm_test_ecdsa_sw(struct unit_test_state *uts)
+{
+	struct ecdsa_public_key key = {
+		.curve_name = "brainpool256",
+		.x = p256_x,
+		.y = p256_y,
+		.size_bits = 256,
+	};
+	const struct ecdsa_ops *ops;
+	struct udevice *dev;
+
+	ut_assertok(uclass_get_device_by_driver(UCLASS_ECDSA,
+						DM_DRIVER_GET(ecdsa_sw), &dev));
+	ut_assertok(ecdsa_sw_check(uts, dev, "prime256v1", 256, p256_x,
+				   p256_y, p256_hash, p256_sig));
+	ut_assertok(ecdsa_sw_check(uts, dev, "secp384r1", 384, p384_x,
+				   p384_y, p384_hash, p384_sig));
+
+	ops = device_get_ops(dev);
+	ut_asserteq(-ENOPROTOOPT, ops->verify(dev, &key, p256_hash, 32,
+					       p256_sig, 64));
+
+	return 0;
+}
+DM_TEST(dm_test_ecdsa_sw, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+#endif
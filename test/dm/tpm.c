@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the TPM2 library with the sandbox TPM
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <tpm-common.h>
+#include <tpm-v2.h>
+#include <dm/test.h>
+#include <test/ut.h>
+#include <u-boot/sha256.h>
+
+/* Get the sandbox TPM2 ready for PCR commands */
+static int tpm2_setup(struct unit_test_state *uts, struct udevice **devp)
+{
+	struct udevice *dev;
+
+	ut_assertok(uclass_get_device_by_driver(UCLASS_TPM,
+						DM_DRIVER_GET(sandbox_tpm2),
+						&dev));
+	ut_assertok(tpm_init(dev));
+	ut_assertok(tpm2_startup(dev, TPM2_SU_CLEAR));
+	ut_assertok(tpm2_self_test(dev, TPMI_YES));
+	*devp = dev;
+
+	return 0;
+}
+
+/* Test extending a PCR with several digests in one command */
+static int dm_test_tpm2_pcr_extend_digests(struct unit_test_state *uts)
+{
+	u8 expect[TPM2_DIGEST_LEN], pcr[TPM2_DIGEST_LEN];
+	struct tpml_digest_values list;
+	struct tpm_chip_priv *priv;
+	struct udevice *dev;
+	sha256_context ctx;
+	unsigned int updates;
+	int i;
+
+	ut_assertok(tpm2_setup(uts, &dev));
+	priv = dev_get_uclass_priv(dev);
+	ut_asserteq(TPM2_SHA256_DIGEST_SIZE,
+		    tpm2_algorithm_to_len(TPM2_ALG_SHA256));
+	ut_asserteq(0, tpm2_algorithm_to_len(0));
+
+	memset(&list, '\0', sizeof(list));
+	list.count = 2;
+	for (i = 0; i < list.count; i++) {
+		list.digests[i].hash_alg = TPM2_ALG_SHA256;
+		memset(list.digests[i].digest.sha256, 0x11 * (i + 1),
+		       TPM2_SHA256_DIGEST_SIZE);
+	}
+	ut_assertok(tpm2_pcr_extend_digests(dev, 0, &list));
+
+	/* The PCR starts at zero and is extended with each digest in turn */
+	memset(expect, '\0', sizeof(expect));
+	for (i = 0; i < list.count; i++) {
+		sha256_starts(&ctx);
+		sha256_update(&ctx, expect, sizeof(expect));
+		sha256_update(&ctx, list.digests[i].digest.sha256,
+			      TPM2_SHA256_DIGEST_SIZE);
+		sha256_finish(&ctx, expect);
+	}
+	ut_assertok(tpm2_pcr_read(dev, 0, priv->pcr_select_min,
+				  TPM2_ALG_SHA256, pcr, sizeof(pcr), &updates));
+	ut_asserteq_mem(expect, pcr, sizeof(pcr));
+
+	/* The sandbox TPM only has a SHA256 bank and a single PCR */
+	list.digests[1].hash_alg = TPM2_ALG_SHA1;
+	ut_asserteq(TPM2_RC_VALUE, tpm2_pcr_extend_digests(dev, 0, &list));
+	list.digests[1].hash_alg = TPM2_ALG_SHA256;
+	ut_asserteq(TPM2_RC_VALUE, tpm2_pcr_extend_digests(dev, 1, &list));
+
+	return 0;
+}
+DM_TEST(dm_test_tpm2_pcr_extend_digests,
+	UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
@@ -191,6 +191,62 @@ static int dm_test_video_chars(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_video_chars, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
 
+/* Write enough lines to the console to scroll the display a few times */
+static void video_pan_lines(struct udevice *con)
+{
+	int i;
+
+	for (i = 0; i < 50; i++)
+		vidconsole_put_string(con, "Scrolling along\n");
+}
+
+/* Test scrolling by moving the display within the frame buffer */
+static int dm_test_video_pan(struct unit_test_state *uts)
+{
+	struct sandbox_sdl_plat *plat;
+	struct video_priv *priv;
+	struct udevice *dev, *con;
+	void *base, *shown;
+
+	ut_assertok(select_vidconsole(uts, "vidconsole0"));
+	ut_assertok(uclass_find_device(UCLASS_VIDEO, 0, &dev));
+	plat = dev_get_plat(dev);
+	plat->pan = true;
+	ut_assertok(video_get_nologo(uts, &dev));
+	priv = dev_get_uclass_priv(dev);
+	base = priv->fb;
+
+	/* The 16-pixel font fits the display exactly, so each line pans */
+	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	video_pan_lines(con);
+	ut_assert(priv->pan_offset > 0);
+	ut_asserteq_ptr(base + priv->pan_offset, priv->fb);
+	if (IS_ENABLED(CONFIG_VIDEO_COPY))
+		ut_asserteq_mem(priv->fb, priv->copy_fb, priv->fb_size);
+
+	shown = malloc(priv->fb_size);
+	ut_assertnonnull(shown);
+	memcpy(shown, priv->fb, priv->fb_size);
+
+	/* Moving the display back must not change what is shown */
+	ut_assertok(video_fix_offset(dev));
+	ut_asserteq(0, priv->pan_offset);
+	ut_asserteq_ptr(base, priv->fb);
+	ut_asserteq_mem(shown, priv->fb, priv->fb_size);
+
+	/* From now on scrolling copies, which must give the same result */
+	ut_assertok(video_clear(dev));
+	vidconsole_position_cursor(con, 0, 0);
+	video_pan_lines(con);
+	ut_asserteq(0, priv->pan_offset);
+	ut_asserteq_ptr(base, priv->fb);
+	ut_asserteq_mem(shown, priv->fb, priv->fb_size);
+	free(shown);
+
+	return 0;
+}
+DM_TEST(dm_test_video_pan, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
 #ifdef CONFIG_VIDEO_ANSI
 #define ANSI_ESC "\x1b"
 /* Test handling of ANSI escape sequences */
@@ -468,6 +524,54 @@ static int dm_test_video_bmp_comp(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_video_bmp_comp, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
 
+/* Test drawing a raw frame-buffer image */
+static int dm_test_video_raw(struct unit_test_state *uts)
+{
+	struct video_raw_header *hdr;
+	struct video_priv *priv;
+	struct udevice *dev;
+	int width = 160, height = 96;
+	int i, stride;
+	ulong addr;
+	u8 *data;
+
+	ut_assertok(video_get_nologo(uts, &dev));
+	priv = dev_get_uclass_priv(dev);
+	ut_assertok(read_file(uts, "tools/logos/denx.bmp", &addr));
+	ut_assertok(video_bmp_display(dev, addr, 0, 0, false));
+
+	/* Take a copy of the image from the display */
+	stride = width * VNBYTES(priv->bpix);
+	hdr = malloc(sizeof(*hdr) + stride * height);
+	ut_assertnonnull(hdr);
+	hdr->magic = cpu_to_le32(VIDEO_RAW_MAGIC);
+	hdr->width = cpu_to_le16(width);
+	hdr->height = cpu_to_le16(height);
+	hdr->bpix = priv->bpix;
+	hdr->format = priv->format;
+	hdr->comp = VIDEO_RAW_COMP_NONE;
+	hdr->reserved = 0;
+	hdr->size = cpu_to_le32(stride * height);
+	data = (u8 *)(hdr + 1);
+	for (i = 0; i < height; i++)
+		memcpy(data + i * stride, priv->fb + i * priv->line_length,
+		       stride);
+
+	/* Drawing it back must give the same result as the bitmap */
+	ut_assertok(video_clear(dev));
+	ut_assertok(video_bmp_display(dev, map_to_sysmem(hdr), 0, 0, false));
+	ut_asserteq(1368, compress_frame_buffer(uts, dev));
+
+	/* The format must match the display */
+	hdr->bpix = VIDEO_BPP32;
+	ut_asserteq(-EPERM, video_raw_display(dev, map_to_sysmem(hdr), 0, 0,
+					      false));
+	free(hdr);
+
+	return 0;
+}
+DM_TEST(dm_test_video_raw, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
 /* Test drawing a bitmap file on a 32bpp display */
 static int dm_test_video_comp_bmp32(struct unit_test_state *uts)
 {
@@ -562,3 +666,78 @@ static int dm_test_video_truetype_bs(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_video_truetype_bs, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* Test that only the lines changed since the last sync are recorded */
+static int dm_test_video_damage(struct unit_test_state *uts)
+{
+	struct vidconsole_priv *vc_priv;
+	struct video_priv *priv;
+	struct udevice *dev, *con;
+	int row_size;
+
+	ut_assertok(video_get_nologo(uts, &dev));
+	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	priv = dev_get_uclass_priv(dev);
+	vc_priv = dev_get_uclass_priv(con);
+	row_size = vc_priv->y_charsize * priv->line_length;
+
+	ut_assertok(video_sync(dev, true));
+	ut_asserteq(0, priv->damage_start);
+	ut_asserteq(0, priv->damage_end);
+
+	/* A character only touches whole lines within its own text row */
+	vidconsole_position_cursor(con, 3, 2);
+	ut_assertok(vidconsole_put_char(con, 'x'));
+	ut_assert(priv->damage_start >= 2 * row_size);
+	ut_assert(priv->damage_end <= 3 * row_size);
+	ut_assert(priv->damage_end > priv->damage_start);
+	ut_asserteq(0, priv->damage_start % priv->line_length);
+	ut_asserteq(0, priv->damage_end % priv->line_length);
+
+	/* A second character further down widens the range */
+	vidconsole_position_cursor(con, 3, 5);
+	ut_assertok(vidconsole_put_char(con, 'x'));
+	ut_assert(priv->damage_start >= 2 * row_size);
+	ut_assert(priv->damage_start < 3 * row_size);
+	ut_assert(priv->damage_end > 5 * row_size);
+	ut_assert(priv->damage_end <= 6 * row_size);
+
+	/* Syncing clears it */
+	ut_assertok(video_sync(dev, false));
+	ut_asserteq(0, priv->damage_start);
+	ut_asserteq(0, priv->damage_end);
+
+	return 0;
+}
+DM_TEST(dm_test_video_damage, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* Test that writing the same TrueType text again gives the same output */
+static int dm_test_video_truetype_repeat(struct unit_test_state *uts)
+{
+	const char *test_string = "Criticism may not be agreeable, but it is necessary.";
+	struct video_priv *priv;
+	struct udevice *dev, *con;
+	void *first;
+
+	ut_assertok(video_get_nologo(uts, &dev));
+	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	priv = dev_get_uclass_priv(dev);
+
+	/*
+	 * With CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE the second pass uses the
+	 * cached characters, which must match those rendered the first time
+	 */
+	vidconsole_put_string(con, test_string);
+	first = malloc(priv->fb_size);
+	ut_assertnonnull(first);
+	memcpy(first, priv->fb, priv->fb_size);
+
+	ut_assertok(video_clear(dev));
+	vidconsole_position_cursor(con, 0, 0);
+	vidconsole_put_string(con, test_string);
+	ut_asserteq_mem(first, priv->fb, priv->fb_size);
+	free(first);
+
+	return 0;
+}
+DM_TEST(dm_test_video_truetype_repeat, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the libavb SHA-256/SHA-512 functions on the U-Boot hash layer
+ */
+
+#include <common.h>
+#include <hash.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+#include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
+
+#include "avb_sha.h"
+
+static const u8 sha256_abc[SHA256_SUM_LEN] = {
+	0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+	0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+	0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+	0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+};
+
+static const u8 sha512_abc[SHA512_SUM_LEN] = {
+	0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba,
+	0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31,
+	0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2,
+	0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a,
+	0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8,
+	0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+	0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e,
+	0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f,
+};
+
+/* Uneven pieces, so that updates do not line up with the block size */
+static const uint pieces[] = { 1, 63, 64, 65, 127, 300, 380 };
+
+static void fill(u8 *buf, uint size)
+{
+	uint i;
+
+	for (i = 0; i < size; i++)
+		buf[i] = i * 7 + (i >> 8);
+}
+
+static int lib_test_avb_sha256(struct unit_test_state *uts)
+{
+	u8 buf[1000], expect[SHA256_SUM_LEN];
+	AvbSHA256Ctx ctx;
+	int size = sizeof(expect);
+	uint i, pos;
+
+	avb_sha256_init(&ctx);
+	avb_sha256_update(&ctx, (const u8 *)"abc", 3);
+	ut_asserteq_mem(sha256_abc, avb_sha256_final(&ctx), SHA256_SUM_LEN);
+
+	fill(buf, sizeof(buf));
+	ut_assertok(hash_block("sha256", buf, sizeof(buf), expect, &size));
+	avb_sha256_init(&ctx);
+	for (i = pos = 0; i < ARRAY_SIZE(pieces); pos += pieces[i++])
+		avb_sha256_update(&ctx, buf + pos, pieces[i]);
+	ut_asserteq(sizeof(buf), pos);
+	ut_asserteq_mem(expect, avb_sha256_final(&ctx), SHA256_SUM_LEN);
+
+	return 0;
+}
+LIB_TEST(lib_test_avb_sha256, 0);
+
+static int lib_test_avb_sha512(struct unit_test_state *uts)
+{
+	u8 buf[1000], expect[SHA512_SUM_LEN];
+	AvbSHA512Ctx ctx;
+	int size = sizeof(expect);
+	uint i, pos;
+
+	avb_sha512_init(&ctx);
+	avb_sha512_update(&ctx, (const u8 *)"abc", 3);
+	ut_asserteq_mem(sha512_abc, avb_sha512_final(&ctx), SHA512_SUM_LEN);
+
+	fill(buf, sizeof(buf));
+	ut_assertok(hash_block("sha512", buf, sizeof(buf), expect, &size));
+	avb_sha512_init(&ctx);
+	for (i = pos = 0; i < ARRAY_SIZE(pieces); pos += pieces[i++])
+		avb_sha512_update(&ctx, buf + pos, pieces[i]);
+	ut_asserteq(sizeof(buf), pos);
+	ut_asserteq_mem(expect, avb_sha512_final(&ctx), SHA512_SUM_LEN);
+
+	return 0;
+}
+LIB_TEST(lib_test_avb_sha512, 0);
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the hardware performance-counter API, using the sandbox stub
+ */
+
+#include <common.h>
+#include <console.h>
+#include <perf_counter.h>
+#include <asm/global_data.h>
+#include <asm/test.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static int lib_test_perf_counter(struct unit_test_state *uts)
+{
+	struct perf_counter_values start, end, delta, total;
+	u64 val[PERF_COUNTER_COUNT] = { 1000, 2000, 0xfffffff0, 1, 5 };
+
+	perf_counter_stop();
+	sandbox_perf_counter_stub(val);
+	ut_assertok(perf_counter_read(&start));
+	ut_assert(gd->perf_info.started);
+	ut_asserteq(BIT(PERF_COUNTER_COUNT) - 1, start.valid);
+	ut_asserteq(2000, start.val[PERF_COUNTER_INSTRUCTIONS]);
+
+	/* The L1D counter wraps, as 32-bit ARMv8 event counters do */
+	val[PERF_COUNTER_CYCLES] = 3000;
+	val[PERF_COUNTER_INSTRUCTIONS] = 6000;
+	val[PERF_COUNTER_L1D_MISSES] = 0x10;
+	val[PERF_COUNTER_L2D_MISSES] = 4;
+	val[PERF_COUNTER_BRANCH_MISSES] = 12;
+	ut_assertok(perf_counter_read(&end));
+	perf_counter_delta(&start, &end, &delta);
+	ut_asserteq(start.valid, delta.valid);
+	ut_asserteq(2000, delta.val[PERF_COUNTER_CYCLES]);
+	ut_asserteq(4000, delta.val[PERF_COUNTER_INSTRUCTIONS]);
+	ut_asserteq(0x20, delta.val[PERF_COUNTER_L1D_MISSES]);
+	ut_asserteq(3, delta.val[PERF_COUNTER_L2D_MISSES]);
+	ut_asserteq(7, delta.val[PERF_COUNTER_BRANCH_MISSES]);
+
+	memset(&total, '\0', sizeof(total));
+	perf_counter_add(&total, &start, &end);
+	perf_counter_add(&total, &start, &end);
+	ut_asserteq(8000, total.val[PERF_COUNTER_INSTRUCTIONS]);
+	ut_asserteq(0x40, total.val[PERF_COUNTER_L1D_MISSES]);
+
+	ut_silence_console(uts);
+	console_record_reset_enable();
+	perf_counter_print(&delta);
+	ut_unsilence_console(uts);
+	ut_assert_nextline("cycles 2000, instructions 4000, l1d-misses 32, l2d-misses 3, branch-misses 7, IPC 2.00, L1D MPKI 8.00, L2D MPKI 0.75");
+	ut_assert_console_end();
+
+	/* Counters which are not available are left out */
+	delta.valid = BIT(PERF_COUNTER_CYCLES);
+	ut_silence_console(uts);
+	console_record_reset_enable();
+	perf_counter_print(&delta);
+	ut_unsilence_console(uts);
+	ut_assert_nextline("cycles 2000");
+	ut_assert_console_end();
+
+	perf_counter_stop();
+	ut_assert(!gd->perf_info.started);
+	sandbox_perf_counter_stub(NULL);
+
+	return 0;
+}
+LIB_TEST(lib_test_perf_counter, 0);
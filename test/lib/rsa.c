@@ -203,4 +203,49 @@ static int lib_rsa_verify_invalid(struct unit_test_state *uts)
 }
 
 LIB_TEST(lib_rsa_verify_invalid, 0);
+
+/**
+ * lib_rsa_verify_cached() - unit test for rsa_verify() with a known key
+ *
+ * Test that the key properties kept from an earlier verification are only
+ * used for the same key
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_rsa_verify_cached(struct unit_test_state *uts)
+{
+	unsigned char other_key[sizeof(public_key)];
+	struct image_sign_info info;
+	struct image_region reg;
+	int i, ret;
+
+	memset(&info, '\0', sizeof(info));
+	info.name = "sha256,rsa2048";
+	info.padding = image_get_padding_algo("pkcs-1.5");
+	info.checksum = image_get_checksum_algo("sha256,rsa2048");
+	info.crypto = image_get_crypto_algo(info.name);
+
+	info.key = public_key;
+	info.keylen = public_key_len;
+
+	reg.data = data_raw;
+	reg.size = data_raw_len;
+	for (i = 0; i < 2; i++) {
+		ret = rsa_verify(&info, &reg, 1, data_enc, data_enc_len);
+		ut_assertf(ret == 0, "verification %d unexpectedly failed (%d)\n",
+			   i, ret);
+	}
+
+	/* a different modulus of the same size must not match */
+	memcpy(other_key, public_key, sizeof(public_key));
+	other_key[100] ^= 0x10;
+	info.key = other_key;
+	ret = rsa_verify(&info, &reg, 1, data_enc, data_enc_len);
+	ut_assertf(ret != 0, "verification unexpectedly succeeded\n");
+
+	return CMD_RET_SUCCESS;
+}
+
+LIB_TEST(lib_rsa_verify_cached, 0);
 #endif /* RSA_VERIFY_WITH_PKEY */
@@ -16,6 +16,7 @@
 
 #define TEST_AES_ONE_BLOCK		0
 #define TEST_AES_CBC_CHAIN		1
+#define TEST_AES_CTR			2
 
 struct test_aes_s {
 	int key_len;
@@ -31,6 +32,9 @@ static struct test_aes_s test_aes[] = {
 	{ AES192_KEY_LENGTH, AES192_EXPAND_KEY_LENGTH, TEST_AES_CBC_CHAIN, 16 },
 	{ AES256_KEY_LENGTH, AES256_EXPAND_KEY_LENGTH, TEST_AES_ONE_BLOCK,  1 },
 	{ AES256_KEY_LENGTH, AES256_EXPAND_KEY_LENGTH, TEST_AES_CBC_CHAIN, 16 },
+	{ AES128_KEY_LENGTH, AES128_EXPAND_KEY_LENGTH, TEST_AES_CTR,       17 },
+	{ AES192_KEY_LENGTH, AES192_EXPAND_KEY_LENGTH, TEST_AES_CTR,       17 },
+	{ AES256_KEY_LENGTH, AES256_EXPAND_KEY_LENGTH, TEST_AES_CTR,       17 },
 };
 
 static void rand_buf(u8 *buf, int size)
@@ -80,6 +84,35 @@ static int lib_test_aes_cbc_chain(struct unit_test_state *uts, int key_len,
 	return 0;
 }
 
+static int lib_test_aes_ctr(struct unit_test_state *uts, int key_len,
+			    u8 *key_exp, u8 *iv, int num_block,
+			    u8 *nocipher, u8 *ciphered, u8 *uncipher)
+{
+	/* the last block is partial, CTR does not need padding */
+	int len = num_block * AES_BLOCK_LENGTH - 5;
+	int first = 5 * AES_BLOCK_LENGTH;
+	u8 ctr[AES_BLOCK_LENGTH];
+
+	/* encrypt in two steps, which must match doing it in one go */
+	memcpy(ctr, iv, AES_BLOCK_LENGTH);
+	aes_ctr_crypt(key_len, key_exp, ctr, nocipher, ciphered, first);
+	aes_ctr_crypt(key_len, key_exp, ctr, nocipher + first,
+		      ciphered + first, len - first);
+	memcpy(ctr, iv, AES_BLOCK_LENGTH);
+	aes_ctr_crypt(key_len, key_exp, ctr, ciphered, uncipher, len);
+
+	ut_asserteq_mem(nocipher, uncipher, len);
+
+	/* corrupt the expanded key */
+	key_exp[0]++;
+	memcpy(ctr, iv, AES_BLOCK_LENGTH);
+	aes_ctr_crypt(key_len, key_exp, ctr, ciphered, uncipher, len);
+	ut_assertf(memcmp(nocipher, uncipher, len),
+		   "nocipher and uncipher should be different\n");
+
+	return 0;
+}
+
 static int _lib_test_aes_run(struct unit_test_state *uts, int key_len,
 			     int key_exp_len, int type, int num_block)
 {
@@ -123,6 +156,11 @@ static int _lib_test_aes_run(struct unit_test_state *uts, int key_len,
 					     num_block, nocipher,
 					     ciphered, uncipher);
 		break;
+	case TEST_AES_CTR:
+		ret = lib_test_aes_ctr(uts, key_len, key_exp, iv,
+				       num_block, nocipher,
+				       ciphered, uncipher);
+		break;
 	default:
 		printf("%s: unknown type (type=%d)\n", __func__, type);
 		ret = -1;
@@ -166,3 +204,44 @@ static int lib_test_aes(struct unit_test_state *uts)
 }
 
 LIB_TEST(lib_test_aes, 0);
+
+/* NIST SP 800-38A, F.5.1 CTR-AES128.Encrypt */
+static int lib_test_aes_ctr_vector(struct unit_test_state *uts)
+{
+	u8 key[] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+		0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+	};
+	u8 ctr[] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+		0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+	};
+	u8 plain[] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+		0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+	};
+	u8 expect[] = {
+		0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26,
+		0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+		0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+		0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+	};
+	u8 next_ctr[] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+		0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xff, 0x01,
+	};
+	u8 key_exp[AES128_EXPAND_KEY_LENGTH];
+	u8 out[sizeof(plain)];
+
+	aes_expand_key(key, AES128_KEY_LENGTH, key_exp);
+	aes_ctr_crypt(AES128_KEY_LENGTH, key_exp, ctr, plain, out,
+		      sizeof(plain));
+	ut_asserteq_mem(expect, out, sizeof(expect));
+	ut_asserteq_mem(next_ctr, ctr, sizeof(ctr));
+
+	return 0;
+}
+
+LIB_TEST(lib_test_aes_ctr_vector, 0);
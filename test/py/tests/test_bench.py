@@ -0,0 +1,358 @@
+# SPDX-License-Identifier: GPL-2.0+
+#
+# Benchmark of the boot paths used on real boards, run on sandbox
+
+"""
+Time the load, verify and decompress paths that U-Boot uses to boot
+
+Each case builds a representative image on the host, loads it into a fresh
+sandbox and runs the same commands a board would run, wrapping each one in
+'time'. The bootstage report is captured afterwards so that the individual
+bootm stages can be tracked as well.
+
+Results are merged into bench.json in the result directory, keyed by case
+name. Each stage records the elapsed time in milliseconds, the number of
+bytes it handled and the resulting throughput in MB/s, so runs of different
+U-Boot versions can be compared to spot regressions.
+
+Cases:
+    fit-gzip, fit-lz4, fit-zstd: signed FIT with a compressed kernel
+    ext4, fat, squashfs: a single large file read back with 'load'
+    sparse: an Android sparse image written with 'mmc swrite'
+
+UBIFS is not covered since sandbox does not enable UBI.
+
+These tests are slow, so are only run when slow tests are enabled.
+"""
+
+import json
+import os
+import re
+import pytest
+import u_boot_utils as util
+
+# Size of the payload used for every case
+PAYLOAD_SIZE = 16 << 20
+
+# Size of the raw image for the sparse case, which must fit in a sandbox MMC
+SPARSE_SIZE = 512 << 10
+
+# Address to load images to, and to decompress / read files into
+LOAD_ADDR = 0x1000000
+KERNEL_ADDR = 0x4000000
+
+its_template = '''
+/dts-v1/;
+
+/ {
+	description = "Benchmark FIT";
+	#address-cells = <1>;
+
+	images {
+		kernel-1 {
+			data = /incbin/("%(kernel)s");
+			type = "kernel";
+			arch = "sandbox";
+			os = "linux";
+			compression = "%(compression)s";
+			load = <%(kernel_addr)#x>;
+			entry = <%(kernel_addr)#x>;
+			hash-1 {
+				algo = "sha256";
+			};
+		};
+		fdt-1 {
+			data = /incbin/("sandbox-kernel.dtb");
+			type = "flat_dt";
+			arch = "sandbox";
+			compression = "none";
+			hash-1 {
+				algo = "sha256";
+			};
+		};
+	};
+	configurations {
+		default = "conf-1";
+		conf-1 {
+			kernel = "kernel-1";
+			fdt = "fdt-1";
+			signature {
+				algo = "sha256,rsa2048";
+				key-name-hint = "dev";
+				sign-images = "fdt", "kernel";
+			};
+		};
+	};
+};
+'''
+
+# Host command used to compress the kernel for each FIT compression type
+compress_cmds = {
+    'gzip': 'gzip -9 -n -c %s > %s',
+    'lz4': 'lz4 -9 -q -f %s %s',
+    'zstd': 'zstd -19 -q -f %s -o %s',
+}
+
+def make_payload(fname, size):
+    """Write a payload which compresses roughly like a real kernel
+
+    Half of each block is random and the other half is repeated text, which
+    gives a compression ratio of about 2:1.
+
+    Args:
+        fname: Filename to write
+        size: Size of the payload in bytes
+    """
+    block = 4096
+    filler = (b'U-Boot benchmark payload ' * (block // 50 + 1))[:block // 2]
+    with open(fname, 'wb') as outf:
+        for _ in range(size // block):
+            outf.write(os.urandom(block // 2))
+            outf.write(filler)
+
+def parse_time(output):
+    """Get the time reported by the 'time' command
+
+    Args:
+        output: Output from the command
+
+    Returns:
+        Elapsed time in milliseconds
+    """
+    m = re.search(r'time:(?: (\d+) minutes,)? (\d+)\.(\d+) seconds', output)
+    assert m, "No 'time' output in: %s" % output
+    minutes = int(m.group(1) or 0)
+    return (minutes * 60 + int(m.group(2))) * 1000 + int(m.group(3))
+
+def parse_bootstage(output):
+    """Get the elapsed time of each named record in a bootstage report
+
+    Args:
+        output: Output from 'bootstage report'
+
+    Returns:
+        dict of elapsed time in milliseconds, keyed by record name
+    """
+    stages = {}
+    for line in output.splitlines():
+        m = re.match(r'\s*[\d,]+\s+([\d,]+)\s+(\S+)$', line)
+        if m and not m.group(2).startswith('id='):
+            stages[m.group(2)] = int(m.group(1).replace(',', '')) / 1000
+    return stages
+
+def add_stage(result, name, output, size):
+    """Record a timed stage in the results
+
+    Args:
+        result: dict of stages to update
+        name: Name of the stage
+        output: Output from the 'time' command
+        size: Number of bytes processed by the stage, or 0 if not known
+    """
+    msecs = parse_time(output)
+    stage = {'ms': msecs, 'bytes': size}
+    if size and msecs:
+        stage['mbps'] = round(size / (1 << 20) / (msecs / 1000), 2)
+    result[name] = stage
+
+def write_results(cons, case, result):
+    """Merge the results for a case into bench.json
+
+    Args:
+        cons: U-Boot console
+        case: Name of the case
+        result: dict of results for this case
+    """
+    fname = os.path.join(cons.config.result_dir, 'bench.json')
+    data = {}
+    if os.path.exists(fname):
+        with open(fname) as inf:
+            data = json.load(inf)
+    data[case] = result
+    with open(fname, 'w') as outf:
+        json.dump(data, outf, indent=2, sort_keys=True)
+    cons.log.info('%s: %s' % (case, json.dumps(result, sort_keys=True)))
+
+def run_timed(cons, cmd):
+    """Run a command under 'time', checking that it succeeds
+
+    Args:
+        cons: U-Boot console
+        cmd: Command to run
+
+    Returns:
+        Output of the command, including the time taken
+    """
+    output = cons.run_command('time %s; echo rc=$?' % cmd)
+    assert 'rc=0' in output, "Command '%s' failed: %s" % (cmd, output)
+    return output
+
+@pytest.mark.slow
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('fit_signature')
+@pytest.mark.buildconfigspec('cmd_time')
+@pytest.mark.buildconfigspec('cmd_bootstage')
+@pytest.mark.requiredtool('dtc')
+@pytest.mark.requiredtool('openssl')
+@pytest.mark.parametrize('compression', [
+    pytest.param('gzip', marks=pytest.mark.requiredtool('gzip')),
+    pytest.param('lz4', marks=[pytest.mark.buildconfigspec('lz4'),
+                               pytest.mark.requiredtool('lz4')]),
+    pytest.param('zstd', marks=[pytest.mark.buildconfigspec('zstd'),
+                                pytest.mark.requiredtool('zstd')]),
+])
+def test_bench_fit(u_boot_console, compression):
+    """Time loading, verifying and decompressing a signed FIT
+
+    The public key is written to a copy of the U-Boot devicetree, so that
+    'bootm' checks the configuration signature just as a secure board would.
+    """
+    cons = u_boot_console
+    tmpdir = os.path.join(cons.config.result_dir, 'bench-fit') + '/'
+    if not os.path.exists(tmpdir):
+        os.mkdir(tmpdir)
+    datadir = cons.config.source_dir + '/test/py/tests/vboot/'
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    dtb = tmpdir + 'sandbox-u-boot.dtb'
+    kernel = tmpdir + 'kernel.bin'
+    fit = tmpdir + 'bench-%s.fit' % compression
+    its = tmpdir + 'bench-%s.its' % compression
+
+    for dts in ['sandbox-kernel.dts', 'sandbox-u-boot.dts']:
+        util.run_and_log(cons, 'dtc %s%s -O dtb -o %s%s' %
+                         (datadir, dts, tmpdir, dts.replace('.dts', '.dtb')))
+    if not os.path.exists(tmpdir + 'dev.key'):
+        util.run_and_log(cons, 'openssl genpkey -algorithm RSA -out %sdev.key '
+                         '-pkeyopt rsa_keygen_bits:2048' % tmpdir)
+        util.run_and_log(cons, 'openssl req -batch -new -x509 -key %sdev.key '
+                         '-out %sdev.crt' % (tmpdir, tmpdir))
+    make_payload(kernel, PAYLOAD_SIZE)
+    util.run_and_log(cons, ['sh', '-c', compress_cmds[compression] %
+                            (kernel, kernel + '.' + compression)])
+    with open(its, 'w') as outf:
+        outf.write(its_template % {'kernel': kernel + '.' + compression,
+                                   'compression': compression,
+                                   'kernel_addr': KERNEL_ADDR})
+    util.run_and_log(cons, [mkimage, '-D', '-I dts -O dtb -i %s' % tmpdir,
+                            '-f', its, fit])
+    util.run_and_log(cons, [mkimage, '-F', '-k', tmpdir, '-K', dtb, '-r', fit])
+    fit_size = os.path.getsize(fit)
+
+    result = {}
+    old_dtb = cons.config.dtb
+    try:
+        cons.config.dtb = dtb
+        cons.restart_uboot()
+        with cons.log.section('Benchmark FIT %s' % compression):
+            output = run_timed(cons, 'host load hostfs - %x %s' %
+                               (LOAD_ADDR, fit))
+            add_stage(result, 'load', output, fit_size)
+            output = run_timed(cons, 'iminfo %x' % LOAD_ADDR)
+            add_stage(result, 'verify', output, fit_size)
+            output = run_timed(cons, 'bootm start %x' % LOAD_ADDR)
+            assert 'dev+' in output
+            add_stage(result, 'bootm_start', output, fit_size)
+            output = run_timed(cons, 'bootm loados')
+            add_stage(result, 'decompress', output, PAYLOAD_SIZE)
+            output = cons.run_command('bootstage report')
+            result['bootstage'] = parse_bootstage(output)
+    finally:
+        cons.config.dtb = old_dtb
+        cons.restart_uboot()
+
+    write_results(cons, 'fit-%s' % compression, result)
+
+def make_fs_image(cons, fs_type, srcdir, fs_img):
+    """Create a filesystem image holding the contents of a directory
+
+    Args:
+        cons: U-Boot console
+        fs_type: Filesystem type ('ext4', 'fat' or 'squashfs')
+        srcdir: Directory containing the files to add
+        fs_img: Filename of the image to create
+    """
+    size_mb = PAYLOAD_SIZE // (1 << 20) * 2
+    if os.path.exists(fs_img):
+        os.remove(fs_img)
+    if fs_type == 'ext4':
+        util.run_and_log(cons, 'mkfs.ext4 -q -F -d %s %s %dM' %
+                         (srcdir, fs_img, size_mb))
+    elif fs_type == 'fat':
+        util.run_and_log(cons, 'mkfs.vfat -F 32 -C %s %d' %
+                         (fs_img, size_mb * 1024))
+        util.run_and_log(cons, 'mcopy -i %s %s/payload.bin ::' %
+                         (fs_img, srcdir))
+    elif fs_type == 'squashfs':
+        util.run_and_log(cons, 'mksquashfs %s %s -noappend -quiet' %
+                         (srcdir, fs_img))
+
+@pytest.mark.slow
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_time')
+@pytest.mark.buildconfigspec('cmd_fs_generic')
+@pytest.mark.parametrize('fs_type', [
+    pytest.param('ext4', marks=[pytest.mark.buildconfigspec('fs_ext4'),
+                                pytest.mark.requiredtool('mkfs.ext4')]),
+    pytest.param('fat', marks=[pytest.mark.buildconfigspec('fs_fat'),
+                               pytest.mark.requiredtool('mkfs.vfat'),
+                               pytest.mark.requiredtool('mcopy')]),
+    pytest.param('squashfs', marks=[pytest.mark.buildconfigspec('fs_squashfs'),
+                                    pytest.mark.requiredtool('mksquashfs')]),
+])
+def test_bench_fs(u_boot_console, fs_type):
+    """Time reading a large file from a filesystem image"""
+    cons = u_boot_console
+    tmpdir = os.path.join(cons.config.result_dir, 'bench-fs')
+    srcdir = os.path.join(tmpdir, 'src')
+    if not os.path.exists(srcdir):
+        os.makedirs(srcdir)
+    fs_img = os.path.join(tmpdir, '%s.img' % fs_type)
+    make_payload(os.path.join(srcdir, 'payload.bin'), PAYLOAD_SIZE)
+    make_fs_image(cons, fs_type, srcdir, fs_img)
+
+    result = {}
+    with cons.log.section('Benchmark %s' % fs_type):
+        output = cons.run_command('host bind 0 %s' % fs_img)
+        assert not output
+        output = run_timed(cons, 'load host 0:0 %x /payload.bin' % LOAD_ADDR)
+        add_stage(result, 'load', output, PAYLOAD_SIZE)
+
+    write_results(cons, fs_type, result)
+
+@pytest.mark.slow
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_time')
+@pytest.mark.buildconfigspec('cmd_mmc_swrite')
+@pytest.mark.requiredtool('img2simg')
+def test_bench_sparse(u_boot_console):
+    """Time writing an Android sparse image to MMC
+
+    Half of the raw image is left as zeroes, so that the sparse image holds a
+    mix of raw and don't-care chunks as a typical system image does. The
+    sandbox MMC devices have no backing file and hold 1MiB, so the image must
+    fit within that.
+    """
+    cons = u_boot_console
+    tmpdir = os.path.join(cons.config.result_dir, 'bench-sparse')
+    if not os.path.exists(tmpdir):
+        os.mkdir(tmpdir)
+    raw = os.path.join(tmpdir, 'raw.img')
+    sparse = os.path.join(tmpdir, 'sparse.img')
+    size = SPARSE_SIZE
+    make_payload(raw, size // 2)
+    with open(raw, 'ab') as outf:
+        outf.truncate(size)
+    util.run_and_log(cons, 'img2simg %s %s' % (raw, sparse))
+
+    result = {}
+    with cons.log.section('Benchmark sparse'):
+        output = run_timed(cons, 'host load hostfs - %x %s' %
+                           (LOAD_ADDR, sparse))
+        add_stage(result, 'load', output, os.path.getsize(sparse))
+        cons.run_command('mmc dev 0')
+        output = run_timed(cons, 'mmc swrite %x 0' % LOAD_ADDR)
+        assert 'exceed' not in output
+        assert 'wrote' in output
+        add_stage(result, 'write', output, size)
+
+    write_results(cons, 'sparse', result)
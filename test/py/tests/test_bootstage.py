@@ -0,0 +1,33 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+"""Test the bootstage report and its nested stages"""
+
+import re
+import pytest
+
+@pytest.mark.buildconfigspec('cmd_bootstage')
+def test_bootstage_report(u_boot_console):
+    """The report has marks and accumulated stages"""
+    output = u_boot_console.run_command('bootstage report')
+    assert 'Timer summary in microseconds' in output
+    assert 'board_init_r' in output
+    assert 'Accumulated time:' in output
+    assert re.search(r'^\s+[\d,]+  dm_r$', output, re.M)
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_bootstage')
+@pytest.mark.buildconfigspec('bootstage_dm_probe')
+def test_bootstage_dm_probe(u_boot_console):
+    """Driver probes are recorded, nested within other stages if needed"""
+    u_boot_console.run_command('mmc rescan')
+    output = u_boot_console.run_command('bootstage report')
+    accum = output.split('Accumulated time:')[1]
+
+    # Each line is the time, then the name indented by two per level
+    stages = {}
+    for line in accum.splitlines():
+        m = re.match(r'\s+[\d,]+  ( *)(\S+)$', line)
+        if m:
+            stages[m.group(2)] = len(m.group(1)) // 2
+    assert 'mmc_sandbox' in stages
+    assert stages['dm_r'] == 0
@@ -0,0 +1,117 @@
+# SPDX-License-Identifier: GPL-2.0+
+#
+# Test ciphered FIT images
+
+"""
+This ciphers a kernel with mkimage, which also puts the key in U-Boot's
+devicetree. It then boots the FIT on sandbox and checks that the kernel is
+deciphered to its load address.
+"""
+
+import os
+import zlib
+import pytest
+import u_boot_utils as util
+
+# Kernel size, which is not a whole number of AES blocks
+KERNEL_SIZE = 1003
+
+# Kernel load address, away from the FIT which is loaded at 0x100
+LOAD_ADDR = 0x200000
+
+ITS = '''
+/dts-v1/;
+
+/ {
+	description = "Ciphered kernel";
+	#address-cells = <1>;
+
+	images {
+		kernel {
+			data = /incbin/("test-kernel.bin");
+			type = "kernel";
+			arch = "sandbox";
+			os = "linux";
+			compression = "none";
+			load = <%#x>;
+			entry = <%#x>;
+			cipher {
+				algo = "%s";
+				key-name-hint = "aeskey";
+				%s
+			};
+		};
+	};
+	configurations {
+		default = "conf-1";
+		conf-1 {
+			kernel = "kernel";
+		};
+	};
+};
+'''
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('fit_cipher')
+@pytest.mark.requiredtool('dtc')
+@pytest.mark.parametrize('algo,key_len', [
+    ('aes128-ctr', 16),
+    ('aes192-ctr', 24),
+    ('aes256-ctr', 32),
+])
+def test_fit_cipher_ctr(u_boot_console, algo, key_len):
+    """Round-trip a kernel through an AES-CTR ciphered FIT"""
+    def make_its(name, extra=''):
+        its = os.path.join(tmpdir, name)
+        with open(its, 'w') as fd:
+            fd.write(ITS % (LOAD_ADDR, LOAD_ADDR, algo, extra))
+        return its
+
+    cons = u_boot_console
+    tmpdir = os.path.join(cons.config.result_dir, 'cipher-' + algo) + '/'
+    if not os.path.exists(tmpdir):
+        os.mkdir(tmpdir)
+    datadir = cons.config.source_dir + '/test/py/tests/vboot/'
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    dtc_args = '-I dts -O dtb -i %s' % tmpdir
+    dtb = tmpdir + 'sandbox-u-boot.dtb'
+    fit = tmpdir + 'test.fit'
+
+    kernel = bytes((i * 7 + 3) & 0xff for i in range(KERNEL_SIZE))
+    with open(tmpdir + 'test-kernel.bin', 'wb') as fd:
+        fd.write(kernel)
+    with open(tmpdir + 'aeskey.bin', 'wb') as fd:
+        fd.write(os.urandom(key_len))
+    with open(tmpdir + 'aesiv.bin', 'wb') as fd:
+        fd.write(os.urandom(16))
+    util.run_and_log(cons, 'dtc %s %ssandbox-u-boot.dts -o %s' %
+                     (dtc_args, datadir, dtb))
+
+    # A fixed IV would be reused for every image ciphered with the key
+    its = make_its('iv-hint.its', 'iv-name-hint = "aesiv";')
+    util.run_and_log_expect_exception(
+        cons, [mkimage, '-D', dtc_args, '-f', its, '-k', tmpdir, '-K', dtb,
+               fit], 1, "Can't use iv-name-hint with cipher '%s'" % algo)
+
+    its = make_its('test.its')
+    util.run_and_log(cons, [mkimage, '-D', dtc_args, '-f', its, '-k', tmpdir,
+                            '-K', dtb, fit])
+    with open(fit, 'rb') as fd:
+        assert kernel not in fd.read()
+
+    try:
+        old_dtb = cons.config.dtb
+        cons.config.dtb = dtb
+        cons.restart_uboot()
+        output = cons.run_command_list(
+            ['host load hostfs - 100 %s' % fit,
+             'mw.b %x 0 %x' % (LOAD_ADDR, KERNEL_SIZE),
+             'bootm 100'])
+        assert 'sandbox: continuing, as we cannot run' in ''.join(output)
+
+        output = cons.run_command('crc32 %x %x' % (LOAD_ADDR, KERNEL_SIZE))
+        assert output.endswith('%08x' % zlib.crc32(kernel))
+    finally:
+        # Go back to the original U-Boot with the correct dtb.
+        cons.config.dtb = old_dtb
+        cons.restart_uboot()
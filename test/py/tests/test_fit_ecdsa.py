@@ -7,12 +7,14 @@ Test ECDSA signing of FIT images
 
 This test uses mkimage to sign an existing FIT image with an ECDSA key. The
 signature is then extracted, and verified against pyCryptodome.
-This test doesn't run the sandbox. It only checks the host tool 'mkimage'
+test_fit_ecdsa_sandbox then writes the public key into the control dtb and
+checks that the sandbox accepts the signed FIT, and rejects it once the
+signature is corrupted.
 """
 
 import pytest
 import u_boot_utils as util
-from Cryptodome.Hash import SHA256
+from Cryptodome.Hash import SHA256, SHA384
 from Cryptodome.PublicKey import ECC
 from Cryptodome.Signature import DSS
 
@@ -47,31 +49,50 @@ class SignableFitImage(object):
 
         return self.signable_nodes
 
-    def change_signature_algo_to_ecdsa(self):
+    def change_signature_algo_to_ecdsa(self, algo='sha256,ecdsa256'):
         for image in self.signable_nodes:
-            self.__fdt_set(f'{image}/signature', algo='sha256,ecdsa256')
+            self.__fdt_set(f'{image}/signature', algo=algo)
 
-    def sign(self, mkimage, key_file):
-        util.run_and_log(self.cons, [mkimage, '-F', self.fit, f'-G{key_file}'])
+    def sign(self, mkimage, key_file, dtb=None):
+        args = [mkimage, '-F', self.fit, f'-G{key_file}']
+        if dtb:
+            # Write the public key into the dtb, as a required key
+            args += ['-K', dtb, '-r']
+        util.run_and_log(self.cons, args)
 
-    def check_signatures(self, key):
+    def corrupt_signatures(self):
+        for image in self.signable_nodes:
+            raw_sig = self.__fdt_get_binary(f'{image}/signature', 'value')
+            raw_sig[-1] ^= 1
+            values = ' '.join(str(b) for b in raw_sig)
+            util.run_and_log(self.cons, f'fdtput -tbi {self.fit} '
+                             f'{image}/signature value {values}')
+
+    def check_signatures(self, key, sha=SHA256):
         for image in self.signable_nodes:
             raw_sig = self.__fdt_get_binary(f'{image}/signature', 'value')
             raw_bin = self.__fdt_get_binary(image, 'data')
 
-            sha = SHA256.new(raw_bin)
+            digest = sha.new(raw_bin)
             verifier = DSS.new(key, 'fips-186-3')
-            verifier.verify(sha, bytes(raw_sig))
+            verifier.verify(digest, bytes(raw_sig))
+
 
+# Curve name for pyCryptodome, FIT algorithm and hash
+ECDSA_CURVES = [
+    ['prime256v1', 'sha256,ecdsa256', SHA256],
+    ['P-384', 'sha384,ecdsa384', SHA384],
+]
 
 @pytest.mark.buildconfigspec('fit_signature')
 @pytest.mark.requiredtool('dtc')
 @pytest.mark.requiredtool('fdtget')
 @pytest.mark.requiredtool('fdtput')
-def test_fit_ecdsa(u_boot_console):
+@pytest.mark.parametrize('curve,algo,sha', ECDSA_CURVES)
+def test_fit_ecdsa(u_boot_console, curve, algo, sha):
     """ Test that signatures generated by mkimage are legible. """
     def generate_ecdsa_key():
-        return ECC.generate(curve='prime256v1')
+        return ECC.generate(curve=curve)
 
     def assemble_fit_image(dest_fit, its, destdir):
         dtc_args = f'-I dts -O dtb -i {destdir}'
@@ -106,6 +127,65 @@ def test_fit_ecdsa(u_boot_console):
     if len(nodes) == 0:
         raise ValueError('FIT image has no "/image" nodes with "signature"')
 
-    fit.change_signature_algo_to_ecdsa()
+    fit.change_signature_algo_to_ecdsa(algo)
     fit.sign(mkimage, key_file)
-    fit.check_signatures(key)
+    fit.check_signatures(key, sha)
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('fit_signature')
+@pytest.mark.buildconfigspec('ecdsa_software')
+@pytest.mark.requiredtool('dtc')
+@pytest.mark.requiredtool('fdtget')
+@pytest.mark.requiredtool('fdtput')
+@pytest.mark.parametrize('curve,algo,sha', ECDSA_CURVES)
+def test_fit_ecdsa_sandbox(u_boot_console, curve, algo, sha):
+    """ Test that the sandbox verifies ECDSA signatures in software. """
+    def dtc(dts):
+        dtb = dts.replace('.dts', '.dtb')
+        util.run_and_log(cons, f'dtc {datadir}/{dts} -O dtb -o {tempdir}/{dtb}')
+
+    def run_bootm(expect_string, boots):
+        cons.restart_uboot()
+        output = ''.join(cons.run_command_list(
+            [f'host load hostfs - 100 {fit_file}',
+             'fdt addr 100',
+             'bootm 100']))
+        assert expect_string in output
+        assert ('sandbox: continuing, as we cannot run' in output) == boots
+
+    cons = u_boot_console
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    datadir = cons.config.source_dir + '/test/py/tests/vboot/'
+    tempdir = cons.config.result_dir
+    key_file = f'{tempdir}/ecdsa-sandbox-key.pem'
+    fit_file = f'{tempdir}/test-ecdsa.fit'
+    dtb = f'{tempdir}/sandbox-u-boot.dtb'
+    dtc('sandbox-kernel.dts')
+    dtc('sandbox-u-boot.dts')
+
+    key = ECC.generate(curve=curve)
+    with open(key_file, 'w') as f:
+        f.write(key.export_key(format='PEM'))
+
+    with open(f'{tempdir}/test-kernel.bin', 'w') as fd:
+        fd.write(500 * chr(0))
+
+    dtc_args = f'-I dts -O dtb -i {tempdir}'
+    util.run_and_log(cons, [mkimage, '-D', dtc_args, '-f',
+                            f'{datadir}/sign-images-sha256.its', fit_file])
+
+    fit = SignableFitImage(cons, fit_file)
+    fit.find_signable_image_nodes()
+    fit.change_signature_algo_to_ecdsa(algo)
+    fit.sign(mkimage, key_file, dtb)
+
+    try:
+        old_dtb = cons.config.dtb
+        cons.config.dtb = dtb
+        run_bootm(f'{algo}:dev+', True)
+
+        fit.corrupt_signatures()
+        run_bootm(f'{algo}:dev-', False)
+    finally:
+        cons.config.dtb = old_dtb
+        cons.restart_uboot()
@@ -0,0 +1,29 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+"""Test the hash command"""
+
+import re
+import pytest
+
+@pytest.mark.buildconfigspec('cmd_hash')
+@pytest.mark.buildconfigspec('sha256')
+def test_hash_sha256(u_boot_console):
+    """The digest of a known region is correct"""
+    cons = u_boot_console
+    cons.run_command('mw.b 1000 61')
+    cons.run_command('mw.b 1001 62')
+    cons.run_command('mw.b 1002 63')
+    output = cons.run_command('hash sha256 1000 3')
+    assert ('ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad'
+            in output)
+
+@pytest.mark.buildconfigspec('cmd_hash')
+@pytest.mark.buildconfigspec('sha256')
+def test_hash_bench(u_boot_console):
+    """The benchmark shows how many times the region was hashed, and how fast"""
+    output = u_boot_console.run_command('hash bench sha256 0 10000')
+    m = re.search(r'^sha256: (\d+) x 65536 bytes in (\d+) us, [\d.]+ MB/s$',
+                  output, re.M)
+    assert m
+    assert int(m.group(1)) >= 1
+    assert int(m.group(2)) >= 1000000
@@ -0,0 +1,47 @@
+# SPDX-License-Identifier: GPL-2.0+
+#
+# Test the sampling profiler
+
+import re
+import pytest
+import u_boot_utils
+
+def get_samples(u_boot_console):
+    """Get the number of samples recorded so far
+
+    Returns:
+        tuple:
+            int: number of samples
+            str: output of the 'profile stats' command
+    """
+    output = u_boot_console.run_command('profile stats')
+    m = re.search(r'^\s*([\d,]+) samples$', output, re.MULTILINE)
+    assert m, output
+    return int(m.group(1).replace(',', '')), output
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_profile')
+def test_profile(u_boot_console):
+    """Take samples while busy, then check that they stop and can be dumped"""
+    cons = u_boot_console
+    ram_base = u_boot_utils.find_ram_base(cons)
+
+    cons.run_command('profile clear')
+    cons.run_command('profile start 100')
+    for _ in range(4):
+        cons.run_command('crc32 %x 4000000' % ram_base)
+    cons.run_command('profile stop')
+
+    samples, output = get_samples(cons)
+    assert 'Profiling stopped' in output
+    assert samples > 0
+
+    # Nothing more is recorded once stopped
+    cons.run_command('crc32 %x 4000000' % ram_base)
+    assert get_samples(cons)[0] == samples
+
+    output = cons.run_command('profile samples %x 100000' % ram_base)
+    assert 'Samples dumped to' in output
+
+    cons.run_command('profile clear')
+    assert get_samples(cons)[0] == 0
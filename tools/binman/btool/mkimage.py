@@ -73,8 +73,9 @@ class Bintoolmkimage(bintool.Bintool):
         Returns:
             str: Version string for mkimage
         """
-        out = self.run(version=True).strip()
-        if not out:
+        out = self.run(version=True)
+        if not out or not out.strip():
             return super().version()
+        out = out.strip()
         m_version = re.match(r'mkimage version (.*)', out)
         return m_version.group(1) if m_version else out
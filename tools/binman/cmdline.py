@@ -99,6 +99,9 @@ controlled by a description in the board device tree.'''
             help='Set argument value arg=value')
     build_parser.add_argument('-b', '--board', type=str,
             help='Board name to build')
+    build_parser.add_argument('--cache-dir', type=str,
+            help='Directory to use for caching entry outputs, so that '
+                 'unchanged entries are not rebuilt')
     build_parser.add_argument('-d', '--dt', type=str,
             help='Configuration file (.dtb) to use')
     build_parser.add_argument('--fake-dtb', action='store_true',
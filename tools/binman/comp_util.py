@@ -7,6 +7,7 @@ import struct
 import tempfile
 
 from binman import bintool
+from binman import state
 from patman import tools
 
 LZ4 = bintool.Bintool.create('lz4')
@@ -25,6 +26,9 @@ def compress(indata, algo, with_header=True):
     This requires 'lz4' and 'lzma_alone' tools. It also requires an output
     directory to be previously set up, by calling PrepareOutputDir().
 
+    If a cache directory is set (see state.SetCacheDir()), the result is
+    taken from there if the same data has been compressed before.
+
     Args:
         indata (bytes): Input data to compress
         algo (str): Algorithm to use ('none', 'lz4' or 'lzma')
@@ -34,13 +38,17 @@ def compress(indata, algo, with_header=True):
     """
     if algo == 'none':
         return indata
-    if algo == 'lz4':
-        data = LZ4.compress(indata)
-    # cbfstool uses a very old version of lzma
-    elif algo == 'lzma':
-        data = LZMA_ALONE.compress(indata)
-    else:
-        raise ValueError("Unknown algorithm '%s'" % algo)
+    key = state.CacheKey('compress', algo, indata)
+    data = state.CacheRead(key)
+    if data is None:
+        if algo == 'lz4':
+            data = LZ4.compress(indata)
+        # cbfstool uses a very old version of lzma
+        elif algo == 'lzma':
+            data = LZMA_ALONE.compress(indata)
+        else:
+            raise ValueError("Unknown algorithm '%s'" % algo)
+        state.CacheWrite(key, data)
     if with_header:
         hdr = struct.pack('<I', len(data))
         data = hdr + data
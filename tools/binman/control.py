@@ -699,6 +699,7 @@ def Binman(args):
             tools.set_tool_paths(args.toolpath)
             state.SetEntryArgs(args.entry_arg)
             state.SetThreads(args.threads)
+            state.SetCacheDir(args.cache_dir)
 
             images = PrepareImagesAndDtbs(dtb_fname, args.image,
                                           args.update_fdt, use_expanded)
@@ -7,9 +7,11 @@
 
 from collections import defaultdict, OrderedDict
 import libfdt
+import os
 
 from binman.entry import Entry, EntryArg
 from binman.etype.section import Entry_section
+from binman import state
 from dtoc import fdt_util
 from dtoc.fdt import Fdt
 from patman import tools
@@ -368,6 +370,16 @@ class Entry_fit(Entry_section):
             Contents of the section (bytes)
         """
         data = self._BuildInput(self._fdt)
+        ext_offset = self._fit_props.get('fit,external-offset')
+        key = None
+        if state.cache_dir:
+            key = state.CacheKey(
+                'fit', state.CacheToolVersion(self.mkimage),
+                ext_offset.bytes if ext_offset is not None else b'',
+                os.environ.get('SOURCE_DATE_EPOCH', ''), data)
+        cached = state.CacheRead(key)
+        if cached is not None:
+            return cached
         uniq = self.GetUniqueName()
         input_fname = tools.get_output_filename('%s.itb' % uniq)
         output_fname = tools.get_output_filename('%s.fit' % uniq)
@@ -375,7 +387,6 @@ class Entry_fit(Entry_section):
         tools.write_file(output_fname, data)
 
         args = {}
-        ext_offset = self._fit_props.get('fit,external-offset')
         if ext_offset is not None:
             args = {
                 'external': True,
@@ -387,7 +398,9 @@ class Entry_fit(Entry_section):
             self.record_missing_bintool(self.mkimage)
             return tools.get_bytes(0, 1024)
 
-        return tools.read_file(output_fname)
+        data = tools.read_file(output_fname)
+        state.CacheWrite(key, data)
+        return data
 
     def _BuildInput(self, fdt):
         """Finish the FIT by adding the 'data' properties to it
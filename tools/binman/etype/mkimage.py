@@ -6,8 +6,10 @@
 #
 
 from collections import OrderedDict
+import os
 
 from binman.entry import Entry
+from binman import state
 from dtoc import fdt_util
 from patman import tools
 
@@ -55,10 +57,16 @@ class Entry_mkimage(Entry):
             self._mkimage_entries.values(), 'mkimage')
         if data is False:
             return False
+        key = self._GetCacheKey(data)
+        cached = state.CacheRead(key)
+        if cached is not None:
+            self.SetContents(cached)
+            return True
         output_fname = tools.get_output_filename('mkimage-out.%s' % uniq)
         if self.mkimage.run_cmd('-d', input_fname, *self._args,
                                 output_fname) is not None:
             self.SetContents(tools.read_file(output_fname))
+            state.CacheWrite(key, self.data)
         else:
             # Bintool is missing; just use the input data as the output
             self.record_missing_bintool(self.mkimage)
@@ -66,6 +74,40 @@ class Entry_mkimage(Entry):
 
         return True
 
+    def _GetCacheKey(self, data):
+        """Work out the cache key for running mkimage on some data
+
+        Arguments may name files, e.g. '-n imximage.cfg', or directories, e.g.
+        '-k keydir', so their contents are included in the key. An argument
+        which looks like a path but does not exist here cannot be checked, so
+        the cache is not used in that case.
+
+        Args:
+            data (bytes): Input data for mkimage
+
+        Returns:
+            str: Cache key, or None to not use the cache
+        """
+        if not state.cache_dir:
+            return None
+        parts = []
+        for arg in self._args:
+            parts.append(arg)
+            if os.path.isfile(arg):
+                parts.append(tools.read_file(arg))
+            elif os.path.isdir(arg):
+                for dirpath, dirnames, fnames in os.walk(arg):
+                    dirnames.sort()
+                    for fname in sorted(fnames):
+                        pathname = os.path.join(dirpath, fname)
+                        parts.append(os.path.relpath(pathname, arg))
+                        parts.append(tools.read_file(pathname))
+            elif os.sep in arg:
+                return None
+        version = state.CacheToolVersion(self.mkimage)
+        return state.CacheKey('mkimage', version, *parts,
+                              os.environ.get('SOURCE_DATE_EPOCH', ''), data)
+
     def ReadEntries(self):
         """Read the subnodes to find out what should go in this image"""
         for node in self._node.subnodes:
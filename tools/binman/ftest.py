@@ -316,7 +316,7 @@ class TestFunctional(unittest.TestCase):
                     use_expanded=False, verbosity=None, allow_missing=False,
                     allow_fake_blobs=False, extra_indirs=None, threads=None,
                     test_section_timeout=False, update_fdt_in_elf=None,
-                    force_missing_bintools=''):
+                    force_missing_bintools='', cache_dir=None):
         """Run binman with a given test file
 
         Args:
@@ -347,6 +347,7 @@ class TestFunctional(unittest.TestCase):
             update_fdt_in_elf: Value to pass with --update-fdt-in-elf=xxx
             force_missing_tools (str): comma-separated list of bintools to
                 regard as missing
+            cache_dir (str): Directory to use for caching entry outputs
 
         Returns:
             int return code, 0 on success
@@ -385,6 +386,8 @@ class TestFunctional(unittest.TestCase):
             args += ['--force-missing-bintools', force_missing_bintools]
         if update_fdt_in_elf:
             args += ['--update-fdt-in-elf', update_fdt_in_elf]
+        if cache_dir:
+            args += ['--cache-dir', cache_dir]
         if images:
             for image in images:
                 args += ['-i', image]
@@ -5321,6 +5324,100 @@ fdt         fdtmap                Extract the devicetree blob from the fdtmap
         self.assertIn("Node '/binman/fit': Unknown operation 'unknown'",
                       str(exc.exception))
 
+    def testCacheCompress(self):
+        """Test that compressed data is taken from the cache"""
+        self._CheckLz4()
+        cache_dir = os.path.join(self._indir, 'cache')
+        self._DoTestFile('083_compress.dts', cache_dir=cache_dir)
+        data = tools.read_file(tools.get_output_filename('image.bin'))
+        self.assertEqual(1, len(os.listdir(cache_dir)))
+
+        # The second build must not need to compress anything
+        with unittest.mock.patch.object(comp_util.LZ4, 'compress',
+                                        side_effect=ValueError('called')):
+            self._DoTestFile('083_compress.dts', cache_dir=cache_dir)
+        self.assertEqual(data,
+                         tools.read_file(tools.get_output_filename('image.bin')))
+        shutil.rmtree(cache_dir)
+
+        # Without the cache, the data is compressed again
+        with unittest.mock.patch.object(comp_util.LZ4, 'compress',
+                                        side_effect=ValueError('called')):
+            with self.assertRaises(ValueError) as exc:
+                self._DoTestFile('083_compress.dts')
+        self.assertIn('called', str(exc.exception))
+
+    def testCacheMkimage(self):
+        """Test that mkimage output is taken from the cache"""
+        cache_dir = os.path.join(self._indir, 'cache')
+        keydir = os.path.join(self._indir, 'mkimage-keys')
+        os.makedirs(keydir, exist_ok=True)
+        tools.write_file(os.path.join(keydir, 'dev.key'), b'key')
+        tools.write_file(os.path.join(self._indir, 'mkimage-name'), b'name')
+
+        # The arguments name a file and a directory in the current directory
+        orig_dir = os.getcwd()
+        try:
+            os.chdir(self._indir)
+            self._DoTestFile('225_mkimage_cache.dts', cache_dir=cache_dir)
+            data = tools.read_file(tools.get_output_filename('image.bin'))
+
+            # The second build must not need to run mkimage
+            with unittest.mock.patch.object(bintool.Bintool, 'run_cmd',
+                                            side_effect=ValueError('called')):
+                self._DoTestFile('225_mkimage_cache.dts', cache_dir=cache_dir)
+            self.assertEqual(
+                data, tools.read_file(tools.get_output_filename('image.bin')))
+
+            # Changing the file or the directory runs mkimage again
+            for fname in ['mkimage-name', 'mkimage-keys/new.key']:
+                tools.write_file(fname, b'changed')
+                with unittest.mock.patch.object(
+                        bintool.Bintool, 'run_cmd',
+                        side_effect=ValueError('called')):
+                    with self.assertRaises(ValueError) as exc:
+                        self._DoTestFile('225_mkimage_cache.dts',
+                                         cache_dir=cache_dir)
+                self.assertIn('called', str(exc.exception))
+                self._DoTestFile('225_mkimage_cache.dts', cache_dir=cache_dir)
+        finally:
+            os.chdir(orig_dir)
+            shutil.rmtree(cache_dir)
+            shutil.rmtree(keydir)
+            os.remove(os.path.join(self._indir, 'mkimage-name'))
+
+    def testCacheMkimageMissingPath(self):
+        """Test that mkimage is not cached if an argument path is missing"""
+        cache_dir = os.path.join(self._indir, 'cache')
+        self._DoTestFile('226_mkimage_cache_missing.dts', cache_dir=cache_dir)
+        self.assertEqual([], os.listdir(cache_dir))
+        shutil.rmtree(cache_dir)
+
+    def testCacheFit(self):
+        """Test that FIT output is taken from the cache"""
+        cache_dir = os.path.join(self._indir, 'cache')
+        self._DoTestFile('161_fit.dts', cache_dir=cache_dir)
+        data = tools.read_file(tools.get_output_filename('image.bin'))
+        self.assertEqual(1, len(os.listdir(cache_dir)))
+
+        # The second build must not need to run mkimage
+        with unittest.mock.patch.object(bintool.Bintool, 'run_cmd',
+                                        side_effect=ValueError('called')):
+            self._DoTestFile('161_fit.dts', cache_dir=cache_dir)
+        self.assertEqual(data,
+                         tools.read_file(tools.get_output_filename('image.bin')))
+
+        # A different mkimage version must run mkimage again
+        versions = {path: 'other' for path in state.tool_versions}
+        with unittest.mock.patch.dict(state.tool_versions, versions):
+            with unittest.mock.patch.object(bintool.Bintool, 'run_cmd',
+                                            side_effect=ValueError('called')):
+                with self.assertRaises(ValueError) as exc:
+                    self._DoTestFile('161_fit.dts', cache_dir=cache_dir)
+        self.assertIn('called', str(exc.exception))
+        shutil.rmtree(cache_dir)
+
+
 
 if __name__ == "__main__":
     unittest.main()
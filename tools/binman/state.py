@@ -63,6 +63,12 @@ allow_entry_contraction = False
 # Number of threads to use for binman (None means machine-dependent)
 num_threads = None
 
+# Directory holding the cache of entry outputs (None to disable the cache)
+cache_dir = None
+
+# Versions of the bintools used in cache keys, indexed by tool path
+tool_versions = {}
+
 
 class Timing:
     """Holds information about an operation that is being timed
@@ -469,6 +475,94 @@ def GetThreads():
     """
     return num_threads
 
+def SetCacheDir(path):
+    """Set the directory to use for caching entry outputs
+
+    Args:
+        path (str): Directory to use (None to disable the cache). It is
+            created if it does not exist.
+    """
+    global cache_dir
+
+    if path:
+        os.makedirs(path, exist_ok=True)
+    cache_dir = path
+
+def CacheKey(*parts):
+    """Work out a cache key from the inputs to an operation
+
+    The key covers everything which affects the output of the operation, so
+    that equal keys mean equal outputs.
+
+    Args:
+        parts (list of bytes or str): Inputs to the operation, e.g. its name,
+            arguments and input data
+
+    Returns:
+        str: Key to use with CacheRead() and CacheWrite(), or None if the
+            cache is disabled
+    """
+    if not cache_dir:
+        return None
+    hsh = hashlib.sha256()
+    for part in parts:
+        if isinstance(part, str):
+            part = part.encode('utf-8')
+        hsh.update(b'%d:' % len(part))
+        hsh.update(part)
+    return hsh.hexdigest()
+
+def CacheToolVersion(btool):
+    """Get the version of a bintool, for use in a cache key
+
+    The version is only obtained once for each tool path, since running the
+    tool for every entry would slow the build down.
+
+    Args:
+        btool (Bintool): Tool to check
+
+    Returns:
+        str: Version string, or a placeholder if the tool is missing
+    """
+    path = btool.get_path() or btool.name
+    if path not in tool_versions:
+        tool_versions[path] = btool.version()
+    return tool_versions[path]
+
+def CacheRead(key):
+    """Read the output of an operation from the cache
+
+    Args:
+        key (str): Key from CacheKey(), or None
+
+    Returns:
+        bytes: Cached output, or None if not present
+    """
+    if not key:
+        return None
+    fname = os.path.join(cache_dir, key)
+    if not os.path.exists(fname):
+        return None
+    tout.debug(f"Using cached output '{key}'")
+    return tools.read_file(fname)
+
+def CacheWrite(key, data):
+    """Write the output of an operation to the cache
+
+    The file is written under a temporary name and then renamed, so that
+    another binman sharing the cache never sees a partial file.
+
+    Args:
+        key (str): Key from CacheKey(), or None to do nothing
+        data (bytes): Output of the operation
+    """
+    if not key:
+        return
+    fname = os.path.join(cache_dir, key)
+    tmpname = f'{fname}.{os.getpid()}.{threading.get_ident()}'
+    tools.write_file(tmpname, data)
+    os.replace(tmpname, fname)
+
 def GetTiming(name):
     """Get the timing info for a particular operation
 
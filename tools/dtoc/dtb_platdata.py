@@ -170,8 +170,11 @@ class DtbPlatdata():
             the selected devices (see _valid_node), in alphabetical order
         _instantiate: Instantiate devices so they don't need to be bound at
             run-time
+        _driver_ref: Refer to each device's driver directly from its
+            U_BOOT_DRVINFO(), so it need not be looked up by name at run-time
     """
-    def __init__(self, scan, dtb_fname, include_disabled, instantiate=False):
+    def __init__(self, scan, dtb_fname, include_disabled, instantiate=False,
+                 driver_ref=False):
         self._scan = scan
         self._fdt = None
         self._dtb_fname = dtb_fname
@@ -185,6 +188,7 @@ class DtbPlatdata():
         self._basedir = None
         self._valid_uclasses = None
         self._instantiate = instantiate
+        self._driver_ref = driver_ref
 
     def setup_output_dirs(self, output_dirs):
         """Set up the output directories
@@ -652,6 +656,8 @@ class DtbPlatdata():
         if node.parent and node.parent in self._valid_nodes:
             idx = node.parent.idx
         self.buf('\t.parent_idx\t= %d,\n' % idx)
+        if self._driver_ref:
+            self.buf('\t.drv\t\t= DM_DRIVER_REF(%s),\n' % node.driver.name)
         self.buf('};\n')
         self.buf('\n')
 
@@ -1150,7 +1156,7 @@ OUTPUT_FILES_INST = {
 
 def run_steps(args, dtb_file, include_disabled, output, output_dirs, phase,
               instantiate, warning_disabled=False, drivers_additional=None,
-              basedir=None, scan=None):
+              basedir=None, scan=None, driver_ref=False):
     """Run all the steps of the dtoc tool
 
     Args:
@@ -1173,6 +1179,9 @@ def run_steps(args, dtb_file, include_disabled, output, output_dirs, phase,
             grandparent of this file's directory
         scan (src_src.Scanner): Scanner from a previous run. This can help speed
             up tests. Use None for normal operation
+        driver_ref (bool): Refer to drivers directly from U_BOOT_DRVINFO(),
+            so that they need not be looked up by name at run-time. This
+            requires a driver for every device
 
     Returns:
         DtbPlatdata object
@@ -1191,7 +1200,8 @@ def run_steps(args, dtb_file, include_disabled, output, output_dirs, phase,
         do_process = True
     else:
         do_process = False
-    plat = DtbPlatdata(scan, dtb_file, include_disabled, instantiate)
+    plat = DtbPlatdata(scan, dtb_file, include_disabled, instantiate,
+                       driver_ref)
     plat.scan_dtb()
     plat.scan_tree(add_root=instantiate)
     plat.prepare_nodes()
@@ -1199,7 +1209,7 @@ def run_steps(args, dtb_file, include_disabled, output, output_dirs, phase,
     plat.setup_output_dirs(output_dirs)
     plat.scan_structs()
     plat.scan_phandles()
-    plat.process_nodes(instantiate)
+    plat.process_nodes(instantiate or driver_ref)
     plat.read_aliases()
     plat.assign_seqs()
 
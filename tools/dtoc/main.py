@@ -89,6 +89,8 @@ parser.add_argument('--include-disabled', action='store_true',
                   help='Include disabled nodes')
 parser.add_argument('-o', '--output', action='store',
                   help='Select output filename')
+parser.add_argument('-r', '--driver-ref', action='store_true',
+                  help='Refer to drivers directly from U_BOOT_DRVINFO()')
 parser.add_argument('-p', '--phase', type=str,
                   help='set phase of U-Boot this invocation is for (spl/tpl)')
 parser.add_argument('-P', '--processes', type=int,
@@ -112,4 +114,5 @@ else:
     dtb_platdata.run_steps(args.files, args.dtb_file, args.include_disabled,
                            args.output,
                            [args.c_output_dir, args.h_output_dir],
-                           args.phase, instantiate=args.instantiate)
+                           args.phase, instantiate=args.instantiate,
+                           driver_ref=args.driver_ref)
@@ -13,6 +13,7 @@ import collections
 import copy
 import glob
 import os
+import re
 import struct
 import unittest
 
@@ -872,6 +873,38 @@ U_BOOT_DRVINFO(gpios_at_0) = {
 
 ''', data)
 
+    def test_driver_ref(self):
+        """Test output with references from each device to its driver"""
+        dtb_file = get_dtb_file('dtoc_test_simple.dts')
+        output = tools.get_output_filename('output')
+        dtb_platdata.run_steps(
+            ['platdata'], dtb_file, False, output, [], None, False,
+            warning_disabled=True, scan=copy_scan(), driver_ref=True)
+        with open(output) as infile:
+            data = infile.read()
+        self.assertIn('''U_BOOT_DRVINFO(i2c_at_0) = {
+\t.name\t\t= "sandbox_i2c",
+\t.plat\t\t= &dtv_i2c_at_0,
+\t.plat_size\t= sizeof(dtv_i2c_at_0),
+\t.parent_idx\t= -1,
+\t.drv\t\t= DM_DRIVER_REF(sandbox_i2c),
+};
+''', data)
+
+        # Apart from the references, the output is unchanged
+        self._check_strings(
+            self.platdata_text,
+            re.sub(r'\t\.drv\t\t= DM_DRIVER_REF\(\w+\),\n', '', data))
+
+        # Every device must have a driver
+        dtb_file = get_dtb_file('dtoc_test_invalid_driver.dts')
+        with self.assertRaises(ValueError) as exc:
+            dtb_platdata.run_steps(
+                ['platdata'], dtb_file, False, output, [], None, False,
+                warning_disabled=True, scan=copy_scan(), driver_ref=True)
+        self.assertIn("Cannot parse/find driver for 'invalid'",
+                      str(exc.exception))
+
     def test_invalid_driver(self):
         """Test output from a device tree file with an invalid driver"""
         dtb_file = get_dtb_file('dtoc_test_invalid_driver.dts')
@@ -128,11 +128,12 @@ static int fdt_property_file(struct image_tool_params *params,
 			     void *fdt, const char *name, const char *fname)
 {
 	struct stat sbuf;
+	off_t done;
 	void *ptr;
 	int ret;
 	int fd;
 
-	fd = open(fname, O_RDWR | O_BINARY);
+	fd = open(fname, O_RDONLY | O_BINARY);
 	if (fd < 0) {
 		fprintf(stderr, "%s: Can't open %s: %s\n",
 			params->cmdname, fname, strerror(errno));
@@ -148,11 +149,15 @@ static int fdt_property_file(struct image_tool_params *params,
 	ret = fdt_property_placeholder(fdt, "data", sbuf.st_size, &ptr);
 	if (ret)
 		goto err;
-	ret = read(fd, ptr, sbuf.st_size);
-	if (ret != sbuf.st_size) {
-		fprintf(stderr, "%s: Can't read %s: %s\n",
-			params->cmdname, fname, strerror(errno));
-		goto err;
+
+	for (done = 0; done < sbuf.st_size; done += ret) {
+		ret = read(fd, ptr + done, sbuf.st_size - done);
+		if (ret <= 0) {
+			fprintf(stderr, "%s: Can't read %s: %s\n",
+				params->cmdname, fname,
+				ret ? strerror(errno) : "Unexpected end of file");
+			goto err;
+		}
 	}
 	close(fd);
 
@@ -391,39 +396,47 @@ static int fit_build(struct image_tool_params *params, const char *fname)
 	size = fit_calc_size(params);
 	if (size < 0)
 		return -1;
-	buf = calloc(1, size);
-	if (!buf) {
-		fprintf(stderr, "%s: Out of memory (%d bytes)\n",
-			params->cmdname, size);
+	fd = open(fname, O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0666);
+	if (fd < 0) {
+		fprintf(stderr, "%s: Can't open %s: %s\n",
+			params->cmdname, fname, strerror(errno));
 		return -1;
 	}
+
+	/*
+	 * Build the FIT directly in the output file, so that the image data
+	 * is only copied once
+	 */
+	if (ftruncate(fd, size)) {
+		fprintf(stderr, "%s: Can't resize %s: %s\n",
+			params->cmdname, fname, strerror(errno));
+		goto err;
+	}
+	buf = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (buf == MAP_FAILED) {
+		fprintf(stderr, "%s: Can't map %s: %s\n",
+			params->cmdname, fname, strerror(errno));
+		goto err;
+	}
 	ret = fit_build_fdt(params, buf, size);
+	munmap(buf, size);
 	if (ret < 0) {
 		fprintf(stderr, "%s: Failed to build FIT image\n",
 			params->cmdname);
-		goto err_buf;
+		goto err;
 	}
 	size = ret;
-	fd = open(fname, O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0666);
-	if (fd < 0) {
-		fprintf(stderr, "%s: Can't open %s: %s\n",
-			params->cmdname, fname, strerror(errno));
-		goto err_buf;
-	}
-	ret = write(fd, buf, size);
-	if (ret != size) {
+	if (ftruncate(fd, size)) {
 		fprintf(stderr, "%s: Can't write %s: %s\n",
 			params->cmdname, fname, strerror(errno));
 		goto err;
 	}
 	close(fd);
-	free(buf);
 
 	return 0;
 err:
 	close(fd);
-err_buf:
-	free(buf);
+	unlink(fname);
 	return -1;
 }
 
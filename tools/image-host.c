@@ -12,8 +12,237 @@
 #include <bootm.h>
 #include <fdt_region.h>
 #include <image.h>
+#include <pthread.h>
 #include <version.h>
 
+#if IMAGE_ENABLE_ENCRYPT
+#include <openssl/rand.h>
+#endif
+
+/* Maximum number of hash nodes whose values are worked out in advance */
+#define FIT_HASH_JOBS_MAX	64
+
+/**
+ * struct fit_hash_job - Hash value for a hash node, worked out in advance
+ *
+ * The hashes for all images are calculated in parallel before the nodes are
+ * processed one by one, and are kept so that they can be used again when
+ * fit_handle_file() retries with a larger FIT.
+ *
+ * @path: Path to the hash node
+ * @algo: Hash algorithm
+ * @data: Image data to hash, valid only while the FIT is mapped
+ * @data_offset: Offset of the image data from the start of the FIT
+ * @size: Size of the image data
+ * @reuse: true if the data is the same on every attempt, i.e. the image is not
+ *	ciphered
+ * @pending: true if the value still needs to be calculated
+ * @ret: 0 if the value is valid, else -ve error
+ * @value: Hash value
+ * @value_len: Length of @value in bytes
+ */
+struct fit_hash_job {
+	char path[NODE_MAX_NAME_LEN];
+	char algo[32];
+	const void *data;
+	long data_offset;
+	size_t size;
+	bool reuse;
+	bool pending;
+	int ret;
+	uint8_t value[FIT_MAX_HASH_LEN];
+	int value_len;
+};
+
+static struct fit_hash_job hash_jobs[FIT_HASH_JOBS_MAX];
+static int hash_job_count;
+static int hash_job_next;
+static pthread_mutex_t hash_job_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *fit_hash_worker(void *arg)
+{
+	struct fit_hash_job *job;
+
+	while (1) {
+		pthread_mutex_lock(&hash_job_lock);
+		while (hash_job_next < hash_job_count &&
+		       !hash_jobs[hash_job_next].pending)
+			hash_job_next++;
+		job = hash_job_next < hash_job_count ?
+			&hash_jobs[hash_job_next++] : NULL;
+		pthread_mutex_unlock(&hash_job_lock);
+		if (!job)
+			break;
+
+		job->ret = calculate_hash(job->data, job->size, job->algo,
+					  job->value, &job->value_len);
+		job->pending = false;
+	}
+
+	return NULL;
+}
+
+/**
+ * fit_hash_find_old() - Find a hash calculated on an earlier attempt
+ *
+ * @old: Jobs from the earlier attempt
+ * @count: Number of jobs in @old
+ * @job: Job to look up
+ * Return: matching job with a valid value, or NULL if none
+ */
+static struct fit_hash_job *fit_hash_find_old(struct fit_hash_job *old,
+					      int count,
+					      struct fit_hash_job *job)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (old[i].reuse && !old[i].ret &&
+		    old[i].data_offset == job->data_offset &&
+		    old[i].size == job->size &&
+		    !strcmp(old[i].path, job->path) &&
+		    !strcmp(old[i].algo, job->algo))
+			return &old[i];
+	}
+
+	return NULL;
+}
+
+/**
+ * fit_hash_prepare() - Calculate the hashes for all images in parallel
+ *
+ * This collects the hash nodes of all images and hashes their data using a
+ * thread per CPU, so that fit_image_process_hash() only has to store the
+ * values. Hashes from an earlier call are reused if the image data cannot
+ * have changed. Any hash which cannot be worked out here is calculated by
+ * fit_image_process_hash() as usual.
+ *
+ * @fit: FIT to process
+ * @images_noffset: Offset of the /images node
+ */
+static void fit_hash_prepare(void *fit, int images_noffset)
+{
+	struct fit_hash_job *old, *job;
+	pthread_t threads[FIT_HASH_JOBS_MAX];
+	int old_count, pending;
+	int image, noffset;
+	long nthreads;
+	int i;
+
+	/* Keep the values from the last attempt, in case they can be reused */
+	old = NULL;
+	old_count = 0;
+	if (hash_job_count) {
+		old = malloc(sizeof(*old) * hash_job_count);
+		if (old) {
+			old_count = hash_job_count;
+			memcpy(old, hash_jobs, sizeof(*old) * old_count);
+		}
+	}
+
+	hash_job_count = 0;
+	pending = 0;
+	fdt_for_each_subnode(image, fit, images_noffset) {
+		const void *data;
+		size_t size;
+		bool reuse;
+
+		if (fit_image_get_data(fit, image, &data, &size))
+			continue;
+		reuse = fdt_subnode_offset(fit, image, FIT_CIPHER_NODENAME) ==
+			-FDT_ERR_NOTFOUND;
+
+		fdt_for_each_subnode(noffset, fit, image) {
+			const char *name = fit_get_name(fit, noffset, NULL);
+			struct fit_hash_job *prev;
+			const char *algo;
+
+			if (strncmp(name, FIT_HASH_NODENAME,
+				    strlen(FIT_HASH_NODENAME)) ||
+			    fit_image_hash_get_algo(fit, noffset, &algo) ||
+			    strlen(algo) >= sizeof(job->algo) ||
+			    hash_job_count == FIT_HASH_JOBS_MAX)
+				continue;
+
+			job = &hash_jobs[hash_job_count];
+			if (fdt_get_path(fit, noffset, job->path,
+					 sizeof(job->path)))
+				continue;
+			strcpy(job->algo, algo);
+			job->data = data;
+			job->data_offset = (const char *)data - (const char *)fit;
+			job->size = size;
+			job->reuse = reuse;
+			job->ret = -EAGAIN;
+			job->pending = true;
+
+			prev = fit_hash_find_old(old, old_count, job);
+			if (prev) {
+				memcpy(job->value, prev->value, prev->value_len);
+				job->value_len = prev->value_len;
+				job->ret = 0;
+				job->pending = false;
+			} else {
+				pending++;
+			}
+			hash_job_count++;
+		}
+	}
+	free(old);
+
+	hash_job_next = 0;
+	nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads > pending)
+		nthreads = pending;
+	if (nthreads < 2) {
+		fit_hash_worker(NULL);
+		return;
+	}
+
+	for (i = 0; i < nthreads; i++) {
+		if (pthread_create(&threads[i], NULL, fit_hash_worker, NULL))
+			break;
+	}
+	/* If no threads could be started, do the work here */
+	if (!i)
+		fit_hash_worker(NULL);
+	while (i--)
+		pthread_join(threads[i], NULL);
+}
+
+/**
+ * fit_hash_lookup() - Get a hash value worked out by fit_hash_prepare()
+ *
+ * @fit: FIT being processed
+ * @noffset: Offset of the hash node
+ * @algo: Hash algorithm
+ * @value: Returns the hash value
+ * @value_len: Returns the length of @value
+ * Return: 0 if found, -ENOENT if the hash must be calculated
+ */
+static int fit_hash_lookup(void *fit, int noffset, const char *algo,
+			   uint8_t *value, int *value_len)
+{
+	char path[NODE_MAX_NAME_LEN];
+	int i;
+
+	if (!hash_job_count ||
+	    fdt_get_path(fit, noffset, path, sizeof(path)))
+		return -ENOENT;
+	for (i = 0; i < hash_job_count; i++) {
+		struct fit_hash_job *job = &hash_jobs[i];
+
+		if (!job->ret && !strcmp(job->path, path) &&
+		    !strcmp(job->algo, algo)) {
+			memcpy(value, job->value, job->value_len);
+			*value_len = job->value_len;
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
 /**
  * fit_set_hash_value - set hash value in requested has node
  * @fit: pointer to the FIT format image header
@@ -74,7 +303,8 @@ static int fit_image_process_hash(void *fit, const char *image_name,
 		return -ENOENT;
 	}
 
-	if (calculate_hash(data, size, algo, value, &value_len)) {
+	if (fit_hash_lookup(fit, noffset, algo, value, &value_len) &&
+	    calculate_hash(data, size, algo, value, &value_len)) {
 		printf("Unsupported hash algorithm (%s) for '%s' hash node in '%s' image node\n",
 		       algo, node_name, image_name);
 		return -EPROTONOSUPPORT;
@@ -361,6 +591,26 @@ static int get_random_data(void *data, int size)
 	return ret;
 }
 
+/*
+ * Reusing a counter-mode IV with the same key gives away the XOR of the two
+ * plain texts, so these need a new IV from a strong source for each image
+ */
+static bool fit_cipher_is_ctr(struct cipher_algo *cipher)
+{
+	return strstr(cipher->name, "-ctr");
+}
+
+static int get_random_iv(void *data, int size)
+{
+#if IMAGE_ENABLE_ENCRYPT
+	if (RAND_bytes(data, size) == 1)
+		return 0;
+#endif
+	printf("%s: Cannot generate a random IV\n", __func__);
+
+	return -1;
+}
+
 static int fit_image_setup_cipher(struct image_cipher_info *info,
 				  const char *keydir, void *fit,
 				  const char *image_name, int image_noffset,
@@ -403,6 +653,11 @@ static int fit_image_setup_cipher(struct image_cipher_info *info,
 		printf("Can't get algo for cipher '%s'\n", image_name);
 		goto out;
 	}
+	if (info->ivname && fit_cipher_is_ctr(info->cipher)) {
+		printf("Can't use iv-name-hint with cipher '%s' in image '%s'\n",
+		       algo_name, image_name);
+		goto out;
+	}
 
 	/* Read the key in the file */
 	snprintf(filename, sizeof(filename), "%s/%s%s",
@@ -431,6 +686,8 @@ static int fit_image_setup_cipher(struct image_cipher_info *info,
 			 info->keydir, info->ivname, ".bin");
 		ret = fit_image_read_data(filename, (unsigned char *)info->iv,
 					  info->cipher->iv_len);
+	} else if (fit_cipher_is_ctr(info->cipher)) {
+		ret = get_random_iv((void *)info->iv, info->cipher->iv_len);
 	} else {
 		/* Generate an ramdom IV */
 		ret = get_random_data((void *)info->iv, info->cipher->iv_len);
@@ -1164,6 +1421,9 @@ int fit_add_verification_data(const char *keydir, const char *keyfile,
 		return images_noffset;
 	}
 
+	/* Work out all the image hashes up front, in parallel */
+	fit_hash_prepare(fit, images_noffset);
+
 	/* Process its subnodes, print out component images details */
 	for (noffset = fdt_first_subnode(fit, images_noffset);
 	     noffset >= 0;
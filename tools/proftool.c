@@ -21,6 +21,8 @@
 #include <trace.h>
 
 #define MAX_LINE_LEN 500
+#define MAX_STACK_DEPTH 1024	/* Deepest call stack we track */
+#define CALL_CHUNK 4096		/* Number of call records to read at once */
 
 enum {
 	FUNCF_TRACE	= 1 << 0,	/* Include this function in trace */
@@ -34,6 +36,29 @@ struct func_info {
 	unsigned flags;
 	/* the section this function is in */
 	struct objsection_info *objsection;
+	/* time spent in this function and its callees, in microseconds */
+	unsigned long long inclusive_us;
+	/* time spent in this function alone, in microseconds */
+	unsigned long long exclusive_us;
+	int active;		/* number of calls currently on the stack */
+};
+
+/* A node in the call graph, i.e. a function reached by a particular path */
+struct call_node {
+	struct func_info *func;		/* NULL for the root */
+	struct call_node *parent;
+	struct call_node *child;	/* first callee */
+	struct call_node *sibling;	/* next callee of our parent */
+	unsigned long count;		/* number of calls */
+	unsigned long long exclusive_us;
+};
+
+/* A function call in progress while processing the trace */
+struct call_frame {
+	struct func_info *func;
+	struct call_node *node;
+	unsigned long long start_us;	/* time of entry */
+	unsigned long long child_us;	/* time spent in callees */
 };
 
 enum trace_line_type {
@@ -55,7 +80,19 @@ struct func_info *func_list;
 int func_count;
 struct trace_call *call_list;
 int call_count;
+uint32_t *sample_list;		/* Sample records from the profiler */
+int sample_words;		/* Number of words in sample_list */
+int keep_calls;	/* Keep call records in call_list after processing them */
+int summary_limit;	/* Max number of functions in the summary, 0 for all */
 int verbose;	/* Verbosity level 0=none, 1=warn, 2=notice, 3=info, 4=debug */
+
+/* State while processing the call trace */
+struct call_node call_root;
+struct call_frame call_stack[MAX_STACK_DEPTH];
+int call_depth;
+unsigned long long call_time_us;	/* time of the last record processed */
+uint32_t call_last_ts;			/* timestamp of the last record */
+int call_missing;			/* records for unknown functions */
 unsigned long text_offset;		/* text address of first function */
 
 static void outf(int level, const char *fmt, ...)
@@ -85,9 +122,13 @@ static void usage(void)
 		"\n"
 		"Commands\n"
 		"   dump-ftrace\t\tDump out textual data in ftrace format\n"
+		"   dump-chrome\t\tDump out function calls as Chrome trace-event JSON\n"
+		"   dump-stacks\t\tDump out collapsed stacks for flame graphs\n"
+		"   dump-summary\t\tDump out call count and time for each function\n"
 		"\n"
 		"Options:\n"
 		"   -m <map>\tSpecify Systen.map file\n"
+		"   -n <count>\tLimit the summary to the top <count> functions\n"
 		"   -t <trace>\tSpecific trace data file (from U-Boot)\n"
 		"   -v <0-4>\tSpecify verbosity\n");
 	exit(EXIT_FAILURE);
@@ -205,24 +246,170 @@ static struct func_info *find_caller_by_offset(uint32_t offset)
 	return low >= 0 ? &func_list[low] : NULL;
 }
 
+static struct call_node *find_call_node(struct call_node *parent,
+					struct func_info *func)
+{
+	struct call_node *node;
+
+	for (node = parent->child; node; node = node->sibling) {
+		if (node->func == func)
+			return node;
+	}
+	node = calloc(1, sizeof(*node));
+	if (!node)
+		return NULL;
+	node->func = func;
+	node->parent = parent;
+	node->sibling = parent->child;
+	parent->child = node;
+
+	return node;
+}
+
+/* Finish the call at the top of the stack, accounting for its time */
+static void pop_call(void)
+{
+	struct call_frame *frame = &call_stack[--call_depth];
+	unsigned long long inclusive = call_time_us - frame->start_us;
+	unsigned long long exclusive = inclusive - frame->child_us;
+	struct func_info *func = frame->func;
+
+	frame->node->count++;
+	frame->node->exclusive_us += exclusive;
+	func->call_count++;
+	func->exclusive_us += exclusive;
+
+	/* Only count the outermost call of a recursive function */
+	if (!--func->active)
+		func->inclusive_us += inclusive;
+	if (call_depth)
+		call_stack[call_depth - 1].child_us += inclusive;
+}
+
+/*
+ * Add a function entry or exit to the call graph and per-function times.
+ * Functions excluded by the trace config are not tracked, so their time is
+ * counted in their caller.
+ */
+static int process_call(const struct trace_call *call)
+{
+	uint32_t ts = call->flags & FUNCF_TIMESTAMP_MASK;
+	struct func_info *func;
+	int i;
+
+	if (TRACE_CALL_TYPE(call) != FUNCF_ENTRY &&
+	    TRACE_CALL_TYPE(call) != FUNCF_EXIT)
+		return 0;
+
+	/* The timestamp wraps, so accumulate the time since the last one */
+	if (call_time_us || call_last_ts)
+		call_time_us += (ts - call_last_ts) & FUNCF_TIMESTAMP_MASK;
+	else
+		call_time_us = ts;
+	call_last_ts = ts;
+
+	func = find_func_by_offset(call->func);
+	if (!func) {
+		call_missing++;
+		return 0;
+	}
+	if (!(func->flags & FUNCF_TRACE))
+		return 0;
+
+	if (TRACE_CALL_TYPE(call) == FUNCF_ENTRY) {
+		struct call_node *parent;
+		struct call_frame *frame;
+
+		if (call_depth == MAX_STACK_DEPTH) {
+			error("Call stack too deep\n");
+			return -1;
+		}
+		parent = call_depth ? call_stack[call_depth - 1].node :
+			&call_root;
+		frame = &call_stack[call_depth];
+		frame->node = find_call_node(parent, func);
+		if (!frame->node) {
+			error("Cannot allocate call node\n");
+			return -1;
+		}
+		frame->func = func;
+		frame->start_us = call_time_us;
+		frame->child_us = 0;
+		func->active++;
+		call_depth++;
+		return 0;
+	}
+
+	/*
+	 * Find the matching entry. Exits from functions entered before
+	 * tracing started have none, so are ignored.
+	 */
+	for (i = call_depth - 1; i >= 0; i--) {
+		if (call_stack[i].func == func)
+			break;
+	}
+	if (i < 0)
+		return 0;
+	while (call_depth > i)
+		pop_call();
+
+	return 0;
+}
+
 static int read_calls(FILE *fin, size_t count)
 {
-	struct trace_call *call_data;
+	struct trace_call chunk[CALL_CHUNK];
+	size_t done, todo;
 	int i;
 
 	notice("call count: %zu\n", count);
-	call_list = (struct trace_call *)calloc(count, sizeof(*call_data));
-	if (!call_list) {
-		error("Cannot allocate call_list\n");
-		return -1;
+	if (keep_calls) {
+		call_list = realloc(call_list, (call_count + count) *
+				    sizeof(*call_list));
+		if (!call_list) {
+			error("Cannot allocate call_list\n");
+			return -1;
+		}
 	}
-	call_count = count;
 
-	call_data = call_list;
-	for (i = 0; i < count; i++, call_data++) {
-		if (read_data(fin, call_data, sizeof(*call_data)))
+	/* Process the records as they are read, a chunk at a time */
+	for (done = 0; done < count; done += todo) {
+		todo = MIN(count - done, CALL_CHUNK);
+		if (read_data(fin, chunk, todo * sizeof(*chunk)))
 			return 1;
+		for (i = 0; i < todo; i++) {
+			if (process_call(&chunk[i]))
+				return -1;
+		}
+		if (keep_calls) {
+			memcpy(call_list + call_count, chunk,
+			       todo * sizeof(*chunk));
+			call_count += todo;
+		}
 	}
+	if (call_missing)
+		warn("%d call records for unknown functions\n", call_missing);
+
+	return 0;
+}
+
+static int read_samples(FILE *fin, size_t count)
+{
+	uint32_t *samples;
+
+	notice("sample words: %zu\n", count);
+	samples = realloc(sample_list, (sample_words + count) *
+			  sizeof(*sample_list));
+	if (!samples) {
+		error("Cannot allocate sample_list\n");
+		return -1;
+	}
+	sample_list = samples;
+	if (count && read_data(fin, sample_list + sample_words,
+			       count * sizeof(*sample_list)))
+		return 1;
+	sample_words += count;
+
 	return 0;
 }
 
@@ -243,12 +430,20 @@ static int read_profile(FILE *fin, int *not_found)
 		switch (hdr.type) {
 		case TRACE_CHUNK_FUNCS:
 			/* Ignored at present */
+			if (fseek(fin, hdr.rec_count *
+				  sizeof(struct trace_output_func), SEEK_CUR))
+				return 1;
 			break;
 
 		case TRACE_CHUNK_CALLS:
 			if (read_calls(fin, hdr.rec_count))
 				return 1;
 			break;
+
+		case TRACE_CHUNK_SAMPLES:
+			if (read_samples(fin, hdr.rec_count))
+				return 1;
+			break;
 		}
 	}
 	return 0;
@@ -532,26 +727,266 @@ static int make_ftrace(void)
 	return 0;
 }
 
+static int h_cmp_str(const void *v1, const void *v2)
+{
+	return strcmp(*(char *const *)v1, *(char *const *)v2);
+}
+
+static const char *sample_func_name(uint32_t offset, char *buf, int size)
+{
+	struct func_info *func = NULL;
+
+	if (func_count)
+		func = find_caller_by_offset(offset);
+	if (func)
+		return func->name;
+	snprintf(buf, size, "%lx", text_offset + offset);
+
+	return buf;
+}
+
+/*
+ * Write out one line for each distinct call chain, with the functions from
+ * the outermost caller to the sampled function separated by semicolons,
+ * followed by the number of samples. This is the 'collapsed' format read by
+ * flamegraph.pl and similar tools:
+ *
+ * board_init_r;run_main_loop;...;hash_block;sha256_process 42
+ */
+static int make_sample_stacks(void)
+{
+	char **stacks;
+	int nstacks = 0, dropped = 0;
+	int pos, i;
+
+	stacks = calloc(sample_words, sizeof(*stacks));
+	if (!stacks && sample_words) {
+		error("Cannot allocate stacks\n");
+		return -1;
+	}
+	for (pos = 0; pos < sample_words; pos += 1 + sample_list[pos]) {
+		uint32_t depth = sample_list[pos];
+		char line[MAX_LINE_LEN * 4];
+		char name[20];
+		int len = 0;
+
+		if (!depth || pos + depth >= sample_words) {
+			warn("Invalid sample at word %d\n", pos);
+			break;
+		}
+		for (i = depth; i > 0; i--) {
+			uint32_t offset = sample_list[pos + i];
+
+			/* Return addresses point after the call instruction */
+			if (i > 1)
+				offset--;
+			len += snprintf(line + len, sizeof(line) - len, "%s%s",
+					i == depth ? "" : ";",
+					sample_func_name(offset, name,
+							 sizeof(name)));
+			if (len >= sizeof(line))
+				break;
+		}
+		if (len >= sizeof(line)) {
+			dropped++;
+			continue;
+		}
+		stacks[nstacks] = strdup(line);
+		if (!stacks[nstacks]) {
+			error("Cannot allocate stack\n");
+			return -1;
+		}
+		nstacks++;
+	}
+	qsort(stacks, nstacks, sizeof(*stacks), h_cmp_str);
+
+	for (i = 0; i < nstacks; i = pos) {
+		for (pos = i + 1; pos < nstacks; pos++) {
+			if (strcmp(stacks[i], stacks[pos]))
+				break;
+		}
+		printf("%s %d\n", stacks[i], pos - i);
+	}
+	info("stacks: %d samples, %d dropped\n", nstacks, dropped);
+	for (i = 0; i < nstacks; i++)
+		free(stacks[i]);
+	free(stacks);
+
+	return 0;
+}
+
+/* Print the collapsed stack for each node, weighted by exclusive time */
+static void out_call_stacks(struct call_node *node, char *path, int len)
+{
+	struct call_node *child;
+
+	if (node->func) {
+		int add = snprintf(path + len, MAX_LINE_LEN * 4 - len, "%s%s",
+				   len ? ";" : "", node->func->name);
+
+		if (len + add >= MAX_LINE_LEN * 4) {
+			warn("Call stack too long: %s\n", path);
+			return;
+		}
+		len += add;
+		if (node->exclusive_us)
+			printf("%s %llu\n", path, node->exclusive_us);
+	}
+	for (child = node->child; child; child = child->sibling)
+		out_call_stacks(child, path, len);
+}
+
+/*
+ * Write out collapsed stacks. If there are samples from the sampling
+ * profiler, each line gives the number of samples for a call chain. Otherwise
+ * they are built from the function-call trace, and each line gives the
+ * time spent in the last function of the chain, in microseconds.
+ */
+static int make_stacks(void)
+{
+	char path[MAX_LINE_LEN * 4];
+
+	if (sample_words)
+		return make_sample_stacks();
+	path[0] = '\0';
+	out_call_stacks(&call_root, path, 0);
+
+	return 0;
+}
+
+static int h_cmp_exclusive(const void *v1, const void *v2)
+{
+	const struct func_info *f1 = *(struct func_info *const *)v1;
+	const struct func_info *f2 = *(struct func_info *const *)v2;
+
+	if (f1->exclusive_us != f2->exclusive_us)
+		return f1->exclusive_us < f2->exclusive_us ? 1 : -1;
+
+	return strcmp(f1->name, f2->name);
+}
+
+/* Write out the call count and time for each called function */
+static int make_summary(void)
+{
+	struct func_info **funcs;
+	unsigned long long total_us = 0;
+	int count = 0, i;
+
+	funcs = calloc(func_count, sizeof(*funcs));
+	if (!funcs && func_count) {
+		error("Cannot allocate function list\n");
+		return -1;
+	}
+	for (i = 0; i < func_count; i++) {
+		if (func_list[i].call_count) {
+			funcs[count++] = &func_list[i];
+			total_us += func_list[i].exclusive_us;
+		}
+	}
+	qsort(funcs, count, sizeof(*funcs), h_cmp_exclusive);
+	if (summary_limit && count > summary_limit)
+		count = summary_limit;
+
+	printf("%10s %15s %15s %6s  %s\n", "Calls", "Inclusive us",
+	       "Exclusive us", "Excl%", "Function");
+	for (i = 0; i < count; i++) {
+		struct func_info *func = funcs[i];
+
+		printf("%10lu %15llu %15llu %6.2f  %s\n", func->call_count,
+		       func->inclusive_us, func->exclusive_us,
+		       total_us ? func->exclusive_us * 100.0 / total_us : 0,
+		       func->name);
+	}
+	free(funcs);
+
+	return 0;
+}
+
+/*
+ * Write out the function calls in the Chrome trace-event format, which can
+ * be loaded into chrome://tracing or Perfetto:
+ *
+ * {"traceEvents": [
+ * {"name": "board_init_r", "ph": "B", "ts": 1234, "pid": 1, "tid": 1},
+ * ...
+ * ]}
+ */
+static int make_chrome(void)
+{
+	unsigned long long time_us = 0;
+	uint32_t last_ts = 0;
+	struct trace_call *call;
+	int first = 1;
+	int i;
+
+	printf("{\"traceEvents\": [\n");
+	for (i = 0, call = call_list; i < call_count; i++, call++) {
+		uint32_t ts = call->flags & FUNCF_TIMESTAMP_MASK;
+		struct func_info *func;
+
+		if (TRACE_CALL_TYPE(call) != FUNCF_ENTRY &&
+		    TRACE_CALL_TYPE(call) != FUNCF_EXIT)
+			continue;
+		if (time_us || last_ts)
+			time_us += (ts - last_ts) & FUNCF_TIMESTAMP_MASK;
+		else
+			time_us = ts;
+		last_ts = ts;
+
+		func = find_func_by_offset(call->func);
+		if (!func || !(func->flags & FUNCF_TRACE))
+			continue;
+		printf("%s{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %llu, "
+		       "\"pid\": 1, \"tid\": 1}", first ? "" : ",\n",
+		       func->name,
+		       TRACE_CALL_TYPE(call) == FUNCF_ENTRY ? 'B' : 'E',
+		       time_us);
+		first = 0;
+	}
+	printf("\n]}\n");
+
+	return 0;
+}
+
 static int prof_tool(int argc, char *const argv[],
 		     const char *prof_fname, const char *map_fname,
 		     const char *trace_config_fname)
 {
 	int err = 0;
+	int i;
+
+	/* Only keep the call records if a command needs them in order */
+	for (i = 0; i < argc; i++) {
+		if (!strcmp(argv[i], "dump-ftrace") ||
+		    !strcmp(argv[i], "dump-chrome"))
+			keep_calls = 1;
+	}
 
+	/* The trace config is needed to filter calls as they are read */
 	if (read_map_file(map_fname))
 		return -1;
-	if (prof_fname && read_profile_file(prof_fname))
-		return -1;
 	if (trace_config_fname && read_trace_config_file(trace_config_fname))
 		return -1;
-
 	check_functions();
 
+	if (prof_fname && read_profile_file(prof_fname))
+		return -1;
+
+	/* Finish any calls which had not returned when the trace stopped */
+	while (call_depth)
+		pop_call();
+
 	for (; argc; argc--, argv++) {
 		const char *cmd = *argv;
 
 		if (0 == strcmp(cmd, "dump-ftrace"))
 			err = make_ftrace();
+		else if (0 == strcmp(cmd, "dump-chrome"))
+			err = make_chrome();
+		else if (0 == strcmp(cmd, "dump-stacks"))
+			err = make_stacks();
+		else if (0 == strcmp(cmd, "dump-summary"))
+			err = make_summary();
 		else
 			warn("Unknown command '%s'\n", cmd);
 	}
@@ -567,12 +1002,16 @@ int main(int argc, char *argv[])
 	int opt;
 
 	verbose = 2;
-	while ((opt = getopt(argc, argv, "m:p:t:v:")) != -1) {
+	while ((opt = getopt(argc, argv, "m:n:p:t:v:")) != -1) {
 		switch (opt) {
 		case 'm':
 			map_fname = optarg;
 			break;
 
+		case 'n':
+			summary_limit = atoi(optarg);
+			break;
+
 		case 'p':
 			prof_fname = optarg;
 			break;
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-2.0+
+
+"""
+Convert a BMP file into a raw frame-buffer image for CONFIG_VIDEO_RAW_IMAGE.
+
+The output holds the pixels in the format used by the display, so U-Boot can
+copy it straight into the frame buffer. See struct video_raw_header in
+include/video.h for the layout.
+"""
+
+import argparse
+import struct
+
+VIDEO_RAW_MAGIC = 0x57524255
+
+# enum video_log2_bpp
+VIDEO_BPP16 = 4
+VIDEO_BPP32 = 5
+
+# enum video_format
+VIDEO_X8B8G8R8 = 1
+VIDEO_X8R8G8B8 = 2
+
+# enum video_raw_comp
+VIDEO_RAW_COMP_NONE = 0
+VIDEO_RAW_COMP_LZ4 = 1
+
+FORMATS = {
+    'rgb565': (VIDEO_BPP16, 0),
+    'xrgb8888': (VIDEO_BPP32, VIDEO_X8R8G8B8),
+    'xbgr8888': (VIDEO_BPP32, VIDEO_X8B8G8R8),
+}
+
+def parse_args():
+    """Parse command line arguments."""
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('input', type=str, help='input BMP file')
+    parser.add_argument('output', type=str, help='output raw image')
+    parser.add_argument('-f', '--format', choices=FORMATS.keys(),
+        default='xrgb8888', help='pixel format of the display')
+    parser.add_argument('-z', '--lz4', action='store_true',
+        help='compress the image with LZ4 (needs the python lz4 module)')
+
+    return parser.parse_args()
+
+def read_bmp(fname):
+    """Read an uncompressed 8, 24 or 32bpp BMP file.
+
+    Returns:
+        tuple: width, height, list of rows (top first) of (r, g, b) tuples
+    """
+    with open(fname, 'rb') as inf:
+        data = inf.read()
+    if data[:2] != b'BM':
+        raise ValueError('%s is not a BMP file' % fname)
+    offset, hdr_size = struct.unpack_from('<II', data, 10)
+    width, height, _, bpp, comp = struct.unpack_from('<iiHHI', data, 18)
+    if comp not in (0, 3) or bpp not in (8, 24, 32):
+        raise ValueError('Unsupported BMP: %d bpp, compression %d' %
+                         (bpp, comp))
+    palette = data[14 + hdr_size:offset]
+    stride = (width * bpp // 8 + 3) & ~3
+    top_down = height < 0
+    height = abs(height)
+
+    rows = []
+    for y in range(height):
+        pos = offset + y * stride
+        row = []
+        for x in range(width):
+            if bpp == 8:
+                idx = data[pos + x] * 4
+                b, g, r = palette[idx:idx + 3]
+            else:
+                b, g, r = data[pos + x * bpp // 8:pos + x * bpp // 8 + 3]
+            row.append((r, g, b))
+        rows.append(row)
+    if not top_down:
+        rows.reverse()
+
+    return width, height, rows
+
+def convert(rows, fmt):
+    """Convert rows of pixels into frame-buffer data
+
+    Returns:
+        bytes: pixel data, top line first
+    """
+    out = bytearray()
+    for row in rows:
+        for r, g, b in row:
+            if fmt == 'rgb565':
+                out += struct.pack('<H', (r >> 3) << 11 | (g >> 2) << 5 |
+                                   b >> 3)
+            elif fmt == 'xrgb8888':
+                out += bytes((b, g, r, 0))
+            else:
+                out += bytes((r, g, b, 0))
+
+    return bytes(out)
+
+def main():
+    """Convert the file"""
+    args = parse_args()
+    width, height, rows = read_bmp(args.input)
+    bpix, fmt = FORMATS[args.format]
+    data = convert(rows, args.format)
+    comp = VIDEO_RAW_COMP_NONE
+    if args.lz4:
+        import lz4.frame
+
+        data = lz4.frame.compress(data, block_linked=False,
+                                  content_checksum=False)
+        comp = VIDEO_RAW_COMP_LZ4
+
+    hdr = struct.pack('<IHHBBBBI', VIDEO_RAW_MAGIC, width, height, bpix, fmt,
+                      comp, 0, len(data))
+    with open(args.output, 'wb') as outf:
+        outf.write(hdr + data)
+
+if __name__ == '__main__':
+    main()